@@ -0,0 +1,464 @@
+#ifndef CLIST_HPP__
+#define CLIST_HPP__
+#pragma once
+/*
+	clist::list<T, BlockSize, GrowthRate, InlineCapacity>
+
+	      clist::list<std::string> names;
+	      clist::list<int, 64, 2, 8> small;
+
+	the class template counterpart to clist_type.h - no CLIST_TYPE/CLIST_NAME
+	instantiation per element type, and the block size, growth rate and inline
+	capacity are template parameters rather than include-time macros. the
+	growth policy, block math and heap hooks are the same ones the C API
+	uses (see clist_core.h), so both grow and allocate identically.
+
+	NOTE: InlineCapacity elements live inside the list itself before it
+	      allocates (BlockSize by default, may be 0), exactly like
+	      CLIST_INLINE_CAPACITY.
+
+	NOTE: trivially copyable types are memcpy()'d and realloc()'d around;
+	      everything else is moved element by element.
+
+	NOTE: clist.h defines a plain `clist` type for the void* list, which
+	      clashes with this header's `clist` namespace - don't include both
+	      in the same file.
+*/
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "./clist_core.h"
+
+namespace clist {
+
+template <typename T, size_t BlockSize = 512, size_t GrowthRate = 4, size_t InlineCapacity = BlockSize>
+class list {
+	static_assert(BlockSize > 0, "clist::list needs a block size of at least 1");
+	static_assert(GrowthRate > 1, "clist::list needs a growth rate of at least 2");
+
+public:
+	typedef T type;
+	typedef T value_type;
+	typedef T *iterator;
+	typedef const T *const_iterator;
+
+	list() noexcept
+		: count_(0)
+		, capacity_(InlineCapacity)
+		, block_(stack()) {
+	}
+
+	explicit list(size_t n_elems) noexcept : list() {
+		int res = resize(n_elems);
+		(void) res;
+		CLIST_ASSERT(res == 0);
+	}
+
+	list(list &&other) noexcept : list() {
+		steal(other);
+	}
+
+	list(const list &) = delete;
+	list &operator=(const list &) = delete;
+
+	~list() noexcept {
+		clear();
+		release();
+	}
+
+	list &operator=(list &&other) noexcept {
+		if (this != &other) {
+			clear();
+			release();
+			steal(other);
+		}
+
+		return *this;
+	}
+
+	size_t count() const noexcept {
+		return count_;
+	}
+
+	bool empty() const noexcept {
+		return count_ == 0;
+	}
+
+	size_t capacity() const noexcept {
+		return capacity_;
+	}
+
+	/* makes room for at least `n_elems` elements using exactly as many blocks as needed */
+	int reserve(size_t n_elems) noexcept {
+		size_t new_capacity;
+
+		if (n_elems <= capacity_) {
+			return 0;
+		}
+
+		if (CLIST_UNLIKELY(clist__capacity_for(n_elems, sizeof(T), BlockSize, &new_capacity) != 0)) {
+			return 1;
+		}
+
+		return set_capacity(new_capacity);
+	}
+
+	/* new elements are value-initialized */
+	int resize(size_t n_elems) {
+		if (CLIST_UNLIKELY(n_elems > CLIST_MAX_INDEX)) {
+			errno = EOVERFLOW;
+			return 1;
+		}
+
+		if (n_elems <= count_) {
+			destroy(n_elems, count_);
+			count_ = n_elems;
+			return 0;
+		}
+
+		if (CLIST_UNLIKELY(grow(n_elems) != 0)) {
+			return 1;
+		}
+
+		for (size_t i = count_; i < n_elems; i++) {
+			new (&block_[i]) T();
+		}
+
+		count_ = n_elems;
+		return 0;
+	}
+
+	/* gives back any blocks that aren't needed, moving the elements
+	   back into the list itself if they fit there */
+	int shrink() noexcept {
+		size_t new_capacity;
+
+		if (!on_heap()) {
+			return 0;
+		}
+
+		if (count_ <= InlineCapacity) {
+			return set_capacity(InlineCapacity);
+		}
+
+		if (CLIST_UNLIKELY(clist__capacity_for(count_, sizeof(T), BlockSize, &new_capacity) != 0)) {
+			return 1;
+		}
+
+		if (new_capacity >= capacity_) {
+			return 0;
+		}
+
+		return set_capacity(new_capacity);
+	}
+
+	T &get(size_t index) noexcept {
+		CLIST_ASSERT(index < count_);
+		return block_[index];
+	}
+
+	const T &get(size_t index) const noexcept {
+		CLIST_ASSERT(index < count_);
+		return block_[index];
+	}
+
+	T &operator[](size_t index) noexcept {
+		return get(index);
+	}
+
+	const T &operator[](size_t index) const noexcept {
+		return get(index);
+	}
+
+	T &back() noexcept {
+		return get(count_ - 1);
+	}
+
+	const T &back() const noexcept {
+		return get(count_ - 1);
+	}
+
+	size_t add(const T &val) {
+		return emplace(val);
+	}
+
+	size_t add(T &&val) {
+		return emplace(std::move(val));
+	}
+
+	/* constructs the new element right in its slot */
+	template <typename... Args>
+	size_t emplace(Args &&...args) {
+		size_t idx = count_;
+
+		if (CLIST_UNLIKELY(idx == capacity_)) {
+			/* the arguments might refer to elements that are about to move */
+			T tmp(std::forward<Args>(args)...);
+
+			if (CLIST_UNLIKELY(make_room(idx + 1) != 0)) {
+				return CLIST_ERR;
+			}
+
+			new (&block_[idx]) T(std::move(tmp));
+		} else {
+			new (&block_[idx]) T(std::forward<Args>(args)...);
+		}
+
+		count_ = idx + 1;
+		return idx;
+	}
+
+	/* copies `n_elems` elements onto the end, growing at most once; `vals`
+	   must not point into the list itself */
+	size_t add_n(const T *vals, size_t n_elems) {
+		size_t idx = count_;
+
+		CLIST_ASSERT(vals != NULL || n_elems == 0);
+
+		if (CLIST_UNLIKELY(n_elems > CLIST_MAX_INDEX - idx)) {
+			errno = EOVERFLOW;
+			return CLIST_ERR;
+		}
+
+		if (CLIST_UNLIKELY(grow(idx + n_elems) != 0)) {
+			return CLIST_ERR;
+		}
+
+		if (std::is_trivially_copyable<T>::value) {
+			memcpy((void *) &block_[idx], (const void *) vals, n_elems * sizeof(T));
+		} else {
+			for (size_t i = 0; i < n_elems; i++) {
+				new (&block_[idx + i]) T(vals[i]);
+			}
+		}
+
+		count_ = idx + n_elems;
+		return idx;
+	}
+
+	/* `index` may be equal to the count */
+	size_t insert(size_t index, const T &val) {
+		CLIST_ASSERT(index <= count_);
+
+		/* take a copy first - `val` might live in the list itself */
+		T tmp(val);
+
+		if (CLIST_UNLIKELY(make_room(count_ + 1) != 0)) {
+			return CLIST_ERR;
+		}
+
+		if (index < count_) {
+			relocate(&block_[index + 1], &block_[index], count_ - index);
+		}
+
+		new (&block_[index]) T(std::move(tmp));
+		++count_;
+		return index;
+	}
+
+	T pop() {
+		CLIST_ASSERT(count_ > 0);
+
+		T val(std::move(block_[--count_]));
+		block_[count_].~T();
+		return val;
+	}
+
+	void remove(size_t index) {
+		CLIST_ASSERT(index < count_);
+
+		block_[index].~T();
+		if (index < --count_) {
+			relocate(&block_[index], &block_[index + 1], count_ - index);
+		}
+	}
+
+	/* O(1), but does not preserve the order of the list */
+	void swap_remove(size_t index) {
+		CLIST_ASSERT(index < count_);
+
+		block_[index].~T();
+		if (CLIST_LIKELY(index != --count_)) {
+			relocate(&block_[index], &block_[count_], 1);
+		}
+	}
+
+	void clear() noexcept {
+		destroy(0, count_);
+		count_ = 0;
+	}
+
+	void swap(list &other) noexcept {
+		list tmp(std::move(other));
+		other = std::move(*this);
+		*this = std::move(tmp);
+	}
+
+	T *data() noexcept {
+		return block_;
+	}
+
+	const T *data() const noexcept {
+		return block_;
+	}
+
+	iterator begin() noexcept {
+		return block_;
+	}
+
+	iterator end() noexcept {
+		return block_ + count_;
+	}
+
+	const_iterator begin() const noexcept {
+		return block_;
+	}
+
+	const_iterator end() const noexcept {
+		return block_ + count_;
+	}
+
+	const_iterator cbegin() const noexcept {
+		return begin();
+	}
+
+	const_iterator cend() const noexcept {
+		return end();
+	}
+
+private:
+	static constexpr bool bitwise = std::is_trivially_copyable<T>::value;
+
+	/* a zero-length array isn't allowed, hence the extra element */
+	typename std::aligned_storage<sizeof(T), alignof(T)>::type stack_block_[InlineCapacity > 0 ? InlineCapacity : 1];
+
+	size_t count_;
+	size_t capacity_;
+	T *block_;
+
+	T *stack() noexcept {
+		return InlineCapacity > 0 ? reinterpret_cast<T *>(&stack_block_[0]) : nullptr;
+	}
+
+	bool on_heap() noexcept {
+		return block_ != stack();
+	}
+
+	static void relocate(T *dest, T *src, size_t n_elems) noexcept {
+		clist__relocate(dest, src, n_elems, bitwise);
+	}
+
+	void destroy(size_t from, size_t to) noexcept {
+		if (!std::is_trivially_destructible<T>::value) {
+			for (size_t i = from; i < to; i++) {
+				block_[i].~T();
+			}
+		}
+	}
+
+	void release() noexcept {
+		if (on_heap()) {
+			clist__free(block_);
+		}
+
+		capacity_ = InlineCapacity;
+		block_ = stack();
+	}
+
+	/* takes over `other`'s elements; this list must be empty and on the stack */
+	void steal(list &other) noexcept {
+		if (other.on_heap()) {
+			block_ = other.block_;
+			capacity_ = other.capacity_;
+		} else if (InlineCapacity > 0) {
+			relocate(block_, other.block_, other.count_);
+		}
+
+		count_ = other.count_;
+		other.count_ = 0;
+		other.capacity_ = InlineCapacity;
+		other.block_ = other.stack();
+	}
+
+	int make_room(size_t n_elems) noexcept {
+		if (CLIST_UNLIKELY(count_ >= CLIST_MAX_INDEX)) {
+			errno = EOVERFLOW;
+			return 1;
+		}
+
+		return grow(n_elems);
+	}
+
+	int grow(size_t n_elems) noexcept {
+		size_t new_capacity;
+
+		if (CLIST_LIKELY(n_elems <= capacity_)) {
+			return 0;
+		}
+
+		if (CLIST_UNLIKELY(clist__grow_capacity(capacity_, n_elems, sizeof(T), BlockSize, GrowthRate, &new_capacity) != 0)) {
+			return 1;
+		}
+
+		return set_capacity(new_capacity);
+	}
+
+	/* moves the elements into a heap block of exactly `new_capacity`
+	   elements, or back into the list itself if they fit there */
+	int set_capacity(size_t new_capacity) noexcept {
+		CLIST_ASSERT(count_ <= new_capacity);
+
+		if (new_capacity <= InlineCapacity) {
+			if (on_heap()) {
+				T *heap = block_;
+				if (InlineCapacity > 0) {
+					relocate(stack(), heap, count_);
+				}
+				clist__free(heap);
+				block_ = stack();
+			}
+
+			capacity_ = InlineCapacity;
+			return 0;
+		}
+
+		/* realloc() only keeps malloc()'s alignment, so over-aligned
+		   types are always moved into a new block */
+		if (bitwise && alignof(T) <= CLIST_MALLOC_ALIGNMENT && on_heap()) {
+			void *heap = block_;
+
+			if (CLIST_UNLIKELY(!clist__realloc(&heap, new_capacity * sizeof(T)))) {
+				/* errno already set */
+				return 1;
+			}
+
+			block_ = static_cast<T *>(heap);
+		} else {
+			T *heap = static_cast<T *>(clist__alloc_aligned(new_capacity * sizeof(T), alignof(T)));
+
+			if (CLIST_UNLIKELY(heap == nullptr)) {
+				/* errno already set */
+				return 1;
+			}
+
+			if (on_heap()) {
+				relocate(heap, block_, count_);
+				clist__free(block_);
+			} else if (InlineCapacity > 0) {
+				relocate(heap, block_, count_);
+			}
+
+			block_ = heap;
+		}
+
+		capacity_ = new_capacity;
+		return 0;
+	}
+};
+
+}
+
+#endif
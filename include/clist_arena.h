@@ -0,0 +1,232 @@
+#ifndef CLIST_ARENA_H__
+#define CLIST_ARENA_H__
+/*
+	Arenas - included by clist_type.h when CLIST_ARENA is defined;
+	include clist_type.h rather than this file.
+
+	      clist_arena A;
+	      clist_arena_init(&A, 64 * 1024);
+
+	      #define CLIST_ARENA
+	      #define CLIST_TYPE int
+	      #define CLIST_NAME int
+	      #include "clist_type.h"
+
+	      clist_int L;
+	      clist_int_init_arena(&L, &A);
+	      ... as many lists as needed ...
+
+	      clist_arena_reset(&A); // every list bound to A is gone
+	      clist_arena_free(&A);
+
+	An arena hands out memory from big chunks by bumping an offset.
+	The most recent allocation can grow (and shrink) in place, which is
+	what a list that is being filled up usually is. Freeing anything
+	but the most recent allocation is a no-op; the memory comes back
+	all at once with clist_arena_reset(), which is O(1) and keeps the
+	chunks around for the next round.
+
+	Lists bound to an arena must not be used after the arena has been
+	reset - init them again instead. Calling clist_free() on them is
+	optional.
+
+	Allocations are aligned to CLIST_ARENA_ALIGNMENT, or to the list's
+	CLIST_ALIGNMENT where that is larger.
+*/
+
+#include <errno.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef CLIST_ARENA_ALIGNMENT
+#	define CLIST_ARENA_ALIGNMENT 16
+#endif
+
+#define CLIST_ARENA_ROUND(size) \
+	((((size) + CLIST_ARENA_ALIGNMENT - 1) / CLIST_ARENA_ALIGNMENT) * CLIST_ARENA_ALIGNMENT)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct clist_arena_chunk {
+	struct clist_arena_chunk *next;
+	size_t size; /* usable bytes after the (rounded) header */
+} clist_arena_chunk;
+
+#define CLIST_ARENA_CHUNK_DATA(chunk) \
+	((char *) (chunk) + CLIST_ARENA_ROUND(sizeof(clist_arena_chunk)))
+
+typedef struct clist_arena {
+	size_t chunk_size;
+	clist_arena_chunk *head;
+	clist_arena_chunk *current;
+	size_t offset; /* bump offset into `current` */
+	char *last; /* most recent allocation */
+} clist_arena;
+
+CLIST_HELPER void clist_arena_init(clist_arena *arena, size_t chunk_size) {
+	CLIST_ASSERT(arena != NULL);
+	arena->chunk_size = chunk_size;
+	arena->head = NULL;
+	arena->current = NULL;
+	arena->offset = 0;
+	arena->last = NULL;
+}
+
+CLIST_HELPER void clist_arena_free(clist_arena *arena) {
+	clist_arena_chunk *chunk;
+
+	CLIST_ASSERT(arena != NULL);
+
+	chunk = arena->head;
+	while (chunk != NULL) {
+		clist_arena_chunk *next = chunk->next;
+		free(chunk);
+		chunk = next;
+	}
+
+	clist_arena_init(arena, arena->chunk_size);
+}
+
+/* gives back everything that was allocated in one go; the chunks are kept */
+CLIST_HELPER void clist_arena_reset(clist_arena *arena) {
+	CLIST_ASSERT(arena != NULL);
+	arena->current = arena->head;
+	arena->offset = 0;
+	arena->last = NULL;
+}
+
+/* how far `offset` into `chunk` is from the next multiple of `alignment` */
+CLIST_HELPER size_t clist__arena_pad(clist_arena_chunk *chunk, size_t offset, size_t alignment) {
+	size_t misalign = (size_t) (CLIST_ARENA_CHUNK_DATA(chunk) + offset) % alignment;
+	return misalign == 0 ? 0 : alignment - misalign;
+}
+
+/* `alignment` is a power of two; anything below CLIST_ARENA_ALIGNMENT
+   gets CLIST_ARENA_ALIGNMENT */
+CLIST_HELPER void *clist_arena_alloc_aligned(clist_arena *arena, size_t size, size_t alignment) {
+	clist_arena_chunk *chunk;
+	size_t need;
+	size_t pad = 0;
+
+	CLIST_ASSERT(arena != NULL);
+	CLIST_ASSERT(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+	if (CLIST_UNLIKELY(size > CLIST_MAX_INDEX / 2 || alignment > CLIST_MAX_INDEX / 4)) {
+		errno = ENOMEM;
+		return NULL;
+	}
+
+	if (alignment < CLIST_ARENA_ALIGNMENT) {
+		alignment = CLIST_ARENA_ALIGNMENT;
+	}
+
+	need = CLIST_ARENA_ROUND(size);
+
+	chunk = arena->current;
+	if (chunk != NULL) {
+		pad = clist__arena_pad(chunk, arena->offset, alignment);
+	}
+
+	if (CLIST_UNLIKELY(chunk == NULL || chunk->size - arena->offset < need || chunk->size - arena->offset - need < pad)) {
+		/* move on to a chunk left over from before the last reset,
+		   or put a new one right after the current one */
+		clist_arena_chunk *next = chunk != NULL ? chunk->next : arena->head;
+
+		if (next != NULL) {
+			pad = clist__arena_pad(next, 0, alignment);
+		}
+
+		if (next == NULL || next->size < need || next->size - need < pad) {
+			/* room for the worst case padding, too */
+			size_t chunk_size = need + alignment - CLIST_ARENA_ALIGNMENT;
+			if (chunk_size < arena->chunk_size) {
+				chunk_size = arena->chunk_size;
+			}
+
+			next = (clist_arena_chunk *) malloc(CLIST_ARENA_ROUND(sizeof(clist_arena_chunk)) + chunk_size);
+			if (CLIST_UNLIKELY(next == NULL)) {
+				errno = ENOMEM;
+				return NULL;
+			}
+
+			next->size = chunk_size;
+
+			if (chunk == NULL) {
+				next->next = arena->head;
+				arena->head = next;
+			} else {
+				next->next = chunk->next;
+				chunk->next = next;
+			}
+
+			pad = clist__arena_pad(next, 0, alignment);
+		}
+
+		arena->current = chunk = next;
+		arena->offset = 0;
+	}
+
+	arena->last = CLIST_ARENA_CHUNK_DATA(chunk) + arena->offset + pad;
+	arena->offset += pad + need;
+	return arena->last;
+}
+
+CLIST_HELPER void *clist_arena_alloc(clist_arena *arena, size_t size) {
+	return clist_arena_alloc_aligned(arena, size, CLIST_ARENA_ALIGNMENT);
+}
+
+/* resizes `*ptr` (of `old_size` bytes), in place if it was the most
+   recent allocation and still fits, and otherwise to a new allocation
+   aligned to `alignment`. returns non-zero on failure. */
+CLIST_HELPER int clist_arena_realloc_aligned(clist_arena *arena, void **ptr, size_t old_size, size_t size, size_t alignment) {
+	void *moved;
+
+	CLIST_ASSERT(arena != NULL);
+	CLIST_ASSERT(ptr != NULL);
+
+	if ((char *) *ptr == arena->last) {
+		size_t start = (size_t) (arena->last - CLIST_ARENA_CHUNK_DATA(arena->current));
+
+		if (size <= arena->current->size - start) {
+			arena->offset = start + CLIST_ARENA_ROUND(size);
+			return 0;
+		}
+	}
+
+	if (size <= old_size) {
+		return 0;
+	}
+
+	moved = clist_arena_alloc_aligned(arena, size, alignment);
+	if (CLIST_UNLIKELY(moved == NULL)) {
+		/* errno already set */
+		return 1;
+	}
+
+	memcpy(moved, *ptr, old_size);
+	*ptr = moved;
+	return 0;
+}
+
+CLIST_HELPER int clist_arena_realloc(clist_arena *arena, void **ptr, size_t old_size, size_t size) {
+	return clist_arena_realloc_aligned(arena, ptr, old_size, size, CLIST_ARENA_ALIGNMENT);
+}
+
+/* only the most recent allocation is actually handed back */
+CLIST_HELPER void clist_arena_release(clist_arena *arena, void *ptr) {
+	CLIST_ASSERT(arena != NULL);
+
+	if ((char *) ptr == arena->last) {
+		arena->offset = (size_t) (arena->last - CLIST_ARENA_CHUNK_DATA(arena->current));
+		arena->last = NULL;
+	}
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,242 @@
+/*
+	Concurrent lists - included by clist_type.h when CLIST_CONCURRENT
+	is defined. Do not include this file directly.
+
+	      #define CLIST_CONCURRENT
+	      #define CLIST_TYPE struct event
+	      #define CLIST_NAME event
+	      #include "clist_type.h"
+
+	      clist_event_conc C;
+	      clist_event_conc_init(&C);
+
+	      // any number of threads at once
+	      clist_event_conc_add(&C, ev);
+
+	      // any thread, at any time
+	      size_t n = clist_event_conc_count(&C);
+	      struct event *first = clist_event_conc_get(&C, 0);
+
+	A clist_NAME_conc is an append-only list that many threads can add
+	to at once without a lock. Each add claims its index with an atomic
+	increment and writes the element straight into place. Storage comes
+	in buckets that double in size (CLIST_BLOCK_SIZE elements, then
+	twice that, and so on) and are never moved or reallocated once
+	published; the bucket table has a slot for every power of two, so
+	it never has to grow either.
+
+	An element is committed once its add has returned. clist_NAME_conc_get()
+	returns NULL for an index that isn't committed yet, and
+	clist_NAME_conc_count() returns how many elements from the start are
+	all committed. Both can be called while adds are still going on.
+
+	Every element sits next to a one byte flag that marks it as committed.
+	If an add fails (because a bucket couldn't be allocated) its index
+	never gets committed, and clist_NAME_conc_count() stops there.
+
+	clist_NAME_conc_init() and clist_NAME_conc_free() must not race
+	with anything else.
+*/
+
+#ifndef CLIST_CONCURRENT_H__
+#define CLIST_CONCURRENT_H__
+
+#include <limits.h>
+
+#define CLIST_CONC_BUCKETS (sizeof(size_t) * CHAR_BIT)
+
+#ifndef CLIST_CONC_CACHE_LINE
+#	define CLIST_CONC_CACHE_LINE 64
+#endif
+
+/* floor(log2(n)) for n > 0 */
+CLIST_HELPER size_t clist__conc_log2(size_t n) {
+#ifdef __GNUC__
+	return sizeof(unsigned long) * CHAR_BIT - 1 - (size_t) __builtin_clzl((unsigned long) n);
+#else
+	size_t log = 0;
+	while (n >>= 1) {
+		++log;
+	}
+	return log;
+#endif
+}
+
+/* which bucket `index` lives in, and where; bucket k holds
+   `block_size << k` elements and starts at `block_size * (2^k - 1)` */
+CLIST_HELPER size_t clist__conc_locate(size_t index, size_t block_size, size_t *offset_out) {
+	size_t bucket = clist__conc_log2(index / block_size + 1);
+	*offset_out = index - block_size * (((size_t) 1 << bucket) - 1);
+	return bucket;
+}
+#endif
+
+/* see header comment - DO NOT PRAGMA ONCE OR INCLUDE GUARD! */
+
+typedef struct CLIST(conc) {
+	/* the producers all hammer this one, so it gets a cache line to itself */
+	size_t reserved;
+	char pad_reserved[CLIST_CONC_CACHE_LINE - sizeof(size_t)];
+	size_t committed; /* every index below this is committed */
+	char pad_committed[CLIST_CONC_CACHE_LINE - sizeof(size_t)];
+	CLIST(type) *buckets[CLIST_CONC_BUCKETS];
+} CLIST(conc);
+
+#define CLIST_CONC_FLAGS(bucket, k) ((unsigned char *) ((bucket) + ((size_t) CLIST_BLOCK_SIZE << (k))))
+
+CLIST_API void CLIST(conc_init) (CLIST(conc) *list) {
+	size_t i;
+
+	CLIST_ASSERT(list != NULL);
+
+	list->reserved = 0;
+	list->committed = 0;
+	for (i = 0; i < CLIST_CONC_BUCKETS; i++) {
+		list->buckets[i] = NULL;
+	}
+}
+
+CLIST_API void CLIST(conc_free) (CLIST(conc) *list) {
+	size_t k;
+
+	CLIST_ASSERT(list != NULL);
+
+	for (k = 0; k < CLIST_CONC_BUCKETS; k++) {
+		if (list->buckets[k] == NULL) {
+			continue;
+		}
+
+#ifdef __cplusplus
+		{
+			size_t i;
+			for (i = 0; i < ((size_t) CLIST_BLOCK_SIZE << k); i++) {
+				if (CLIST_CONC_FLAGS(list->buckets[k], k)[i]) {
+					list->buckets[k][i].~CLIST(type)();
+				}
+			}
+		}
+#endif
+
+		CLIST_FREE(list->buckets[k]);
+		list->buckets[k] = NULL;
+	}
+}
+
+/* returns bucket `k`, allocating and publishing it first if nobody has yet */
+CLIST_API CLIST(type) *CLIST(conc_bucket) (CLIST(conc) *list, size_t k) {
+	CLIST(type) *bucket;
+	CLIST(type) *expected = NULL;
+	size_t n_elems;
+
+	CLIST_ASSERT(k < CLIST_CONC_BUCKETS);
+
+	bucket = __atomic_load_n(&list->buckets[k], __ATOMIC_ACQUIRE);
+	if (CLIST_LIKELY(bucket != NULL)) {
+		return bucket;
+	}
+
+	n_elems = (size_t) CLIST_BLOCK_SIZE << k;
+	if (CLIST_UNLIKELY(n_elems >> k != (size_t) CLIST_BLOCK_SIZE || n_elems > CLIST_MAX_INDEX / (sizeof(CLIST(type)) + 1))) {
+		errno = ENOMEM;
+		return NULL;
+	}
+
+	/* zeroed, since that's what clears the committed flags */
+	CLIST_CALLOC((void **) &bucket, n_elems * (sizeof(CLIST(type)) + 1));
+	if (CLIST_UNLIKELY(bucket == NULL)) {
+		/* errno already set */
+		return NULL;
+	}
+
+	/* someone else might have beaten us to it */
+	if (!__atomic_compare_exchange_n(&list->buckets[k], &expected, bucket, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+		CLIST_FREE(bucket);
+		return expected;
+	}
+
+	return bucket;
+}
+
+/* safe to call from any number of threads at once; returns the new
+   element's index, or CLIST_ERR with errno set */
+CLIST_API size_t CLIST(conc_add) (CLIST(conc) *list, const CLIST(type) CLIST_REF val) {
+	size_t idx;
+	size_t k;
+	size_t offset;
+	CLIST(type) *bucket;
+
+	CLIST_ASSERT(list != NULL);
+
+	idx = __atomic_fetch_add(&list->reserved, 1, __ATOMIC_RELAXED);
+	if (CLIST_UNLIKELY(idx >= CLIST_MAX_INDEX)) {
+		errno = EOVERFLOW;
+		return CLIST_ERR;
+	}
+
+	k = clist__conc_locate(idx, CLIST_BLOCK_SIZE, &offset);
+	bucket = CLIST(conc_bucket)(list, k);
+	if (CLIST_UNLIKELY(bucket == NULL)) {
+		return CLIST_ERR;
+	}
+
+	/* whoever starts a bucket sets up the next one, so that the other
+	   producers don't all race to allocate it when they get there */
+	if (CLIST_UNLIKELY(offset == 0) && k + 1 < CLIST_CONC_BUCKETS) {
+		(void) CLIST(conc_bucket)(list, k + 1);
+	}
+
+#ifdef __cplusplus
+	new (&bucket[offset]) CLIST(type)(val);
+#else
+	bucket[offset] = val;
+#endif
+
+	__atomic_store_n(&CLIST_CONC_FLAGS(bucket, k)[offset], 1, __ATOMIC_RELEASE);
+	return idx;
+}
+
+/* returns the element at `index`, or NULL if it isn't committed yet */
+CLIST_API CLIST(type) *CLIST(conc_get) (const CLIST(conc) *list, size_t index) {
+	size_t k;
+	size_t offset;
+	CLIST(type) *bucket;
+
+	CLIST_ASSERT(list != NULL);
+
+	if (index >= __atomic_load_n(&list->reserved, __ATOMIC_RELAXED)) {
+		return NULL;
+	}
+
+	k = clist__conc_locate(index, CLIST_BLOCK_SIZE, &offset);
+	bucket = __atomic_load_n(&list->buckets[k], __ATOMIC_ACQUIRE);
+
+	if (bucket == NULL || !__atomic_load_n(&CLIST_CONC_FLAGS(bucket, k)[offset], __ATOMIC_ACQUIRE)) {
+		return NULL;
+	}
+
+	return &bucket[offset];
+}
+
+/* returns how many elements from the start are committed; everything
+   below that can be read with clist_conc_get() */
+CLIST_API size_t CLIST(conc_count) (CLIST(conc) *list) {
+	size_t start;
+	size_t count;
+
+	CLIST_ASSERT(list != NULL);
+
+	start = __atomic_load_n(&list->committed, __ATOMIC_ACQUIRE);
+	count = start;
+
+	while (CLIST(conc_get)(list, count) != NULL) {
+		++count;
+	}
+
+	/* only ever moves forward, no matter who gets there first */
+	while (count > start && !__atomic_compare_exchange_n(&list->committed, &start, count, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+	}
+
+	return count;
+}
+
+#undef CLIST_CONC_FLAGS
@@ -0,0 +1,282 @@
+#ifndef CLIST_CORE_H__
+#define CLIST_CORE_H__
+#pragma once
+/*
+	the type-independent parts of clist - macros, the default heap hooks
+	and the block/growth math - shared by every clist_type.h instantiation
+	and by the clist::list template (clist.hpp).
+
+	included by both; there's no need to include it yourself.
+*/
+
+#include <assert.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined (__unix__) || (defined (__APPLE__) && defined (__MACH__))
+#	define CLIST_CORE_HAS_UNISTD
+#	include <unistd.h>
+#endif
+#if defined(_WIN32) || defined(_WIN32_)
+#	define CLIST_CORE_HAS_WINDOWS
+#	include <windows.h>
+#endif
+
+#ifdef __cplusplus
+#	include <new>
+#	include <utility>
+extern "C" {
+#endif
+
+	/* the following is copied from rapidstring - thanks to John Boyer <john.boyer@tutanota.com> */
+	/* include-guarded since it only needs to be evaluated once */
+#	ifdef __GNUC__
+#	define CLIST_GCC_VERSION \
+ 	       (__GNUC__ * 10000 + __GNUC_MINOR__ * 100 + __GNUC_PATCHLEVEL__)
+#	else
+#	define CLIST_GCC_VERSION (0)
+#	endif
+
+/* GCC version 2.96 required for branch prediction expectation. */
+#	if CLIST_GCC_VERSION > 29600
+#		define CLIST_EXPECT(expr, val) __builtin_expect((expr), val)
+#	else
+#		define CLIST_EXPECT(expr, val) (expr)
+#	endif
+
+	/* note that `expr` must be either 0 or 1 for this to work - the 1/0 are not
+	   booleans but instead literal integral values.*/
+	/* https://gcc.gnu.org/onlinedocs/gcc/Other-Builtins.html#index-_005f_005fbuiltin_005fexpect */
+#	define CLIST_LIKELY(expr) CLIST_EXPECT((expr), 1)
+#	define CLIST_UNLIKELY(expr) CLIST_EXPECT((expr), 0)
+
+#	ifdef __STDC_VERSION__
+#		define CLIST_C99 (__STDC_VERSION__ >= 199901L)
+#		define CLIST_C11 (__STDC_VERSION__ >= 201112L)
+#	else
+#		define CLIST_C99 (0)
+#		define CLIST_C11 (0)
+#	endif
+
+#	define CLIST_ASSERT_RETURN(cond, ret) do { \
+			if (CLIST_UNLIKELY(!(cond))) return ret; \
+		} while (0)
+
+#	define CLIST_ASSERT(cond) assert(cond) /* don't care about the likelihood here since it's debug-only */
+
+#	define CLIST_ERR ((size_t) -1)
+#	define CLIST_MAX_INDEX ((size_t) -2) /* inclusive */
+
+	/* rounds `size` up to the next multiple of the page size `pgsz` */
+#	define CLIST_PAGE_ROUND(size, pgsz) ((((size) + (pgsz) - 1) / (pgsz)) * (pgsz))
+
+	/* heap blocks of a page or more are rounded up to whole pages (and
+	   page aligned); anything smaller is left to malloc(3) as-is so that
+	   small lists don't each eat a page */
+#	define CLIST_ALLOC_SIZE(size, pgsz) ((size) < (pgsz) ? (size) : CLIST_PAGE_ROUND((size), (pgsz)))
+
+	/* usage: CLIST_ALIGNAS(n) type name; - `n` a power of two */
+#	if defined(__cplusplus) && __cplusplus >= 201103L
+#		define CLIST_ALIGNAS(n) alignas(n)
+#	elif CLIST_C11
+#		define CLIST_ALIGNAS(n) _Alignas(n)
+#	elif defined(__GNUC__)
+#		define CLIST_ALIGNAS(n) __attribute__((aligned(n)))
+#	elif defined(_MSC_VER)
+#		define CLIST_ALIGNAS(n) __declspec(align(n))
+#	else
+#		define CLIST_ALIGNAS(n)
+#	endif
+
+	/* `ptr`, telling the compiler that it is aligned to `n` */
+#	if CLIST_GCC_VERSION >= 40700 || defined(__clang__)
+#		define CLIST_ASSUME_ALIGNED(ptr, n) __builtin_assume_aligned((ptr), (n))
+#	else
+#		define CLIST_ASSUME_ALIGNED(ptr, n) (ptr)
+#	endif
+
+	/* what malloc(3) and realloc(3) are relied on to align to at the
+	   very least */
+#	ifndef CLIST_MALLOC_ALIGNMENT
+#		define CLIST_MALLOC_ALIGNMENT (2 * sizeof(void *))
+#	endif
+
+	/* whether clist__alloc_aligned() can actually align */
+#	if (defined(CLIST_CORE_HAS_UNISTD) && _POSIX_VERSION >= 200112L) || defined(_ISOC11_SOURCE) || CLIST_C11
+#		define CLIST_CORE_HAS_ALIGNED_ALLOC
+#	endif
+
+	/* type-independent helpers that are only defined once */
+#	if CLIST_C99 || defined(__cplusplus)
+#		define CLIST_HELPER static inline
+#	elif defined(__GNUC__)
+#		define CLIST_HELPER static __inline__
+#	elif defined(_MSC_VER)
+#		define CLIST_HELPER static __inline
+#	else
+#		define CLIST_HELPER static
+#	endif
+
+#	ifndef CLIST_PAGE_SIZE
+#		if defined(CLIST_CORE_HAS_UNISTD) && _POSIX_VERSION >= 200112L
+#			define CLIST_PAGE_SIZE(_ptr) do { \
+					*(_ptr) = sysconf(_SC_PAGESIZE); \
+				} while (0)
+#		elif defined(CLIST_CORE_HAS_WINDOWS)
+#			define CLIST_PAGE_SIZE(_ptr) do { \
+					SYSTEM_INFO __cl_psz_sysInfo; \
+					GetSystemInfo(&__cl_psz_sysInfo); \
+					*(_ptr) = __cl_psz_sysInfo.dwPageSize; \
+				} while (0)
+#		else
+#			define CLIST_PAGE_SIZE(_ptr) do { \
+					/* sane default :P */ \
+					*(_ptr) = 4096; \
+				} while (0)
+#		endif
+#	endif
+
+/* rounds `n_elems` up to whole blocks of `block_size` elements; returns
+   non-zero (and sets errno) if that would be too large */
+CLIST_HELPER int clist__capacity_for(size_t n_elems, size_t elem_size, size_t block_size, size_t *capacity_out) {
+	size_t blocks = n_elems / block_size + (n_elems % block_size != 0);
+
+	if (CLIST_UNLIKELY(blocks > CLIST_MAX_INDEX / (block_size * elem_size))) {
+		errno = ENOMEM;
+		return 1;
+	}
+
+	*capacity_out = blocks * block_size;
+	return 0;
+}
+
+/* works out how far a list of `capacity` elements has to grow to hold
+   `n_elems`, multiplying by `rate` (and starting at one block) until it
+   fits. the result is whole blocks. */
+CLIST_HELPER int clist__grow_capacity(size_t capacity, size_t n_elems, size_t elem_size, size_t block_size, size_t rate, size_t *capacity_out) {
+	size_t new_capacity = capacity;
+
+	/* work out the final size up front so that we only ever hit
+	   the allocator once, no matter how many elements are coming */
+	do {
+		if (CLIST_UNLIKELY(new_capacity > (CLIST_MAX_INDEX / elem_size) / rate)) {
+			errno = ENOMEM;
+			return 1;
+		}
+
+		new_capacity *= rate;
+		if (new_capacity < block_size) {
+			new_capacity = block_size;
+		}
+	} while (new_capacity < n_elems);
+
+	return clist__capacity_for(new_capacity, elem_size, block_size, capacity_out);
+}
+
+/*
+	the default heap hooks. blocks of a page or more are rounded up to whole
+	pages and page aligned; anything smaller is left to malloc(3) as-is so
+	that small lists don't each eat a page.
+*/
+
+/* clist__alloc(), aligned to at least `alignment` (a power of two) where
+   posix_memalign(3) or aligned_alloc(3) are there to do it */
+CLIST_HELPER void *clist__alloc_aligned(size_t size, size_t alignment) {
+	size_t pgsz;
+	void *ptr;
+
+	CLIST_PAGE_SIZE(&pgsz);
+	size = CLIST_ALLOC_SIZE(size, pgsz);
+	if (size >= pgsz && alignment < pgsz) {
+		alignment = pgsz;
+	}
+
+#if defined(CLIST_CORE_HAS_UNISTD) && _POSIX_VERSION >= 200112L
+	{
+		int res = posix_memalign(&ptr, alignment < sizeof(void *) ? sizeof(void *) : alignment, size);
+		if (CLIST_UNLIKELY(res != 0)) {
+			ptr = NULL;
+			errno = res;
+		}
+	}
+#elif defined(_ISOC11_SOURCE) || CLIST_C11
+	/* yes, if you're using this library with -std=c11 on a non-posix system, you
+	   get a bit of an optimization with memory aligned data */
+	ptr = alignment <= sizeof(void *) ? malloc(size) : aligned_alloc(alignment, CLIST_PAGE_ROUND(size, alignment));
+#else
+	/* not much else we can do */
+	ptr = malloc(size);
+#endif
+
+	return ptr;
+}
+
+CLIST_HELPER void *clist__alloc(size_t size) {
+	return clist__alloc_aligned(size, sizeof(void *));
+}
+
+/* same rounding as clist__alloc(), without the alignment */
+CLIST_HELPER void *clist__alloc_unaligned(size_t size) {
+	size_t pgsz;
+
+	CLIST_PAGE_SIZE(&pgsz);
+	return malloc(CLIST_ALLOC_SIZE(size, pgsz));
+}
+
+/* large zeroed blocks come straight from the OS this way */
+CLIST_HELPER void *clist__calloc(size_t size) {
+	size_t pgsz;
+
+	CLIST_PAGE_SIZE(&pgsz);
+	return calloc(1, CLIST_ALLOC_SIZE(size, pgsz));
+}
+
+/* no standardized aligned reallocs, unfortunately :/
+   returns 1 on success, leaving `*ptr` untouched otherwise */
+CLIST_HELPER int clist__realloc(void **ptr, size_t size) {
+	size_t pgsz;
+	void *new_ptr;
+
+	CLIST_PAGE_SIZE(&pgsz);
+	new_ptr = realloc(*ptr, CLIST_ALLOC_SIZE(size, pgsz));
+	if (CLIST_UNLIKELY(new_ptr == NULL)) {
+		return 0;
+	}
+
+	*ptr = new_ptr;
+	return 1;
+}
+
+CLIST_HELPER void clist__free(void *ptr) {
+	free(ptr);
+}
+
+#ifdef __cplusplus
+}
+
+/* moves `n_elems` elements from `src` over to `dest`, ending the lifetime
+   of the originals. the ranges may overlap. `bitwise` types are simply
+   memmove()'d. */
+template <typename T>
+static inline void clist__relocate(T *dest, T *src, size_t n_elems, bool bitwise) {
+	size_t i;
+
+	if (bitwise) {
+		memmove((void *) dest, (const void *) src, n_elems * sizeof(T));
+	} else if (dest < src) {
+		for (i = 0; i < n_elems; i++) {
+			new (&dest[i]) T(std::move(src[i]));
+			src[i].~T();
+		}
+	} else if (dest > src) {
+		for (i = n_elems; i-- > 0;) {
+			new (&dest[i]) T(std::move(src[i]));
+			src[i].~T();
+		}
+	}
+}
+#endif
+
+#endif
@@ -0,0 +1,153 @@
+#ifndef CLIST_EPOCH_H__
+#define CLIST_EPOCH_H__
+#pragma once
+/*
+	Epochs - included by clist_type.h when CLIST_SWMR is defined;
+	include clist_type.h rather than this file.
+
+	      clist_epoch E;
+	      clist_epoch_init(&E);
+
+	      // each reader thread, once
+	      clist_epoch_reader *r = clist_epoch_register(&E);
+
+	      clist_epoch_enter(r);
+	      ... read ...
+	      clist_epoch_leave(r);
+
+	      clist_epoch_unregister(r);
+
+	Epoch based reclamation, for memory that a writer unlinks while
+	readers might still be looking at it. Readers mark the stretch in
+	which they hold pointers with enter()/leave(), which each cost one
+	store (plus a fence on entering) and never wait on anything. The
+	writer tags whatever it unlinks with clist_epoch_retire() and frees
+	it once clist_epoch_safe() says that every reader that could have
+	seen it has left.
+
+	A reader that stays inside enter()/leave() for a long time holds up
+	reclamation for everything retired in the meantime, so keep read
+	sections short. There are CLIST_EPOCH_MAX_READERS reader slots per
+	clist_epoch.
+*/
+
+#include <errno.h>
+#include <stddef.h>
+
+#include "./clist_core.h"
+
+#ifndef CLIST_EPOCH_MAX_READERS
+#	define CLIST_EPOCH_MAX_READERS 64
+#endif
+
+#ifndef CLIST_EPOCH_CACHE_LINE
+#	define CLIST_EPOCH_CACHE_LINE 64
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct clist_epoch;
+
+typedef struct clist_epoch_reader {
+	struct clist_epoch *domain;
+	size_t epoch; /* the epoch it entered in, or 0 outside of a read */
+	int in_use;
+	/* every reader writes to its own cache line */
+	char pad[CLIST_EPOCH_CACHE_LINE - sizeof(void *) - sizeof(size_t) - sizeof(int)];
+} clist_epoch_reader;
+
+typedef struct clist_epoch {
+	size_t epoch;
+	char pad[CLIST_EPOCH_CACHE_LINE - sizeof(size_t)];
+	clist_epoch_reader readers[CLIST_EPOCH_MAX_READERS];
+} clist_epoch;
+
+CLIST_HELPER void clist_epoch_init(clist_epoch *epoch) {
+	size_t i;
+
+	CLIST_ASSERT(epoch != NULL);
+
+	epoch->epoch = 1;
+	for (i = 0; i < CLIST_EPOCH_MAX_READERS; i++) {
+		epoch->readers[i].domain = epoch;
+		epoch->readers[i].epoch = 0;
+		epoch->readers[i].in_use = 0;
+	}
+}
+
+/* claims a reader slot for the calling thread. returns NULL with errno
+   set to EAGAIN if all of them are taken. */
+CLIST_HELPER clist_epoch_reader *clist_epoch_register(clist_epoch *epoch) {
+	size_t i;
+
+	CLIST_ASSERT(epoch != NULL);
+
+	for (i = 0; i < CLIST_EPOCH_MAX_READERS; i++) {
+		int expected = 0;
+
+		if (__atomic_compare_exchange_n(&epoch->readers[i].in_use, &expected, 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+			return &epoch->readers[i];
+		}
+	}
+
+	errno = EAGAIN;
+	return NULL;
+}
+
+CLIST_HELPER void clist_epoch_unregister(clist_epoch_reader *reader) {
+	CLIST_ASSERT(reader != NULL);
+	CLIST_ASSERT(reader->epoch == 0);
+	__atomic_store_n(&reader->in_use, 0, __ATOMIC_RELEASE);
+}
+
+CLIST_HELPER void clist_epoch_enter(clist_epoch_reader *reader) {
+	CLIST_ASSERT(reader != NULL);
+	CLIST_ASSERT(reader->epoch == 0);
+
+	__atomic_store_n(&reader->epoch, __atomic_load_n(&reader->domain->epoch, __ATOMIC_ACQUIRE), __ATOMIC_RELAXED);
+
+	/* the writer has to see that we're here before we read anything
+	   it might retire; pairs with the fence in clist_epoch_safe() */
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+CLIST_HELPER void clist_epoch_leave(clist_epoch_reader *reader) {
+	CLIST_ASSERT(reader != NULL);
+	CLIST_ASSERT(reader->epoch != 0);
+	__atomic_store_n(&reader->epoch, 0, __ATOMIC_RELEASE);
+}
+
+/* call after unlinking something; returns the tag to pass to
+   clist_epoch_safe() later on */
+CLIST_HELPER size_t clist_epoch_retire(clist_epoch *epoch) {
+	CLIST_ASSERT(epoch != NULL);
+	return __atomic_fetch_add(&epoch->epoch, 1, __ATOMIC_SEQ_CST);
+}
+
+/* returns 1 if nothing retired with `tag` can still be in use */
+CLIST_HELPER int clist_epoch_safe(clist_epoch *epoch, size_t tag) {
+	size_t i;
+
+	CLIST_ASSERT(epoch != NULL);
+
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+	for (i = 0; i < CLIST_EPOCH_MAX_READERS; i++) {
+		size_t entered = __atomic_load_n(&epoch->readers[i].epoch, __ATOMIC_ACQUIRE);
+
+		/* readers that entered after the retire can't have seen it */
+		if (entered != 0 && entered <= tag) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
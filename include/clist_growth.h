@@ -0,0 +1,183 @@
+#ifndef CLIST_GROWTH_H__
+#define CLIST_GROWTH_H__
+/*
+	Growth policies - included by clist_type.h when CLIST_GROWTH is
+	defined; include clist_type.h rather than this file.
+
+	      #define CLIST_GROWTH
+	      #define CLIST_TYPE int
+	      #define CLIST_NAME int
+	      #include "clist_type.h"
+
+	      static const clist_growth half = CLIST_GROWTH_GEOMETRIC_INIT(3, 2);
+
+	      clist_int L;
+	      clist_int_init(&L);
+	      clist_int_set_growth(&L, &half);
+
+	By default a list multiplies its capacity by CLIST_BLOCK_GROWTH_RATE
+	whenever it runs out, which is the same for every list of the type.
+	clist_NAME_set_growth() gives a single list its own policy instead:
+
+	      geometric  - capacity * num / den (e.g. 3/2 or 2/1)
+	      linear     - capacity + step, for lists that grow steadily
+	                   and where memory matters more than copies
+	      capped     - doubles until it would add more than max_step
+	                   elements at once, then goes up by max_step
+	      callback   - fn(ctx, capacity, n_elems) returns the new
+	                   capacity, which has to be at least n_elems (or 0
+	                   with errno set to fail)
+
+	Capacities are rounded up to whole CLIST_BLOCK_SIZE blocks either
+	way. The list only keeps a pointer, so the policy has to outlive
+	every list using it; many lists can share one. Passing NULL goes
+	back to CLIST_BLOCK_GROWTH_RATE. clist_reserve() is unaffected - it
+	always allocates exactly as many blocks as asked for.
+*/
+
+#include <errno.h>
+#include <stddef.h>
+
+#include "./clist_core.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CLIST_GROWTH_KIND_GEOMETRIC 0
+#define CLIST_GROWTH_KIND_LINEAR 1
+#define CLIST_GROWTH_KIND_CAPPED 2
+#define CLIST_GROWTH_KIND_CALLBACK 3
+
+typedef size_t (*clist_growth_fn)(void *ctx, size_t capacity, size_t n_elems);
+
+typedef struct clist_growth {
+	int kind;
+	size_t num; /* geometric */
+	size_t den;
+	size_t step; /* linear, or the largest step for capped */
+	clist_growth_fn fn; /* callback */
+	void *ctx;
+} clist_growth;
+
+/* for static initializers */
+#define CLIST_GROWTH_GEOMETRIC_INIT(num, den) { CLIST_GROWTH_KIND_GEOMETRIC, (num), (den), 0, NULL, NULL }
+#define CLIST_GROWTH_LINEAR_INIT(step) { CLIST_GROWTH_KIND_LINEAR, 1, 1, (step), NULL, NULL }
+#define CLIST_GROWTH_CAPPED_INIT(max_step) { CLIST_GROWTH_KIND_CAPPED, 2, 1, (max_step), NULL, NULL }
+#define CLIST_GROWTH_CALLBACK_INIT(fn, ctx) { CLIST_GROWTH_KIND_CALLBACK, 1, 1, 0, (fn), (ctx) }
+
+CLIST_HELPER clist_growth clist_growth_geometric(size_t num, size_t den) {
+	clist_growth growth = CLIST_GROWTH_GEOMETRIC_INIT(0, 0);
+	CLIST_ASSERT(den > 0 && num > den);
+	growth.num = num;
+	growth.den = den;
+	return growth;
+}
+
+CLIST_HELPER clist_growth clist_growth_linear(size_t step) {
+	clist_growth growth = CLIST_GROWTH_LINEAR_INIT(0);
+	CLIST_ASSERT(step > 0);
+	growth.step = step;
+	return growth;
+}
+
+CLIST_HELPER clist_growth clist_growth_capped(size_t max_step) {
+	clist_growth growth = CLIST_GROWTH_CAPPED_INIT(0);
+	CLIST_ASSERT(max_step > 0);
+	growth.step = max_step;
+	return growth;
+}
+
+CLIST_HELPER clist_growth clist_growth_callback(clist_growth_fn fn, void *ctx) {
+	clist_growth growth = CLIST_GROWTH_CALLBACK_INIT(NULL, NULL);
+	CLIST_ASSERT(fn != NULL);
+	growth.fn = fn;
+	growth.ctx = ctx;
+	return growth;
+}
+
+/* adds whole `step`s to `capacity` until it holds `n_elems` */
+CLIST_HELPER int clist__growth_linear(size_t capacity, size_t n_elems, size_t limit, size_t step, size_t *capacity_out) {
+	size_t steps = (n_elems - capacity + step - 1) / step;
+
+	if (CLIST_UNLIKELY(capacity > limit || steps > (limit - capacity) / step)) {
+		errno = ENOMEM;
+		return 1;
+	}
+
+	*capacity_out = capacity + steps * step;
+	return 0;
+}
+
+/* clist__grow_capacity(), but by `growth` */
+CLIST_HELPER int clist__growth_capacity(const clist_growth *growth, size_t capacity, size_t n_elems, size_t elem_size, size_t block_size, size_t *capacity_out) {
+	size_t limit = CLIST_MAX_INDEX / elem_size;
+	size_t new_capacity = capacity;
+
+	CLIST_ASSERT(growth != NULL);
+	CLIST_ASSERT(n_elems > capacity);
+
+	switch (growth->kind) {
+	case CLIST_GROWTH_KIND_GEOMETRIC:
+		do {
+			size_t next;
+
+			if (CLIST_UNLIKELY(new_capacity > limit / growth->num)) {
+				errno = ENOMEM;
+				return 1;
+			}
+
+			next = new_capacity * growth->num / growth->den;
+			new_capacity = next > new_capacity ? next : new_capacity + 1;
+			if (new_capacity < block_size) {
+				new_capacity = block_size;
+			}
+		} while (new_capacity < n_elems);
+		break;
+
+	case CLIST_GROWTH_KIND_LINEAR:
+		if (CLIST_UNLIKELY(clist__growth_linear(capacity, n_elems, limit, growth->step, &new_capacity) != 0)) {
+			return 1;
+		}
+		break;
+
+	case CLIST_GROWTH_KIND_CAPPED:
+		/* doubling while that's the smaller step */
+		while (new_capacity < n_elems && new_capacity < growth->step) {
+			if (CLIST_UNLIKELY(new_capacity > limit / 2)) {
+				errno = ENOMEM;
+				return 1;
+			}
+
+			new_capacity = new_capacity < block_size ? block_size : new_capacity * 2;
+		}
+
+		if (new_capacity < n_elems && CLIST_UNLIKELY(clist__growth_linear(new_capacity, n_elems, limit, growth->step, &new_capacity) != 0)) {
+			return 1;
+		}
+		break;
+
+	case CLIST_GROWTH_KIND_CALLBACK:
+		new_capacity = growth->fn(growth->ctx, capacity, n_elems);
+		if (CLIST_UNLIKELY(new_capacity < n_elems)) {
+			if (new_capacity != 0) {
+				errno = EINVAL;
+			}
+			return 1;
+		}
+		break;
+
+	default:
+		CLIST_ASSERT(!"unknown growth policy");
+		errno = EINVAL;
+		return 1;
+	}
+
+	return clist__capacity_for(new_capacity, elem_size, block_size, capacity_out);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,347 @@
+#ifndef CLIST_PARALLEL_H__
+#define CLIST_PARALLEL_H__
+/*
+	Parallel loops - included by clist_type.h when CLIST_PARALLEL is
+	defined; include clist_type.h rather than this file.
+
+	      #define CLIST_PARALLEL
+	      #define CLIST_TYPE double
+	      #define CLIST_NAME dbl
+	      #include "clist_type.h"
+
+	      static void scale(double *block, size_t begin, size_t end, void *ctx) {
+	          for (; begin < end; begin++) block[begin] *= *(double *) ctx;
+	      }
+
+	      clist_dbl_parallel_for(&L, &scale, &factor);
+
+	The index range is cut into chunks of whole blocks (CLIST_BLOCK_SIZE
+	elements, or a multiple of it for very long lists so that there are
+	never more than CLIST_PARALLEL_MAX_CHUNKS of them) and handed to a
+	pool of pthreads plus the calling thread. Each thread starts out
+	with an even share of the chunks and steals half of someone else's
+	remaining share once it runs out, so uneven callbacks still keep
+	every thread busy.
+
+	The pool is started on first use with one thread per online CPU
+	(see clist_parallel_threads()) and is shared by every list type
+	in the translation unit. A parallel call made while the pool is
+	already busy - from another thread, or from inside a callback -
+	simply runs on the calling thread.
+
+	Link with -lpthread.
+*/
+
+#include <pthread.h>
+#include <stdint.h>
+
+#include "./clist_core.h"
+
+#ifndef CLIST_PARALLEL_MAX_CHUNKS
+#	define CLIST_PARALLEL_MAX_CHUNKS 4096
+#endif
+
+#ifndef CLIST_PARALLEL_CACHE_LINE
+#	define CLIST_PARALLEL_CACHE_LINE 64
+#endif
+
+	/* a thread's share of the chunks is [lo, hi), packed into one word so
+	   that the owner (taking from the front) and thieves (taking from the
+	   back) can both update it with a single compare-and-swap */
+#define CLIST_PARALLEL_PACK(lo, hi) (((uint64_t) (hi) << 32) | (uint64_t) (lo))
+#define CLIST_PARALLEL_LO(range) ((size_t) ((range) & 0xFFFFFFFFu))
+#define CLIST_PARALLEL_HI(range) ((size_t) ((range) >> 32))
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void (*clist__parallel_fn)(void *task, size_t chunk);
+
+typedef struct clist__parallel_share {
+	uint64_t range;
+	char pad[CLIST_PARALLEL_CACHE_LINE - sizeof(uint64_t)];
+} clist__parallel_share;
+
+typedef struct clist__parallel_pool {
+	pthread_mutex_t lock;
+	pthread_cond_t wake; /* workers wait here for the next job */
+	pthread_cond_t done; /* the caller waits here for the workers */
+	pthread_t *threads;
+	clist__parallel_share *shares; /* one per thread, the caller's first */
+	size_t n_threads; /* including the caller; 0 until decided */
+	size_t n_workers; /* actually running */
+	unsigned long job;
+	unsigned long start_job; /* the job the workers were started at */
+	int busy;
+	int stop;
+	/* the current job */
+	clist__parallel_fn fn;
+	void *task;
+	size_t n_parts; /* threads taking part, the caller included */
+	size_t pending; /* workers that haven't finished yet */
+} clist__parallel_pool;
+
+CLIST_HELPER clist__parallel_pool *clist__parallel_get_pool(void) {
+	static clist__parallel_pool pool = {
+		PTHREAD_MUTEX_INITIALIZER,
+		PTHREAD_COND_INITIALIZER,
+		PTHREAD_COND_INITIALIZER,
+		NULL, NULL, 0, 0, 0, 0, 0, 0, NULL, NULL, 0, 0
+	};
+
+	return &pool;
+}
+
+CLIST_HELPER size_t clist__parallel_cpus(void) {
+#if defined(CLIST_CORE_HAS_UNISTD) && defined(_SC_NPROCESSORS_ONLN)
+	long n = sysconf(_SC_NPROCESSORS_ONLN);
+	return n > 0 ? (size_t) n : 1;
+#else
+	return 1;
+#endif
+}
+
+/* claims the next chunk of the thread's own share */
+CLIST_HELPER int clist__parallel_take(clist__parallel_share *share, size_t *chunk_out) {
+	uint64_t old = __atomic_load_n(&share->range, __ATOMIC_ACQUIRE);
+
+	for (;;) {
+		size_t lo = CLIST_PARALLEL_LO(old);
+		size_t hi = CLIST_PARALLEL_HI(old);
+
+		if (lo >= hi) {
+			return 0;
+		}
+
+		if (__atomic_compare_exchange_n(&share->range, &old, CLIST_PARALLEL_PACK(lo + 1, hi), 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+			*chunk_out = lo;
+			return 1;
+		}
+	}
+}
+
+/* moves the back half of some other thread's remaining share over to
+   thread `self`; returns 0 once there's nothing left anywhere */
+CLIST_HELPER int clist__parallel_steal(clist__parallel_pool *pool, size_t self) {
+	size_t i;
+
+	for (i = 1; i < pool->n_parts; i++) {
+		clist__parallel_share *victim = &pool->shares[(self + i) % pool->n_parts];
+		uint64_t old = __atomic_load_n(&victim->range, __ATOMIC_ACQUIRE);
+
+		for (;;) {
+			size_t lo = CLIST_PARALLEL_LO(old);
+			size_t hi = CLIST_PARALLEL_HI(old);
+			size_t mid = lo + (hi - lo) / 2;
+
+			if (lo >= hi) {
+				break;
+			}
+
+			if (__atomic_compare_exchange_n(&victim->range, &old, CLIST_PARALLEL_PACK(lo, mid), 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+				__atomic_store_n(&pool->shares[self].range, CLIST_PARALLEL_PACK(mid, hi), __ATOMIC_RELEASE);
+				return 1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+CLIST_HELPER void clist__parallel_work(clist__parallel_pool *pool, size_t self) {
+	size_t chunk;
+
+	do {
+		while (clist__parallel_take(&pool->shares[self], &chunk)) {
+			pool->fn(pool->task, chunk);
+		}
+	} while (clist__parallel_steal(pool, self));
+}
+
+CLIST_HELPER void *clist__parallel_worker(void *arg) {
+	clist__parallel_pool *pool = clist__parallel_get_pool();
+	size_t self = (size_t) arg;
+	unsigned long seen;
+
+	pthread_mutex_lock(&pool->lock);
+	/* the first job may have been posted before this thread got here */
+	seen = pool->start_job;
+
+	for (;;) {
+		while (!pool->stop && pool->job == seen) {
+			pthread_cond_wait(&pool->wake, &pool->lock);
+		}
+
+		if (pool->stop) {
+			break;
+		}
+
+		seen = pool->job;
+		if (self >= pool->n_parts) {
+			continue;
+		}
+
+		pthread_mutex_unlock(&pool->lock);
+		clist__parallel_work(pool, self);
+		pthread_mutex_lock(&pool->lock);
+
+		if (--pool->pending == 0) {
+			pthread_cond_broadcast(&pool->done);
+		}
+	}
+
+	pthread_mutex_unlock(&pool->lock);
+	return NULL;
+}
+
+/* starts the workers if they aren't running yet; called with the lock held.
+   if some of them can't be started the pool just makes do with fewer. */
+CLIST_HELPER void clist__parallel_start(clist__parallel_pool *pool) {
+	if (pool->threads != NULL) {
+		return;
+	}
+
+	if (pool->n_threads == 0) {
+		pool->n_threads = clist__parallel_cpus();
+	}
+
+	if (pool->n_threads < 2) {
+		return;
+	}
+
+	pool->shares = (clist__parallel_share *) clist__alloc(pool->n_threads * sizeof(clist__parallel_share));
+	pool->threads = (pthread_t *) clist__alloc((pool->n_threads - 1) * sizeof(pthread_t));
+
+	if (CLIST_UNLIKELY(pool->shares == NULL || pool->threads == NULL)) {
+		clist__free(pool->shares);
+		clist__free(pool->threads);
+		pool->shares = NULL;
+		pool->threads = NULL;
+		return;
+	}
+
+	pool->start_job = pool->job;
+	for (pool->n_workers = 0; pool->n_workers < pool->n_threads - 1; pool->n_workers++) {
+		if (pthread_create(&pool->threads[pool->n_workers], NULL, &clist__parallel_worker, (void *) (pool->n_workers + 1)) != 0) {
+			break;
+		}
+	}
+}
+
+/* joins the workers; called with the lock held and the pool idle */
+CLIST_HELPER void clist__parallel_stop(clist__parallel_pool *pool) {
+	size_t i;
+
+	if (pool->threads == NULL) {
+		return;
+	}
+
+	/* keeps parallel calls from using the pool in the meantime */
+	pool->busy = 1;
+	pool->stop = 1;
+	pthread_cond_broadcast(&pool->wake);
+	pthread_mutex_unlock(&pool->lock);
+
+	for (i = 0; i < pool->n_workers; i++) {
+		pthread_join(pool->threads[i], NULL);
+	}
+
+	pthread_mutex_lock(&pool->lock);
+	clist__free(pool->threads);
+	clist__free(pool->shares);
+	pool->threads = NULL;
+	pool->shares = NULL;
+	pool->n_workers = 0;
+	pool->stop = 0;
+	pool->busy = 0;
+	pthread_cond_broadcast(&pool->done);
+}
+
+/* sets how many threads (the caller included) parallel calls use and
+   returns the new count; 0 leaves it as is. defaults to the number of
+   online CPUs. must not be called from inside a parallel callback. */
+CLIST_HELPER size_t clist_parallel_threads(size_t n_threads) {
+	clist__parallel_pool *pool = clist__parallel_get_pool();
+	size_t result;
+
+	pthread_mutex_lock(&pool->lock);
+
+	while (pool->busy) {
+		pthread_cond_wait(&pool->done, &pool->lock);
+	}
+
+	if (n_threads > 0 && n_threads != pool->n_threads) {
+		clist__parallel_stop(pool);
+		pool->n_threads = n_threads;
+	} else if (pool->n_threads == 0) {
+		pool->n_threads = clist__parallel_cpus();
+	}
+
+	result = pool->n_threads;
+	pthread_mutex_unlock(&pool->lock);
+	return result;
+}
+
+/* how many elements go into each chunk, and how many chunks that makes */
+CLIST_HELPER size_t clist__parallel_chunk_size(size_t n_elems, size_t block_size, size_t *n_chunks_out) {
+	size_t n_blocks = n_elems / block_size + (n_elems % block_size != 0);
+	size_t per_chunk = n_blocks / CLIST_PARALLEL_MAX_CHUNKS + (n_blocks % CLIST_PARALLEL_MAX_CHUNKS != 0);
+	size_t chunk_size = (per_chunk > 0 ? per_chunk : 1) * block_size;
+
+	*n_chunks_out = n_elems / chunk_size + (n_elems % chunk_size != 0);
+	return chunk_size;
+}
+
+/* calls `fn(task, chunk)` once for every chunk in [0, n_chunks) and
+   returns when they've all finished */
+CLIST_HELPER void clist__parallel_run(clist__parallel_fn fn, void *task, size_t n_chunks) {
+	clist__parallel_pool *pool = clist__parallel_get_pool();
+	size_t i;
+
+	pthread_mutex_lock(&pool->lock);
+
+	if (n_chunks > 1 && !pool->busy) {
+		clist__parallel_start(pool);
+	}
+
+	if (n_chunks < 2 || pool->busy || pool->n_workers == 0) {
+		pthread_mutex_unlock(&pool->lock);
+
+		for (i = 0; i < n_chunks; i++) {
+			fn(task, i);
+		}
+
+		return;
+	}
+
+	pool->busy = 1;
+	pool->fn = fn;
+	pool->task = task;
+	pool->n_parts = pool->n_workers + 1 < n_chunks ? pool->n_workers + 1 : n_chunks;
+	pool->pending = pool->n_parts - 1;
+
+	for (i = 0; i < pool->n_parts; i++) {
+		pool->shares[i].range = CLIST_PARALLEL_PACK(i * n_chunks / pool->n_parts, (i + 1) * n_chunks / pool->n_parts);
+	}
+
+	++pool->job;
+	pthread_cond_broadcast(&pool->wake);
+	pthread_mutex_unlock(&pool->lock);
+
+	clist__parallel_work(pool, 0);
+
+	pthread_mutex_lock(&pool->lock);
+	while (pool->pending > 0) {
+		pthread_cond_wait(&pool->done, &pool->lock);
+	}
+	pool->busy = 0;
+	pthread_cond_broadcast(&pool->done);
+	pthread_mutex_unlock(&pool->lock);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
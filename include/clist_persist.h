@@ -0,0 +1,458 @@
+/*
+	Persistence - included by clist_type.h when CLIST_PERSIST is
+	defined. Do not include this file directly.
+
+	      #define CLIST_PERSIST
+	      #define CLIST_TYPE struct point
+	      #define CLIST_NAME point
+	      #include "clist_type.h"
+
+	      clist_point_save(&L, "points.bin");
+
+	      // later, without copying anything
+	      clist_point_mapped M;
+	      clist_point_map(&M, "points.bin", CLIST_MAP_VERIFY);
+	      n = clist_point_count(&M.list);
+	      p = clist_point_get(&M.list, 0);
+	      clist_point_unmap(&M);
+
+	      // or into an ordinary list that can grow
+	      clist_point_load(&L, "points.bin");
+
+	Only for element types without pointers in them (integers, floats,
+	plain structs); the bytes are written out and read back as they
+	are. Under C++ the type has to be trivially copyable.
+
+	A file is a 64 byte header (magic, format version, byte order,
+	element size and alignment, element count, a checksum of the
+	elements and where they start) followed by the elements exactly as
+	they are laid out in memory, written with as few write(2) calls as
+	possible. Files are only readable by lists of the same element size
+	and alignment on a machine with the same byte order.
+
+	clist_NAME_map() maps a file and points M.list at the elements in
+	the mapping, so loading costs no more than paging the file in.
+	Pass &M.list to anything that only reads a list; never add to it,
+	remove from it or free it. Flags:
+
+	      CLIST_MAP_VERIFY   - checks the checksum first, which reads the
+	                           whole file (sequentially) up front
+	      CLIST_MAP_PRIVATE  - maps copy-on-write, so the elements can be
+	                           changed in place without touching the file
+	      CLIST_MAP_POPULATE - pages everything in right away, if the
+	                           system supports it
+
+	clist_NAME_load() reads a file onto the end of an initialized list,
+	with one allocation and one read(2) of the elements. It always
+	checks the checksum. clist_NAME_save_fd() and clist_NAME_load_fd()
+	do the same with a file that is already open.
+
+	Both return 0 on success, or 1 with errno set: EINVAL if the file
+	isn't a list of this type (or is truncated), EIO if the checksum
+	doesn't match.
+*/
+
+#ifndef CLIST_PERSIST_H__
+#define CLIST_PERSIST_H__
+
+#ifndef CLIST_CORE_HAS_UNISTD
+#	error "CLIST_PERSIST needs POSIX mmap(2)"
+#endif
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define CLIST_PERSIST_MAGIC "CLISTDAT"
+#define CLIST_PERSIST_VERSION 1
+#define CLIST_PERSIST_BYTE_ORDER 0x01020304u
+
+#define CLIST_MAP_VERIFY 1
+#define CLIST_MAP_PRIVATE 2
+#define CLIST_MAP_POPULATE 4
+
+/* reads and writes are done in pieces no bigger than this, since some
+   systems won't do more than 2GB in one go */
+#define CLIST_PERSIST_IO_MAX ((size_t) 1 << 30)
+
+typedef struct clist_persist_header {
+	char magic[8];
+	uint32_t version;
+	uint32_t byte_order;
+	uint64_t elem_size;
+	uint64_t alignment;
+	uint64_t count;
+	uint64_t data_offset; /* from the start of the file */
+	uint64_t checksum; /* of the elements only */
+	uint64_t reserved;
+} clist_persist_header;
+
+typedef char clist__persist_header_size[sizeof(clist_persist_header) == 64 ? 1 : -1];
+
+#define CLIST__PERSIST_P1 UINT64_C(0x9E3779B185EBCA87)
+#define CLIST__PERSIST_P2 UINT64_C(0xC2B2AE3D27D4EB4F)
+#define CLIST__PERSIST_ROUND(h, w) ((h) = (((h) + (w) * CLIST__PERSIST_P2) << 31 | ((h) + (w) * CLIST__PERSIST_P2) >> 33) * CLIST__PERSIST_P1)
+
+/* four independent lanes of 64 bit words, so that it runs at about
+   the speed the data can be read */
+CLIST_HELPER uint64_t clist__persist_checksum(const void *data, size_t size) {
+	const unsigned char *p = (const unsigned char *) data;
+	uint64_t lanes[4];
+	uint64_t h;
+	uint64_t w;
+	size_t i;
+
+	lanes[0] = CLIST__PERSIST_P1;
+	lanes[1] = CLIST__PERSIST_P2;
+	lanes[2] = 0;
+	lanes[3] = CLIST__PERSIST_P1 ^ CLIST__PERSIST_P2;
+
+	for (; size >= 32; p += 32, size -= 32) {
+		for (i = 0; i < 4; i++) {
+			memcpy(&w, p + i * 8, 8);
+			CLIST__PERSIST_ROUND(lanes[i], w);
+		}
+	}
+
+	h = lanes[0] ^ (lanes[1] << 7 | lanes[1] >> 57) ^ (lanes[2] << 12 | lanes[2] >> 52) ^ (lanes[3] << 18 | lanes[3] >> 46);
+
+	for (; size >= 8; p += 8, size -= 8) {
+		memcpy(&w, p, 8);
+		CLIST__PERSIST_ROUND(h, w);
+	}
+
+	for (; size > 0; p++, size--) {
+		w = *p;
+		CLIST__PERSIST_ROUND(h, w);
+	}
+
+	return h ^ h >> 29;
+}
+
+CLIST_HELPER int clist__persist_write_all(int fd, const void *data, size_t size) {
+	const char *p = (const char *) data;
+
+	while (size > 0) {
+		ssize_t written = write(fd, p, size < CLIST_PERSIST_IO_MAX ? size : CLIST_PERSIST_IO_MAX);
+
+		if (written < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+
+			/* errno already set */
+			return 1;
+		}
+
+		p += written;
+		size -= (size_t) written;
+	}
+
+	return 0;
+}
+
+CLIST_HELPER int clist__persist_read_all(int fd, void *data, size_t size) {
+	char *p = (char *) data;
+
+	while (size > 0) {
+		ssize_t got = read(fd, p, size < CLIST_PERSIST_IO_MAX ? size : CLIST_PERSIST_IO_MAX);
+
+		if (got < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+
+			/* errno already set */
+			return 1;
+		}
+
+		if (got == 0) {
+			/* shorter than the header says */
+			errno = EINVAL;
+			return 1;
+		}
+
+		p += got;
+		size -= (size_t) got;
+	}
+
+	return 0;
+}
+
+CLIST_HELPER void clist__persist_header_init(clist_persist_header *header, size_t elem_size, size_t alignment, size_t count, uint64_t checksum) {
+	memset(header, 0, sizeof(*header));
+	memcpy(header->magic, CLIST_PERSIST_MAGIC, sizeof(header->magic));
+	header->version = CLIST_PERSIST_VERSION;
+	header->byte_order = CLIST_PERSIST_BYTE_ORDER;
+	header->elem_size = elem_size;
+	header->alignment = alignment;
+	header->count = count;
+	header->data_offset = alignment > sizeof(*header) ? alignment : sizeof(*header);
+	header->checksum = checksum;
+}
+
+/* checks that `header` describes a list of this type that fits in
+   `file_size` bytes */
+CLIST_HELPER int clist__persist_header_check(const clist_persist_header *header, size_t elem_size, size_t alignment, uint64_t file_size) {
+	if (memcmp(header->magic, CLIST_PERSIST_MAGIC, sizeof(header->magic)) != 0
+		|| header->version != CLIST_PERSIST_VERSION
+		|| header->byte_order != CLIST_PERSIST_BYTE_ORDER
+		|| header->elem_size != elem_size
+		|| header->alignment != alignment
+		|| header->data_offset < sizeof(*header)
+		|| header->data_offset % alignment != 0
+		|| header->data_offset > file_size
+		|| header->count > CLIST_MAX_INDEX
+		|| header->count > (file_size - header->data_offset) / elem_size
+	) {
+		errno = EINVAL;
+		return 1;
+	}
+
+	return 0;
+}
+#endif
+
+/* see header comment - DO NOT PRAGMA ONCE OR INCLUDE GUARD! */
+
+#ifdef __cplusplus
+#	define CLIST_PERSIST_ELEM_ALIGN alignof(CLIST(type))
+#else
+typedef struct CLIST(align_probe) {
+	char c;
+	CLIST(type) elem;
+} CLIST(align_probe);
+#	define CLIST_PERSIST_ELEM_ALIGN offsetof(CLIST(align_probe), elem)
+#endif
+
+/* the elements line up like those of any other list of the type */
+#ifdef CLIST_ALIGNMENT
+#	define CLIST_PERSIST_ALIGN (CLIST_PERSIST_ELEM_ALIGN > CLIST_ALIGNMENT ? CLIST_PERSIST_ELEM_ALIGN : (size_t) CLIST_ALIGNMENT)
+#else
+#	define CLIST_PERSIST_ALIGN CLIST_PERSIST_ELEM_ALIGN
+#endif
+
+typedef struct CLIST(mapped) {
+	CLIST_T list; /* its block points into the mapping */
+	void *map;
+	size_t map_size;
+} CLIST(mapped);
+
+/* writes the list to `fd` at its current position. returns 0 on
+   success, or 1 with errno set. */
+CLIST_API int CLIST(save_fd) (const CLIST_T *list, int fd) {
+	clist_persist_header header;
+	char padding[sizeof(header)];
+	size_t data_size;
+	size_t pos;
+	size_t n;
+
+#ifdef __cplusplus
+	static_assert(std::is_trivially_copyable<CLIST(type)>::value, "elements are saved and loaded as raw bytes");
+#endif
+
+	CLIST_ASSERT(list != NULL);
+
+	data_size = list->count * sizeof(CLIST(type));
+	clist__persist_header_init(&header, sizeof(CLIST(type)), CLIST_PERSIST_ALIGN, list->count, clist__persist_checksum(list->block, data_size));
+
+	if (CLIST_UNLIKELY(clist__persist_write_all(fd, &header, sizeof(header)) != 0)) {
+		return 1;
+	}
+
+	/* only for over-aligned types */
+	memset(padding, 0, sizeof(padding));
+	for (pos = sizeof(header); pos < header.data_offset; pos += n) {
+		n = header.data_offset - pos < sizeof(padding) ? (size_t) (header.data_offset - pos) : sizeof(padding);
+
+		if (CLIST_UNLIKELY(clist__persist_write_all(fd, padding, n) != 0)) {
+			return 1;
+		}
+	}
+
+	return clist__persist_write_all(fd, list->block, data_size);
+}
+
+/* creates (or replaces) the file at `path`. returns 0 on success, or 1
+   with errno set. */
+CLIST_API int CLIST(save) (const CLIST_T *list, const char *path) {
+	int fd;
+	int res;
+
+	CLIST_ASSERT(path != NULL);
+
+	fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (CLIST_UNLIKELY(fd < 0)) {
+		/* errno already set */
+		return 1;
+	}
+
+	res = CLIST(save_fd)(list, fd);
+
+	if (CLIST_UNLIKELY(close(fd) != 0)) {
+		res = 1;
+	}
+
+	return res;
+}
+
+/* appends the elements in the file open at `fd` (read from its start)
+   to `list`. returns 0 on success, or 1 with errno set, in which case
+   `list` has its old elements but possibly more capacity. */
+CLIST_API int CLIST(load_fd) (CLIST_T *list, int fd) {
+	clist_persist_header header;
+	struct stat st;
+	size_t data_size;
+
+	CLIST_ASSERT(list != NULL);
+
+	if (CLIST_UNLIKELY(fstat(fd, &st) != 0)) {
+		/* errno already set */
+		return 1;
+	}
+
+	if (CLIST_UNLIKELY(lseek(fd, 0, SEEK_SET) == (off_t) -1 || clist__persist_read_all(fd, &header, sizeof(header)) != 0)) {
+		/* errno already set */
+		return 1;
+	}
+
+	if (CLIST_UNLIKELY(clist__persist_header_check(&header, sizeof(CLIST(type)), CLIST_PERSIST_ALIGN, (uint64_t) st.st_size) != 0)) {
+		return 1;
+	}
+
+	if (CLIST_UNLIKELY(header.count > CLIST_MAX_INDEX - list->count)) {
+		errno = EOVERFLOW;
+		return 1;
+	}
+
+	if (CLIST_UNLIKELY(CLIST(reserve)(list, list->count + (size_t) header.count) != 0)) {
+		/* errno already set */
+		return 1;
+	}
+
+	data_size = (size_t) header.count * sizeof(CLIST(type));
+
+	if (CLIST_UNLIKELY(lseek(fd, (off_t) header.data_offset, SEEK_SET) == (off_t) -1 || clist__persist_read_all(fd, list->block + list->count, data_size) != 0)) {
+		/* errno already set */
+		return 1;
+	}
+
+	if (CLIST_UNLIKELY(clist__persist_checksum(list->block + list->count, data_size) != header.checksum)) {
+		errno = EIO;
+		return 1;
+	}
+
+	list->count += (size_t) header.count;
+	CLIST_STAT(list, adds, (size_t) header.count);
+	return 0;
+}
+
+/* appends the elements in the file at `path` to `list`; see clist_load_fd() */
+CLIST_API int CLIST(load) (CLIST_T *list, const char *path) {
+	int fd;
+	int res;
+
+	CLIST_ASSERT(path != NULL);
+
+	fd = open(path, O_RDONLY);
+	if (CLIST_UNLIKELY(fd < 0)) {
+		/* errno already set */
+		return 1;
+	}
+
+	res = CLIST(load_fd)(list, fd);
+	(void) close(fd);
+	return res;
+}
+
+/* maps the file at `path` and points `mapped->list` at its elements.
+   `flags` are any of the CLIST_MAP_* flags. returns 0 on success, or 1
+   with errno set. */
+CLIST_API int CLIST(map) (CLIST(mapped) *mapped, const char *path, int flags) {
+	clist_persist_header header;
+	struct stat st;
+	int fd;
+	int prot = PROT_READ;
+	int map_flags = MAP_SHARED;
+	char *map;
+
+	CLIST_ASSERT(mapped != NULL);
+	CLIST_ASSERT(path != NULL);
+
+	fd = open(path, O_RDONLY);
+	if (CLIST_UNLIKELY(fd < 0)) {
+		/* errno already set */
+		return 1;
+	}
+
+	if (CLIST_UNLIKELY(fstat(fd, &st) != 0)) {
+		(void) close(fd);
+		return 1;
+	}
+
+	if (CLIST_UNLIKELY((uint64_t) st.st_size < sizeof(header) || (uint64_t) st.st_size > CLIST_MAX_INDEX)) {
+		(void) close(fd);
+		errno = EINVAL;
+		return 1;
+	}
+
+	if (flags & CLIST_MAP_PRIVATE) {
+		prot |= PROT_WRITE;
+		map_flags = MAP_PRIVATE;
+	}
+
+#ifdef MAP_POPULATE
+	if (flags & CLIST_MAP_POPULATE) {
+		map_flags |= MAP_POPULATE;
+	}
+#endif
+
+	map = (char *) mmap(NULL, (size_t) st.st_size, prot, map_flags, fd, 0);
+	(void) close(fd); /* the mapping keeps the file open */
+
+	if (CLIST_UNLIKELY(map == MAP_FAILED)) {
+		/* errno already set */
+		return 1;
+	}
+
+	memcpy(&header, map, sizeof(header));
+
+	if (CLIST_UNLIKELY(clist__persist_header_check(&header, sizeof(CLIST(type)), CLIST_PERSIST_ALIGN, (uint64_t) st.st_size) != 0)) {
+		(void) munmap(map, (size_t) st.st_size);
+		return 1;
+	}
+
+	if (flags & CLIST_MAP_VERIFY) {
+#ifdef MADV_SEQUENTIAL
+		(void) madvise(map, (size_t) st.st_size, MADV_SEQUENTIAL);
+#endif
+
+		if (CLIST_UNLIKELY(clist__persist_checksum(map + header.data_offset, (size_t) header.count * sizeof(CLIST(type))) != header.checksum)) {
+			(void) munmap(map, (size_t) st.st_size);
+			errno = EIO;
+			return 1;
+		}
+	}
+
+	CLIST(init)(&mapped->list);
+	mapped->list.block = (CLIST(type) *) (void *) (map + header.data_offset);
+	mapped->list.count = (size_t) header.count;
+	mapped->list.capacity = (size_t) header.count;
+	mapped->map = map;
+	mapped->map_size = (size_t) st.st_size;
+	return 0;
+}
+
+CLIST_API void CLIST(unmap) (CLIST(mapped) *mapped) {
+	CLIST_ASSERT(mapped != NULL);
+
+	(void) munmap(mapped->map, mapped->map_size);
+	mapped->map = NULL;
+	mapped->map_size = 0;
+	CLIST(init)(&mapped->list);
+}
+
+#undef CLIST_PERSIST_ALIGN
+#undef CLIST_PERSIST_ELEM_ALIGN
@@ -0,0 +1,109 @@
+#ifndef CLIST_RADIX_H__
+#define CLIST_RADIX_H__
+#pragma once
+/*
+	the type-independent half of clist_NAME_radix_sort(), which
+	clist_type.h generates for CLIST_KIND lists and for lists with
+	a CLIST_RADIX_KEY.
+
+	elements are sorted on unsigned keys, one byte (256 buckets) per
+	pass starting with the lowest. every kind maps to a key that sorts
+	in the same order as its values: signed integers get their sign bit
+	flipped, floats their sign bit (positive) or all bits (negative),
+	which puts NaNs at either end.
+
+	passes where every element has the same byte are skipped, so keys
+	that only use their low bytes (small integers, pointers from the
+	same region) sort in fewer passes.
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "./clist_core.h"
+#include "./clist_simd.h"
+
+#ifndef CLIST_RADIX_PARALLEL_MIN
+	/* lists shorter than this aren't worth handing to the thread pool */
+#	define CLIST_RADIX_PARALLEL_MIN 65536
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void (*clist__radix_fn)(void *task, size_t chunk);
+
+CLIST_HELPER uint64_t clist__radix_key_i32(clist__elem_t_i32 val) {
+	return (uint32_t) val ^ 0x80000000u;
+}
+
+CLIST_HELPER uint64_t clist__radix_key_u32(clist__elem_t_u32 val) {
+	return val;
+}
+
+CLIST_HELPER uint64_t clist__radix_key_i64(clist__elem_t_i64 val) {
+	return (uint64_t) val ^ ((uint64_t) 1 << 63);
+}
+
+CLIST_HELPER uint64_t clist__radix_key_u64(clist__elem_t_u64 val) {
+	return val;
+}
+
+CLIST_HELPER uint64_t clist__radix_key_f32(clist__elem_t_f32 val) {
+	uint32_t bits;
+	memcpy(&bits, &val, sizeof(bits));
+	return (bits & 0x80000000u) ? (uint32_t) ~bits : bits | 0x80000000u;
+}
+
+CLIST_HELPER uint64_t clist__radix_key_f64(clist__elem_t_f64 val) {
+	uint64_t bits;
+	uint64_t sign = (uint64_t) 1 << 63;
+	memcpy(&bits, &val, sizeof(bits));
+	return (bits & sign) ? ~bits : bits | sign;
+}
+
+#if UINTPTR_MAX == UINT64_MAX
+#	define clist__radix_key_ptr clist__radix_key_u64
+#else
+#	define clist__radix_key_ptr clist__radix_key_u32
+#endif
+
+/* turns the per-chunk byte counts (`stride` apart) into the position
+   each chunk writes its first element of every byte value to, in
+   chunk order within a byte value so that the sort stays stable.
+   returns 0 without touching `offsets` if every element has the same
+   byte, in which case the pass can be skipped. */
+CLIST_HELPER int clist__radix_offsets(const size_t *counts, size_t stride, size_t n_chunks, size_t n_elems, size_t *offsets) {
+	size_t totals[256];
+	size_t pos = 0;
+	size_t digit;
+	size_t chunk;
+
+	for (digit = 0; digit < 256; digit++) {
+		totals[digit] = 0;
+		for (chunk = 0; chunk < n_chunks; chunk++) {
+			totals[digit] += counts[chunk * stride + digit];
+		}
+
+		if (totals[digit] == n_elems) {
+			return 0;
+		}
+	}
+
+	for (digit = 0; digit < 256; digit++) {
+		for (chunk = 0; chunk < n_chunks; chunk++) {
+			offsets[chunk * 256 + digit] = pos;
+			pos += counts[chunk * stride + digit];
+		}
+	}
+
+	return 1;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,217 @@
+/*
+	Ring buffers - included by clist_type.h when CLIST_RING is defined.
+	Do not include this file directly.
+
+	      #define CLIST_RING
+	      #define CLIST_TYPE struct job
+	      #define CLIST_NAME job
+	      #include "clist_type.h"
+
+	      clist_job_ring R;
+	      clist_job_ring_init(&R, 1024);
+
+	      // producer thread
+	      while (!clist_job_ring_push(&R, job)) { ... }
+
+	      // consumer thread
+	      struct job job;
+	      if (clist_job_ring_pop(&R, &job)) { ... }
+
+	A clist_NAME_ring is a bounded queue for handing elements from
+	exactly one producer thread to exactly one consumer thread without
+	locking. Its storage is an ordinary list's block, used as a ring
+	whose size is rounded up to a power of two; if that fits in
+	CLIST_INLINE_CAPACITY the ring lives entirely inside the struct and
+	never touches the heap. Either way it is allocated once, up front,
+	and never grows: pushing to a full ring (or popping from an empty
+	one) just does nothing and says so.
+
+	The producer only ever writes the tail and the consumer the head,
+	each on its own cache line, apart from the ring's read-only fields
+	(the ring is aligned to CLIST_RING_CACHE_LINE for that, which rings
+	on the heap need an aligned allocation for). Each side also keeps the last value of
+	the other side's index it saw, so that it only has to read the
+	other thread's cache line when it seems to be out of room.
+
+	clist_NAME_ring_push_n() and clist_NAME_ring_pop_n() move as many
+	of `n` elements as they can at once and return how many that was;
+	batching like this makes the hand-off far cheaper per element.
+
+	A ring must not be moved once initialized, and clist_NAME_ring_init()
+	and clist_NAME_ring_free() must not race with anything else.
+*/
+
+#ifndef CLIST_RING_H__
+#define CLIST_RING_H__
+
+#ifndef CLIST_RING_CACHE_LINE
+#	define CLIST_RING_CACHE_LINE 64
+#endif
+#endif
+
+/* see header comment - DO NOT PRAGMA ONCE OR INCLUDE GUARD! */
+
+typedef struct CLIST(ring) {
+	/* only read once initialized, by both sides */
+	size_t mask; /* capacity - 1 */
+	CLIST_T list; /* owns the storage; its count isn't used */
+
+	/* the consumer's side */
+	CLIST_ALIGNAS(CLIST_RING_CACHE_LINE) size_t head; /* next element to pop */
+	size_t tail_cache; /* the tail as the consumer last saw it */
+
+	/* the producer's side */
+	CLIST_ALIGNAS(CLIST_RING_CACHE_LINE) size_t tail; /* next slot to push into */
+	size_t head_cache; /* the head as the producer last saw it */
+} CLIST(ring);
+
+/* `capacity` is rounded up to a power of two. returns 0 on success,
+   or 1 with errno set */
+CLIST_API int CLIST(ring_init) (CLIST(ring) *ring, size_t capacity) {
+	size_t size = 1;
+
+	CLIST_ASSERT(ring != NULL);
+	CLIST_ASSERT(capacity > 0);
+
+	while (size < capacity) {
+		if (CLIST_UNLIKELY(size > CLIST_MAX_INDEX / 2)) {
+			errno = ENOMEM;
+			return 1;
+		}
+
+		size *= 2;
+	}
+
+	CLIST(init)(&ring->list);
+	if (CLIST_UNLIKELY(CLIST(reserve)(&ring->list, size) != 0)) {
+		/* errno already set */
+		return 1;
+	}
+
+	ring->head = 0;
+	ring->tail_cache = 0;
+	ring->tail = 0;
+	ring->head_cache = 0;
+	ring->mask = size - 1;
+	return 0;
+}
+
+CLIST_API void CLIST(ring_free) (CLIST(ring) *ring) {
+	CLIST_ASSERT(ring != NULL);
+
+#ifdef __cplusplus
+	{
+		size_t i;
+		for (i = ring->head; i != ring->tail; i++) {
+			ring->list.block[i & ring->mask].~CLIST(type)();
+		}
+	}
+#endif
+
+	CLIST(free)(&ring->list);
+}
+
+CLIST_API size_t CLIST(ring_capacity) (const CLIST(ring) *ring) {
+	CLIST_ASSERT(ring != NULL);
+	return ring->mask + 1;
+}
+
+/* only exact when called from the producer or the consumer while the
+   other one is idle */
+CLIST_API size_t CLIST(ring_count) (const CLIST(ring) *ring) {
+	size_t head;
+
+	CLIST_ASSERT(ring != NULL);
+
+	head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+	return __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) - head;
+}
+
+/* producer only - pushes as many of the `n_elems` elements at `vals`
+   as there is room for, and returns how many that was */
+CLIST_API size_t CLIST(ring_push_n) (CLIST(ring) *ring, const CLIST(type) *vals, size_t n_elems) {
+	size_t tail;
+	size_t room;
+	size_t i;
+
+	CLIST_ASSERT(ring != NULL);
+	CLIST_ASSERT(vals != NULL || n_elems == 0);
+
+	tail = ring->tail; /* only this thread writes it */
+	room = ring->mask + 1 - (tail - ring->head_cache);
+
+	if (room < n_elems) {
+		ring->head_cache = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+		room = ring->mask + 1 - (tail - ring->head_cache);
+		if (room < n_elems) {
+			n_elems = room;
+		}
+	}
+
+#ifdef __cplusplus
+	for (i = 0; i < n_elems; i++) {
+		new (&ring->list.block[(tail + i) & ring->mask]) CLIST(type)(vals[i]);
+	}
+#else
+	/* at most two runs - up to the end of the block, then from the start */
+	i = ring->mask + 1 - (tail & ring->mask);
+	if (i > n_elems) {
+		i = n_elems;
+	}
+	CLIST_MEMCPY((void *) &ring->list.block[tail & ring->mask], vals, i * sizeof(CLIST(type)));
+	CLIST_MEMCPY((void *) ring->list.block, vals + i, (n_elems - i) * sizeof(CLIST(type)));
+#endif
+
+	__atomic_store_n(&ring->tail, tail + n_elems, __ATOMIC_RELEASE);
+	return n_elems;
+}
+
+/* consumer only - pops up to `n_elems` elements into `out` (oldest
+   first), and returns how many that was */
+CLIST_API size_t CLIST(ring_pop_n) (CLIST(ring) *ring, CLIST(type) *out, size_t n_elems) {
+	size_t head;
+	size_t avail;
+	size_t i;
+
+	CLIST_ASSERT(ring != NULL);
+	CLIST_ASSERT(out != NULL || n_elems == 0);
+
+	head = ring->head; /* only this thread writes it */
+	avail = ring->tail_cache - head;
+
+	if (avail < n_elems) {
+		ring->tail_cache = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+		avail = ring->tail_cache - head;
+		if (avail < n_elems) {
+			n_elems = avail;
+		}
+	}
+
+#ifdef __cplusplus
+	for (i = 0; i < n_elems; i++) {
+		CLIST(type) *slot = &ring->list.block[(head + i) & ring->mask];
+		out[i] = std::move(*slot);
+		slot->~CLIST(type)();
+	}
+#else
+	i = ring->mask + 1 - (head & ring->mask);
+	if (i > n_elems) {
+		i = n_elems;
+	}
+	CLIST_MEMCPY((void *) out, &ring->list.block[head & ring->mask], i * sizeof(CLIST(type)));
+	CLIST_MEMCPY((void *) (out + i), ring->list.block, (n_elems - i) * sizeof(CLIST(type)));
+#endif
+
+	__atomic_store_n(&ring->head, head + n_elems, __ATOMIC_RELEASE);
+	return n_elems;
+}
+
+/* producer only - returns false if the ring is full */
+CLIST_API bool CLIST(ring_push) (CLIST(ring) *ring, const CLIST(type) CLIST_REF val) {
+	return CLIST(ring_push_n)(ring, &val, 1) == 1;
+}
+
+/* consumer only - returns false if the ring is empty */
+CLIST_API bool CLIST(ring_pop) (CLIST(ring) *ring, CLIST(type) *out) {
+	return CLIST(ring_pop_n)(ring, out, 1) == 1;
+}
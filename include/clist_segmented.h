@@ -0,0 +1,243 @@
+/*
+	Segmented lists - included by clist_type.h when CLIST_SEGMENTED
+	is defined. Do not include this file directly.
+
+	      #define CLIST_SEGMENTED
+	      #define CLIST_TYPE struct some_type
+	      #define CLIST_NAME sometype
+	      #include "clist_type.h"
+
+	      clist_sometype_seg S;
+	      clist_sometype_seg_init(&S);
+
+	A clist_NAME_seg stores its elements in CLIST_BLOCK_SIZE sized
+	blocks that are allocated on their own and found through a block
+	table. Growing only ever allocates new blocks (and, rarely, a bigger
+	table of pointers), so elements never move: pointers returned by
+	clist_NAME_seg_get() stay valid until the element is popped, the
+	list is cleared or the list is freed.
+
+	Keep CLIST_BLOCK_SIZE a power of two so that indexing compiles down
+	to a shift and a mask, and make CLIST_BLOCK_SIZE_BYTES fill whole
+	pages since every block is its own (page rounded) allocation.
+
+	Blocks and the table are allocated like any list's heap blocks:
+	with CLIST_ALIGNMENT, out of an arena given to
+	clist_NAME_seg_init_arena() under CLIST_ARENA, and counted by
+	clist_NAME_seg_stats() under CLIST_STATS (and in the type's totals
+	once the list is freed).
+*/
+
+/* see header comment - DO NOT PRAGMA ONCE OR INCLUDE GUARD! */
+
+typedef struct CLIST(seg) {
+	size_t count;
+	size_t blocks; /* number of allocated blocks */
+	size_t table_size; /* number of slots in `table` */
+	CLIST(type) **table;
+#ifdef CLIST_ARENA
+	clist_arena *arena;
+#endif
+#ifdef CLIST_STATS
+	clist_stats stats; /* capacities are in elements, as for lists */
+#endif
+} CLIST(seg);
+
+CLIST_API void CLIST(seg_init) (CLIST(seg) *list) {
+	CLIST_ASSERT(list != NULL);
+	list->count = 0;
+	list->blocks = 0;
+	list->table_size = 0;
+	list->table = NULL;
+#ifdef CLIST_ARENA
+	list->arena = NULL;
+#endif
+#ifdef CLIST_STATS
+	CLIST_MEMSET(&list->stats, 0, sizeof(list->stats));
+#endif
+}
+
+#ifdef CLIST_ARENA
+/* initializes a list whose blocks come out of `arena` */
+CLIST_API void CLIST(seg_init_arena) (CLIST(seg) *list, clist_arena *arena) {
+	CLIST(seg_init)(list);
+	list->arena = arena;
+}
+#endif
+
+#ifdef CLIST_STATS
+/* the list's counters since it was initialized */
+CLIST_API void CLIST(seg_stats) (const CLIST(seg) *list, clist_stats *out) {
+	CLIST_ASSERT(list != NULL);
+	CLIST_ASSERT(out != NULL);
+
+	*out = list->stats;
+	out->lists = 1;
+	out->count = list->count;
+	out->capacity = list->blocks * CLIST_BLOCK_SIZE;
+}
+#endif
+
+CLIST_API void CLIST(seg_clear) (CLIST(seg) *list) {
+	CLIST_ASSERT(list != NULL);
+
+#ifdef __cplusplus
+	{
+		size_t i;
+		for (i = 0; i < list->count; i++) {
+			list->table[i / CLIST_BLOCK_SIZE][i % CLIST_BLOCK_SIZE].~CLIST(type)();
+		}
+	}
+#endif
+
+	list->count = 0;
+}
+
+CLIST_API void CLIST(seg_free) (CLIST(seg) *list) {
+	size_t i;
+
+	CLIST_ASSERT(list != NULL);
+
+#ifdef __cplusplus
+	CLIST(seg_clear)(list);
+#endif
+
+#ifdef CLIST_STATS
+	list->stats.count = list->count;
+	list->stats.capacity = list->blocks * CLIST_BLOCK_SIZE;
+	clist__stats_fold(&CLIST(stats_totals), &list->stats, 1);
+#endif
+
+	for (i = 0; i < list->blocks; i++) {
+		CLIST__PRIVATE(owned_free)(CLIST__OWNER_ARENA(list), list->table[i]);
+	}
+
+	if (list->table != NULL) {
+		CLIST__PRIVATE(owned_free)(CLIST__OWNER_ARENA(list), list->table);
+	}
+}
+
+CLIST_API size_t CLIST(seg_count) (const CLIST(seg) *list) {
+	CLIST_ASSERT(list != NULL);
+	return list->count;
+}
+
+CLIST_API bool CLIST(seg_empty) (const CLIST(seg) *list) {
+	CLIST_ASSERT(list != NULL);
+	return list->count == 0;
+}
+
+/* allocates one more block, growing the block table if needed */
+CLIST_API int CLIST(seg_expand) (CLIST(seg) *list) {
+	CLIST(type) *block;
+
+	CLIST_ASSERT(list != NULL);
+
+	if (CLIST_UNLIKELY(list->blocks == list->table_size)) {
+		size_t new_size = list->table_size ? list->table_size * CLIST_BLOCK_GROWTH_RATE : CLIST_BLOCK_GROWTH_RATE;
+
+		if (CLIST_UNLIKELY(new_size > CLIST_MAX_INDEX / sizeof(CLIST(type) *))) {
+			errno = ENOMEM;
+			return 1;
+		}
+
+		if (list->table == NULL) {
+			list->table = (CLIST(type) **) CLIST__PRIVATE(owned_alloc)(
+				CLIST__OWNER_ARENA(list),
+				CLIST__OWNER_STATS(list),
+				new_size * sizeof(CLIST(type) *),
+				false
+			);
+			if (CLIST_UNLIKELY(list->table == NULL)) {
+				/* errno already set */
+				return 1;
+			}
+		} else if (CLIST_UNLIKELY(CLIST__PRIVATE(owned_realloc)(
+			CLIST__OWNER_ARENA(list),
+			CLIST__OWNER_STATS(list),
+			(void **) &list->table,
+			list->table_size * sizeof(CLIST(type) *),
+			new_size * sizeof(CLIST(type) *)
+		) != 0)) {
+			/* errno already set */
+			return 1;
+		}
+
+		list->table_size = new_size;
+	}
+
+	block = (CLIST(type) *) CLIST__PRIVATE(owned_alloc)(
+		CLIST__OWNER_ARENA(list),
+		CLIST__OWNER_STATS(list),
+		CLIST_BLOCK_SIZE_BYTES,
+		false
+	);
+	if (CLIST_UNLIKELY(block == NULL)) {
+		/* errno already set */
+		return 1;
+	}
+
+	list->table[list->blocks++] = block;
+
+	CLIST_STAT(list, expansions, 1);
+#ifdef CLIST_STATS
+	if (list->blocks * CLIST_BLOCK_SIZE > list->stats.peak_capacity) {
+		list->stats.peak_capacity = list->blocks * CLIST_BLOCK_SIZE;
+	}
+#endif
+	return 0;
+}
+
+CLIST_API CLIST(type) CLIST_REF_PTR CLIST(seg_get) (const CLIST(seg) *list, size_t index) {
+	CLIST_ASSERT(list != NULL);
+	CLIST_ASSERT(index < list->count);
+	return CLIST_REF_ADDROF list->table[index / CLIST_BLOCK_SIZE][index % CLIST_BLOCK_SIZE];
+}
+
+CLIST_API size_t CLIST(seg_add) (CLIST(seg) *list, const CLIST(type) CLIST_REF val) {
+	size_t idx;
+	CLIST(type) *slot;
+
+	CLIST_ASSERT(list != NULL);
+
+	idx = list->count;
+
+	if (CLIST_UNLIKELY(idx >= CLIST_MAX_INDEX)) {
+		errno = EOVERFLOW;
+		return CLIST_ERR;
+	}
+
+	if (CLIST_UNLIKELY(idx / CLIST_BLOCK_SIZE == list->blocks)) {
+		if (CLIST_UNLIKELY(CLIST(seg_expand)(list) != 0)) {
+			return CLIST_ERR;
+		}
+	}
+
+	slot = &list->table[idx / CLIST_BLOCK_SIZE][idx % CLIST_BLOCK_SIZE];
+
+#ifdef __cplusplus
+	new (slot) CLIST(type)(val);
+#else
+	*slot = val;
+#endif
+
+	list->count = idx + 1;
+	CLIST_STAT(list, adds, 1);
+	return idx;
+}
+
+/* removes the last element and returns it; its block is kept around */
+CLIST_API CLIST(type) CLIST(seg_pop) (CLIST(seg) *list) {
+	CLIST_ASSERT(list != NULL);
+	CLIST_ASSERT(list->count > 0);
+
+#ifdef __cplusplus
+	--list->count;
+	CLIST(type) val(std::move(list->table[list->count / CLIST_BLOCK_SIZE][list->count % CLIST_BLOCK_SIZE]));
+	list->table[list->count / CLIST_BLOCK_SIZE][list->count % CLIST_BLOCK_SIZE].~CLIST(type)();
+	return val;
+#else
+	--list->count;
+	return list->table[list->count / CLIST_BLOCK_SIZE][list->count % CLIST_BLOCK_SIZE];
+#endif
+}
@@ -0,0 +1,185 @@
+/*
+	Sharded builders - included by clist_type.h when CLIST_SHARDED
+	is defined. Do not include this file directly.
+
+	      #define CLIST_SHARDED
+	      #define CLIST_PARALLEL // optional; merges in parallel
+	      #define CLIST_TYPE struct row
+	      #define CLIST_NAME row
+	      #include "clist_type.h"
+
+	      clist_row_sharded B;
+	      clist_row_sharded_init(&B, n_threads);
+
+	      // thread `t`, no locking
+	      clist_row_add(clist_row_sharded_shard(&B, t), row);
+
+	      // once every thread is done
+	      clist_row_sharded_merge(&B, &all_rows);
+	      clist_row_sharded_free(&B);
+
+	A clist_NAME_sharded is a set of ordinary lists, one per thread,
+	each on its own cache lines so that threads filling their own shard
+	never touch each other's. Shards are plain lists, so they can be
+	read in place without merging them at all:
+
+	      for (t = 0; t < B.n_shards; t++) {
+	          clist_row *shard = clist_row_sharded_shard(&B, t);
+	          ...
+	      }
+
+	clist_NAME_sharded_merge() appends every shard to a list in shard
+	order. It makes room for all of them with a single reserve() and
+	then copies each shard into place with one memcpy() (on the thread
+	pool with CLIST_PARALLEL), leaving the shards empty but with their
+	capacity intact for the next round.
+*/
+
+#ifndef CLIST_SHARDED_H__
+#define CLIST_SHARDED_H__
+
+#ifndef CLIST_SHARD_CACHE_LINE
+#	define CLIST_SHARD_CACHE_LINE 64
+#endif
+#endif
+
+/* see header comment - DO NOT PRAGMA ONCE OR INCLUDE GUARD! */
+
+/* cache line aligned, so that no two shards share a line */
+typedef struct CLIST(shard) {
+	CLIST_ALIGNAS(CLIST_SHARD_CACHE_LINE) CLIST_T list;
+	size_t merge_offset; /* where sharded_merge() puts this shard */
+} CLIST(shard);
+
+typedef struct CLIST(sharded) {
+	size_t n_shards;
+	CLIST(shard) *shards;
+} CLIST(sharded);
+
+typedef struct CLIST(sharded_task) {
+	CLIST(shard) *shards;
+	CLIST(type) *dest;
+} CLIST(sharded_task);
+
+/* returns 0 on success, or 1 with errno set */
+CLIST_API int CLIST(sharded_init) (CLIST(sharded) *builder, size_t n_shards) {
+	size_t i;
+
+	CLIST_ASSERT(builder != NULL);
+	CLIST_ASSERT(n_shards > 0);
+
+	if (CLIST_UNLIKELY(n_shards > CLIST_MAX_INDEX / sizeof(CLIST(shard)))) {
+		errno = ENOMEM;
+		return 1;
+	}
+
+	/* CLIST_ALLOC() only has to align for the elements */
+	builder->shards = (CLIST(shard) *) clist__alloc_aligned(n_shards * sizeof(CLIST(shard)), CLIST_SHARD_CACHE_LINE);
+	if (CLIST_UNLIKELY(builder->shards == NULL)) {
+		/* errno already set */
+		return 1;
+	}
+
+	builder->n_shards = n_shards;
+	for (i = 0; i < n_shards; i++) {
+		CLIST(init)(&builder->shards[i].list);
+	}
+
+	return 0;
+}
+
+CLIST_API void CLIST(sharded_free) (CLIST(sharded) *builder) {
+	size_t i;
+
+	CLIST_ASSERT(builder != NULL);
+
+	for (i = 0; i < builder->n_shards; i++) {
+#ifdef __cplusplus
+		CLIST(clear)(&builder->shards[i].list);
+#endif
+		CLIST(free)(&builder->shards[i].list);
+	}
+
+	clist__free(builder->shards);
+	builder->n_shards = 0;
+	builder->shards = NULL;
+}
+
+CLIST_API CLIST_T *CLIST(sharded_shard) (const CLIST(sharded) *builder, size_t shard) {
+	CLIST_ASSERT(builder != NULL);
+	CLIST_ASSERT(shard < builder->n_shards);
+	return &builder->shards[shard].list;
+}
+
+/* the number of elements across all shards */
+CLIST_API size_t CLIST(sharded_count) (const CLIST(sharded) *builder) {
+	size_t count = 0;
+	size_t i;
+
+	CLIST_ASSERT(builder != NULL);
+
+	for (i = 0; i < builder->n_shards; i++) {
+		count += builder->shards[i].list.count;
+	}
+
+	return count;
+}
+
+CLIST_API void CLIST(sharded_merge_shard) (void *task_ptr, size_t shard_idx) {
+	CLIST(sharded_task) *task = (CLIST(sharded_task) *) task_ptr;
+	CLIST(shard) *shard = &task->shards[shard_idx];
+
+#ifdef __cplusplus
+	CLIST(relocate)(task->dest + shard->merge_offset, shard->list.block, shard->list.count);
+#else
+	CLIST_MEMCPY((void *) (task->dest + shard->merge_offset), shard->list.block, shard->list.count * sizeof(CLIST(type)));
+#endif
+
+	/* the elements belong to `dest` now */
+	shard->list.count = 0;
+}
+
+/* moves the elements of every shard onto the end of `dest`, in shard
+   order. returns 0 on success, or 1 with errno set, in which case
+   neither `dest` nor the shards are changed. */
+CLIST_API int CLIST(sharded_merge) (CLIST(sharded) *builder, CLIST_T *dest) {
+	CLIST(sharded_task) task;
+	size_t total = 0;
+	size_t i;
+
+	CLIST_ASSERT(builder != NULL);
+	CLIST_ASSERT(dest != NULL);
+
+	for (i = 0; i < builder->n_shards; i++) {
+		CLIST(shard) *shard = &builder->shards[i];
+
+		CLIST_ASSERT(&shard->list != dest);
+
+		shard->merge_offset = total;
+		total += shard->list.count;
+	}
+
+	if (CLIST_UNLIKELY(total > CLIST_MAX_INDEX - dest->count)) {
+		errno = EOVERFLOW;
+		return 1;
+	}
+
+	if (CLIST_UNLIKELY(CLIST(reserve)(dest, dest->count + total) != 0)) {
+		/* errno already set */
+		return 1;
+	}
+
+	task.shards = builder->shards;
+	task.dest = dest->block + dest->count;
+
+#ifdef CLIST_PARALLEL
+	clist__parallel_run(&CLIST(sharded_merge_shard), &task, builder->n_shards);
+#else
+	for (i = 0; i < builder->n_shards; i++) {
+		CLIST(sharded_merge_shard)(&task, i);
+	}
+#endif
+
+	dest->count += total;
+	return 0;
+}
@@ -0,0 +1,405 @@
+/*
+	Shared memory lists - included by clist_type.h when CLIST_SHM is
+	defined. Do not include this file directly.
+
+	      #define _POSIX_C_SOURCE 200112L
+	      #define CLIST_SHM
+	      #define CLIST_TYPE struct sample
+	      #define CLIST_NAME sample
+	      #include "clist_type.h"
+
+	      // the one writing process
+	      clist_sample_shm S;
+	      clist_sample_shm_create(&S, "/samples", 0);
+	      clist_sample_shm_add(&S, sample);
+	      ...
+	      clist_sample_shm_detach(&S);
+	      shm_unlink("/samples");
+
+	      // any number of reading processes
+	      clist_sample_shm S;
+	      clist_sample_shm_attach(&S, "/samples");
+	      n = clist_sample_shm_count(&S);
+	      for (i = 0; i < n; i++) {
+	          struct sample *s = clist_sample_shm_get(&S, i);
+	          ...
+	      }
+	      clist_sample_shm_detach(&S);
+
+	A clist_NAME_shm is a list whose elements live in a named POSIX
+	shared memory segment (shm_open(3) + mmap(2)), so that other
+	processes can read it in place without anything being copied or
+	serialized. One process creates the segment and appends to it;
+	any number of others attach read-only.
+
+	The segment starts with a small header that only holds sizes and
+	offsets (never pointers, since every process maps the segment at a
+	different address), followed by the elements. Growing enlarges the
+	segment with ftruncate(2) and remaps it in the writer; elements
+	never move within the segment and it never shrinks, so readers'
+	mappings stay valid. clist_NAME_shm_count() remaps a reader's view
+	whenever the writer has grown past it, so the pointers a process
+	got from clist_NAME_shm_get() are only valid until its next
+	clist_NAME_shm_count() (or, in the writer, clist_NAME_shm_add()).
+
+	clist_NAME_shm_view() fills in a CLIST_T over the elements counted
+	so far, for use with anything that only reads a list (sums, finds,
+	bsearch...); never add to it, remove from it or free it.
+
+	Only for element types without pointers in them; under C++ the type
+	has to be trivially copyable. Needs _POSIX_C_SOURCE >= 200112L (or
+	_GNU_SOURCE) defined before any system header, and -lrt on older
+	glibc.
+*/
+
+#ifndef CLIST_SHM_H__
+#define CLIST_SHM_H__
+
+#ifndef CLIST_CORE_HAS_UNISTD
+#	error "CLIST_SHM needs POSIX shared memory"
+#endif
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__GLIBC__) && !defined(__USE_XOPEN2K)
+#	error "CLIST_SHM needs ftruncate(2) - define _POSIX_C_SOURCE 200112L before including any system header"
+#endif
+
+/* "CLISTSHM", written last so that readers never see half a header */
+#define CLIST_SHM_MAGIC UINT64_C(0x4D48535453494C43)
+#define CLIST_SHM_VERSION 1
+
+typedef struct clist_shm_header {
+	uint64_t magic;
+	uint32_t version;
+	uint32_t reserved;
+	uint64_t elem_size;
+	uint64_t alignment;
+	uint64_t data_offset; /* from the start of the segment */
+	uint64_t size; /* of the whole segment; published before count */
+	uint64_t count; /* published with release */
+	uint64_t reserved2;
+} clist_shm_header;
+
+typedef char clist__shm_header_size[sizeof(clist_shm_header) == 64 ? 1 : -1];
+
+/* maps `size` bytes of `fd` in place of `*map` (which may be NULL),
+   leaving the old mapping alone on failure */
+CLIST_HELPER int clist__shm_remap(int fd, void **map, size_t old_size, size_t size, int writable) {
+	void *new_map = mmap(NULL, size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+
+	if (CLIST_UNLIKELY(new_map == MAP_FAILED)) {
+		/* errno already set */
+		return 1;
+	}
+
+	if (*map != NULL) {
+		(void) munmap(*map, old_size);
+	}
+
+	*map = new_map;
+	return 0;
+}
+#endif
+
+/* see header comment - DO NOT PRAGMA ONCE OR INCLUDE GUARD! */
+
+#ifdef __cplusplus
+#	define CLIST_SHM_ELEM_ALIGN alignof(CLIST(type))
+#else
+typedef struct CLIST(shm_align_probe) {
+	char c;
+	CLIST(type) elem;
+} CLIST(shm_align_probe);
+#	define CLIST_SHM_ELEM_ALIGN offsetof(CLIST(shm_align_probe), elem)
+#endif
+
+/* the elements line up like those of any other list of the type */
+#ifdef CLIST_ALIGNMENT
+#	define CLIST_SHM_ALIGN (CLIST_SHM_ELEM_ALIGN > CLIST_ALIGNMENT ? CLIST_SHM_ELEM_ALIGN : (size_t) CLIST_ALIGNMENT)
+#else
+#	define CLIST_SHM_ALIGN CLIST_SHM_ELEM_ALIGN
+#endif
+
+typedef struct CLIST(shm) {
+	clist_shm_header *header; /* the start of this process' mapping */
+	size_t map_size;
+	int fd;
+	int writer;
+} CLIST(shm);
+
+#define CLIST_SHM_ELEMS(shm) ((CLIST(type) *) (void *) ((char *) (shm)->header + (shm)->header->data_offset))
+
+/* how many elements fit in the part of the segment this process has mapped */
+CLIST_API size_t CLIST(shm_capacity) (const CLIST(shm) *shm) {
+	CLIST_ASSERT(shm != NULL);
+	return (shm->map_size - (size_t) shm->header->data_offset) / sizeof(CLIST(type));
+}
+
+/* creates the segment `name` (which should start with a slash) with
+   room for at least `capacity` elements. fails with EEXIST if it
+   already exists. returns 0 on success, or 1 with errno set. */
+CLIST_API int CLIST(shm_create) (CLIST(shm) *shm, const char *name, size_t capacity) {
+	clist_shm_header *header;
+	size_t data_offset;
+	size_t size;
+	size_t pgsz;
+	void *map = NULL;
+	int fd;
+
+#ifdef __cplusplus
+	static_assert(std::is_trivially_copyable<CLIST(type)>::value, "elements are shared between processes as raw bytes");
+#endif
+
+	CLIST_ASSERT(shm != NULL);
+	CLIST_ASSERT(name != NULL);
+
+	data_offset = CLIST_SHM_ALIGN > sizeof(clist_shm_header) ? CLIST_SHM_ALIGN : sizeof(clist_shm_header);
+
+	if (CLIST_UNLIKELY(capacity > (CLIST_MAX_INDEX - data_offset) / sizeof(CLIST(type)))) {
+		errno = ENOMEM;
+		return 1;
+	}
+
+	CLIST_PAGE_SIZE(&pgsz);
+	size = CLIST_PAGE_ROUND(data_offset + capacity * sizeof(CLIST(type)), pgsz);
+
+	fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0644);
+	if (CLIST_UNLIKELY(fd < 0)) {
+		/* errno already set */
+		return 1;
+	}
+
+	if (CLIST_UNLIKELY(ftruncate(fd, (off_t) size) != 0 || clist__shm_remap(fd, &map, 0, size, 1) != 0)) {
+		int err = errno;
+		(void) close(fd);
+		(void) shm_unlink(name);
+		errno = err;
+		return 1;
+	}
+
+	/* the rest is zero already */
+	header = (clist_shm_header *) map;
+	header->version = CLIST_SHM_VERSION;
+	header->elem_size = sizeof(CLIST(type));
+	header->alignment = CLIST_SHM_ALIGN;
+	header->data_offset = data_offset;
+	header->size = size;
+	__atomic_store_n(&header->magic, CLIST_SHM_MAGIC, __ATOMIC_RELEASE);
+
+	shm->header = header;
+	shm->map_size = size;
+	shm->fd = fd;
+	shm->writer = 1;
+	return 0;
+}
+
+/* attaches read-only to the segment `name`. returns 0 on success, or 1
+   with errno set: EINVAL if it isn't a list of this type, EAGAIN if
+   its writer hasn't finished creating it yet. */
+CLIST_API int CLIST(shm_attach) (CLIST(shm) *shm, const char *name) {
+	clist_shm_header *header;
+	struct stat st;
+	void *map = NULL;
+	int fd;
+
+	CLIST_ASSERT(shm != NULL);
+	CLIST_ASSERT(name != NULL);
+
+	fd = shm_open(name, O_RDONLY, 0);
+	if (CLIST_UNLIKELY(fd < 0)) {
+		/* errno already set */
+		return 1;
+	}
+
+	if (CLIST_UNLIKELY(fstat(fd, &st) != 0)) {
+		(void) close(fd);
+		return 1;
+	}
+
+	if (CLIST_UNLIKELY((uint64_t) st.st_size < sizeof(clist_shm_header))) {
+		/* created but not sized yet */
+		(void) close(fd);
+		errno = EAGAIN;
+		return 1;
+	}
+
+	if (CLIST_UNLIKELY(clist__shm_remap(fd, &map, 0, (size_t) st.st_size, 0) != 0)) {
+		(void) close(fd);
+		return 1;
+	}
+
+	header = (clist_shm_header *) map;
+
+	if (CLIST_UNLIKELY(__atomic_load_n(&header->magic, __ATOMIC_ACQUIRE) != CLIST_SHM_MAGIC)) {
+		(void) munmap(map, (size_t) st.st_size);
+		(void) close(fd);
+		errno = header->magic == 0 ? EAGAIN : EINVAL;
+		return 1;
+	}
+
+	if (CLIST_UNLIKELY(header->version != CLIST_SHM_VERSION
+		|| header->elem_size != sizeof(CLIST(type))
+		|| header->alignment != CLIST_SHM_ALIGN
+		|| header->data_offset < sizeof(clist_shm_header)
+		|| header->data_offset > (uint64_t) st.st_size
+	)) {
+		(void) munmap(map, (size_t) st.st_size);
+		(void) close(fd);
+		errno = EINVAL;
+		return 1;
+	}
+
+	shm->header = header;
+	shm->map_size = (size_t) st.st_size;
+	shm->fd = fd;
+	shm->writer = 0;
+	return 0;
+}
+
+/* unmaps the segment in this process; the segment itself stays around
+   until someone shm_unlink(3)s it */
+CLIST_API void CLIST(shm_detach) (CLIST(shm) *shm) {
+	CLIST_ASSERT(shm != NULL);
+
+	(void) munmap(shm->header, shm->map_size);
+	(void) close(shm->fd);
+
+	shm->header = NULL;
+	shm->map_size = 0;
+	shm->fd = -1;
+}
+
+/* the number of elements that can be read. in readers, remaps the
+   segment first if the writer has grown it past what's mapped; if that
+   fails, only the elements that are mapped are counted. */
+CLIST_API size_t CLIST(shm_count) (CLIST(shm) *shm) {
+	size_t count;
+
+	CLIST_ASSERT(shm != NULL);
+
+	count = (size_t) __atomic_load_n(&shm->header->count, __ATOMIC_ACQUIRE);
+
+	if (CLIST_UNLIKELY(count > CLIST(shm_capacity)(shm))) {
+		/* the size was published before the count, so it covers it */
+		size_t size = (size_t) __atomic_load_n(&shm->header->size, __ATOMIC_ACQUIRE);
+		void *map = shm->header;
+
+		if (CLIST_UNLIKELY(clist__shm_remap(shm->fd, &map, shm->map_size, size, shm->writer) != 0)) {
+			return CLIST(shm_capacity)(shm);
+		}
+
+		shm->header = (clist_shm_header *) map;
+		shm->map_size = size;
+	}
+
+	return count;
+}
+
+/* `index` has to be below a count this process has read */
+CLIST_API CLIST(type) *CLIST(shm_get) (const CLIST(shm) *shm, size_t index) {
+	CLIST_ASSERT(shm != NULL);
+	CLIST_ASSERT(index < CLIST(shm_capacity)(shm));
+	return &CLIST_SHM_ELEMS(shm)[index];
+}
+
+/* points `view` at the elements counted so far; see the header comment */
+CLIST_API void CLIST(shm_view) (CLIST(shm) *shm, CLIST_T *view) {
+	size_t count;
+
+	CLIST_ASSERT(shm != NULL);
+	CLIST_ASSERT(view != NULL);
+
+	count = CLIST(shm_count)(shm);
+
+	CLIST(init)(view);
+	view->block = CLIST_SHM_ELEMS(shm);
+	view->count = count;
+	view->capacity = count;
+}
+
+/* writer only - makes room for at least `n_elems` elements. returns 0
+   on success, or 1 with errno set. */
+CLIST_API int CLIST(shm_reserve) (CLIST(shm) *shm, size_t n_elems) {
+	size_t capacity;
+	size_t size;
+	size_t pgsz;
+	void *map;
+
+	CLIST_ASSERT(shm != NULL);
+	CLIST_ASSERT(shm->writer);
+
+	capacity = CLIST(shm_capacity)(shm);
+	if (n_elems <= capacity) {
+		return 0;
+	}
+
+	if (CLIST_UNLIKELY(clist__grow_capacity(
+		capacity,
+		n_elems,
+		sizeof(CLIST(type)),
+		CLIST_BLOCK_SIZE,
+		CLIST_BLOCK_GROWTH_RATE,
+		&capacity
+	) != 0)) {
+		return 1;
+	}
+
+	if (CLIST_UNLIKELY(capacity > (CLIST_MAX_INDEX - (size_t) shm->header->data_offset) / sizeof(CLIST(type)))) {
+		errno = ENOMEM;
+		return 1;
+	}
+
+	CLIST_PAGE_SIZE(&pgsz);
+	size = CLIST_PAGE_ROUND((size_t) shm->header->data_offset + capacity * sizeof(CLIST(type)), pgsz);
+
+	if (CLIST_UNLIKELY(ftruncate(shm->fd, (off_t) size) != 0)) {
+		/* errno already set */
+		return 1;
+	}
+
+	map = shm->header;
+	if (CLIST_UNLIKELY(clist__shm_remap(shm->fd, &map, shm->map_size, size, 1) != 0)) {
+		/* the segment is bigger now but nobody's been told, which is fine */
+		return 1;
+	}
+
+	shm->header = (clist_shm_header *) map;
+	shm->map_size = size;
+	__atomic_store_n(&shm->header->size, (uint64_t) size, __ATOMIC_RELEASE);
+	return 0;
+}
+
+/* writer only - returns the new element's index, or CLIST_ERR with errno set */
+CLIST_API size_t CLIST(shm_add) (CLIST(shm) *shm, const CLIST(type) CLIST_REF val) {
+	size_t idx;
+
+	CLIST_ASSERT(shm != NULL);
+	CLIST_ASSERT(shm->writer);
+
+	idx = (size_t) shm->header->count; /* only this process writes it */
+
+	if (CLIST_UNLIKELY(idx == CLIST(shm_capacity)(shm))) {
+		if (CLIST_UNLIKELY(idx >= CLIST_MAX_INDEX)) {
+			errno = EOVERFLOW;
+			return CLIST_ERR;
+		}
+
+		if (CLIST_UNLIKELY(CLIST(shm_reserve)(shm, idx + 1) != 0)) {
+			/* errno already set */
+			return CLIST_ERR;
+		}
+	}
+
+	CLIST_SHM_ELEMS(shm)[idx] = val;
+	__atomic_store_n(&shm->header->count, (uint64_t) idx + 1, __ATOMIC_RELEASE);
+	return idx;
+}
+
+#undef CLIST_SHM_ELEMS
+#undef CLIST_SHM_ALIGN
+#undef CLIST_SHM_ELEM_ALIGN
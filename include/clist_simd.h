@@ -0,0 +1,633 @@
+#ifndef CLIST_SIMD_H__
+#define CLIST_SIMD_H__
+#pragma once
+/*
+	vectorized reduction and search kernels over plain arrays of numbers,
+	used by the clist_NAME_sum/minmax/find/count_eq functions that
+	clist_type.h generates when CLIST_KIND is defined.
+
+	kinds (element types):
+
+	      i32 - int32_t     sums into an int64_t
+	      u32 - uint32_t    sums into a uint64_t
+	      i64 - int64_t     sums into an int64_t (wrapping)
+	      u64 - uint64_t    sums into a uint64_t (wrapping)
+	      f32 - float       sums into a float
+	      f64 - double      sums into a double
+	      ptr - any pointer compared/summed as a uintptr_t
+
+	on x86 the SSE2 kernels are used as the baseline and the AVX2 ones
+	are picked at runtime if the CPU supports them. elsewhere (or with
+	CLIST_NO_SIMD defined) the plain loops are used.
+
+	NOTE: floating point sums are added up in several lanes at once, so
+	      they may round differently than a sequential loop would.
+	      minmax() results are unspecified if the elements contain NaNs.
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "./clist_core.h"
+
+#if !defined(CLIST_NO_SIMD) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#	define CLIST_SIMD_SSE2 1
+#	if defined(__clang__) || CLIST_GCC_VERSION >= 40900
+		/* compiled with the target attribute, called only after checking the CPU */
+#		define CLIST_SIMD_AVX2 1
+#	else
+#		define CLIST_SIMD_AVX2 0
+#	endif
+#	include <immintrin.h>
+#else
+#	define CLIST_SIMD_SSE2 0
+#	define CLIST_SIMD_AVX2 0
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+	/* CLIST_SIMD(sum, i32) -> clist__sum_i32 */
+#define CLIST_SIMD(thing, kind) CLIST_SIMD_(thing, kind)
+#define CLIST_SIMD_(thing, kind) clist__##thing##_##kind
+
+#ifdef __GNUC__
+	/* pointer lists are read through these */
+#	define CLIST_SIMD_MAY_ALIAS __attribute__((__may_alias__))
+#else
+#	define CLIST_SIMD_MAY_ALIAS
+#endif
+
+typedef uint32_t CLIST_SIMD_MAY_ALIAS clist__u32;
+typedef uint64_t CLIST_SIMD_MAY_ALIAS clist__u64;
+
+typedef int32_t clist__elem_t_i32;
+typedef clist__u32 clist__elem_t_u32;
+typedef int64_t clist__elem_t_i64;
+typedef clist__u64 clist__elem_t_u64;
+typedef float clist__elem_t_f32;
+typedef double clist__elem_t_f64;
+
+typedef int64_t clist__sum_t_i32;
+typedef uint64_t clist__sum_t_u32;
+typedef int64_t clist__sum_t_i64;
+typedef uint64_t clist__sum_t_u64;
+typedef float clist__sum_t_f32;
+typedef double clist__sum_t_f64;
+
+/*
+	plain loops - the fallback, and what finishes off the elements
+	that don't fill a whole vector
+*/
+
+#define CLIST_SIMD_SCALAR_KERNELS(kind, acc_type) \
+	CLIST_HELPER clist__sum_t_##kind clist__sum_##kind##_scalar(const clist__elem_t_##kind *vals, size_t n_elems) { \
+		acc_type acc = 0; \
+		size_t i; \
+		for (i = 0; i < n_elems; i++) { \
+			acc += (acc_type) vals[i]; \
+		} \
+		return (clist__sum_t_##kind) acc; \
+	} \
+	CLIST_HELPER void clist__minmax_##kind##_scalar(const clist__elem_t_##kind *vals, size_t n_elems, clist__elem_t_##kind *min_out, clist__elem_t_##kind *max_out) { \
+		clist__elem_t_##kind min = *min_out; \
+		clist__elem_t_##kind max = *max_out; \
+		size_t i; \
+		for (i = 0; i < n_elems; i++) { \
+			if (vals[i] < min) min = vals[i]; \
+			if (vals[i] > max) max = vals[i]; \
+		} \
+		*min_out = min; \
+		*max_out = max; \
+	} \
+	CLIST_HELPER size_t clist__find_##kind##_scalar(const clist__elem_t_##kind *vals, size_t n_elems, clist__elem_t_##kind val) { \
+		size_t i; \
+		for (i = 0; i < n_elems; i++) { \
+			if (vals[i] == val) return i; \
+		} \
+		return CLIST_ERR; \
+	} \
+	CLIST_HELPER size_t clist__count_eq_##kind##_scalar(const clist__elem_t_##kind *vals, size_t n_elems, clist__elem_t_##kind val) { \
+		size_t count = 0; \
+		size_t i; \
+		for (i = 0; i < n_elems; i++) { \
+			count += vals[i] == val; \
+		} \
+		return count; \
+	}
+
+/* minmax() kernels are always handed the running min/max in *min_out and *max_out */
+CLIST_SIMD_SCALAR_KERNELS(i32, int64_t)
+CLIST_SIMD_SCALAR_KERNELS(u32, uint64_t)
+CLIST_SIMD_SCALAR_KERNELS(i64, uint64_t)
+CLIST_SIMD_SCALAR_KERNELS(u64, uint64_t)
+CLIST_SIMD_SCALAR_KERNELS(f32, float)
+CLIST_SIMD_SCALAR_KERNELS(f64, double)
+
+#if CLIST_SIMD_SSE2
+/*
+	SSE2 - always there on x86_64. it has no 32/64-bit integer min/max,
+	so those stay with the plain loops (which the compiler vectorizes
+	about as well).
+*/
+
+CLIST_HELPER int64_t clist__sum_i32_sse2(const int32_t *vals, size_t n_elems) {
+	__m128i acc = _mm_setzero_si128();
+	uint64_t lanes[2];
+	size_t i;
+
+	for (i = 0; i + 4 <= n_elems; i += 4) {
+		__m128i v = _mm_loadu_si128((const __m128i *) (vals + i));
+		__m128i sign = _mm_srai_epi32(v, 31);
+		acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(v, sign));
+		acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(v, sign));
+	}
+
+	_mm_storeu_si128((__m128i *) lanes, acc);
+	return (int64_t) (lanes[0] + lanes[1]) + clist__sum_i32_scalar(vals + i, n_elems - i);
+}
+
+CLIST_HELPER uint64_t clist__sum_u32_sse2(const clist__u32 *vals, size_t n_elems) {
+	__m128i acc = _mm_setzero_si128();
+	__m128i zero = _mm_setzero_si128();
+	uint64_t lanes[2];
+	size_t i;
+
+	for (i = 0; i + 4 <= n_elems; i += 4) {
+		__m128i v = _mm_loadu_si128((const __m128i *) (vals + i));
+		acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(v, zero));
+		acc = _mm_add_epi64(acc, _mm_unpackhi_epi32(v, zero));
+	}
+
+	_mm_storeu_si128((__m128i *) lanes, acc);
+	return lanes[0] + lanes[1] + clist__sum_u32_scalar(vals + i, n_elems - i);
+}
+
+CLIST_HELPER uint64_t clist__sum_u64_sse2(const clist__u64 *vals, size_t n_elems) {
+	__m128i acc0 = _mm_setzero_si128();
+	__m128i acc1 = _mm_setzero_si128();
+	uint64_t lanes[2];
+	size_t i;
+
+	for (i = 0; i + 4 <= n_elems; i += 4) {
+		acc0 = _mm_add_epi64(acc0, _mm_loadu_si128((const __m128i *) (vals + i)));
+		acc1 = _mm_add_epi64(acc1, _mm_loadu_si128((const __m128i *) (vals + i + 2)));
+	}
+
+	_mm_storeu_si128((__m128i *) lanes, _mm_add_epi64(acc0, acc1));
+	return lanes[0] + lanes[1] + clist__sum_u64_scalar(vals + i, n_elems - i);
+}
+
+CLIST_HELPER float clist__sum_f32_sse2(const float *vals, size_t n_elems) {
+	__m128 acc0 = _mm_setzero_ps();
+	__m128 acc1 = _mm_setzero_ps();
+	float lanes[4];
+	size_t i;
+
+	for (i = 0; i + 8 <= n_elems; i += 8) {
+		acc0 = _mm_add_ps(acc0, _mm_loadu_ps(vals + i));
+		acc1 = _mm_add_ps(acc1, _mm_loadu_ps(vals + i + 4));
+	}
+
+	_mm_storeu_ps(lanes, _mm_add_ps(acc0, acc1));
+	return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]) + clist__sum_f32_scalar(vals + i, n_elems - i);
+}
+
+CLIST_HELPER double clist__sum_f64_sse2(const double *vals, size_t n_elems) {
+	__m128d acc0 = _mm_setzero_pd();
+	__m128d acc1 = _mm_setzero_pd();
+	double lanes[2];
+	size_t i;
+
+	for (i = 0; i + 4 <= n_elems; i += 4) {
+		acc0 = _mm_add_pd(acc0, _mm_loadu_pd(vals + i));
+		acc1 = _mm_add_pd(acc1, _mm_loadu_pd(vals + i + 2));
+	}
+
+	_mm_storeu_pd(lanes, _mm_add_pd(acc0, acc1));
+	return lanes[0] + lanes[1] + clist__sum_f64_scalar(vals + i, n_elems - i);
+}
+
+CLIST_HELPER void clist__minmax_f32_sse2(const float *vals, size_t n_elems, float *min_out, float *max_out) {
+	__m128 min = _mm_set1_ps(*min_out);
+	__m128 max = _mm_set1_ps(*max_out);
+	float lanes[4];
+	size_t i;
+
+	for (i = 0; i + 4 <= n_elems; i += 4) {
+		__m128 v = _mm_loadu_ps(vals + i);
+		min = _mm_min_ps(min, v);
+		max = _mm_max_ps(max, v);
+	}
+
+	_mm_storeu_ps(lanes, min);
+	clist__minmax_f32_scalar(lanes, 4, min_out, max_out);
+	_mm_storeu_ps(lanes, max);
+	clist__minmax_f32_scalar(lanes, 4, min_out, max_out);
+	clist__minmax_f32_scalar(vals + i, n_elems - i, min_out, max_out);
+}
+
+CLIST_HELPER void clist__minmax_f64_sse2(const double *vals, size_t n_elems, double *min_out, double *max_out) {
+	__m128d min = _mm_set1_pd(*min_out);
+	__m128d max = _mm_set1_pd(*max_out);
+	double lanes[2];
+	size_t i;
+
+	for (i = 0; i + 2 <= n_elems; i += 2) {
+		__m128d v = _mm_loadu_pd(vals + i);
+		min = _mm_min_pd(min, v);
+		max = _mm_max_pd(max, v);
+	}
+
+	_mm_storeu_pd(lanes, min);
+	clist__minmax_f64_scalar(lanes, 2, min_out, max_out);
+	_mm_storeu_pd(lanes, max);
+	clist__minmax_f64_scalar(lanes, 2, min_out, max_out);
+	clist__minmax_f64_scalar(vals + i, n_elems - i, min_out, max_out);
+}
+
+#	define clist__minmax_i32_sse2 clist__minmax_i32_scalar
+#	define clist__minmax_u32_sse2 clist__minmax_u32_scalar
+#	define clist__minmax_i64_sse2 clist__minmax_i64_scalar
+#	define clist__minmax_u64_sse2 clist__minmax_u64_scalar
+
+	/* `eq` is a comparison yielding all-ones lanes on a match, `mask`
+	   turns that into one bit per lane and `to_int` reinterprets it as
+	   integer lanes of `lane_type`, which `sub` counts the matches in.
+	   the counts are folded every CLIST_SIMD_COUNT_CHUNK vectors so that
+	   32-bit lanes can't overflow. */
+#	define CLIST_SIMD_COUNT_CHUNK ((size_t) 1 << 16)
+
+#	define CLIST_SIMD_SSE2_SEARCH(kind, width, load, splat, eq, mask) \
+	CLIST_HELPER size_t clist__find_##kind##_sse2(const clist__elem_t_##kind *vals, size_t n_elems, clist__elem_t_##kind val) { \
+		size_t i; \
+		size_t idx; \
+		for (i = 0; i + (width) <= n_elems; i += (width)) { \
+			int bits = mask(eq(load(vals + i), splat(val))); \
+			if (bits != 0) return i + (size_t) __builtin_ctz((unsigned) bits); \
+		} \
+		idx = clist__find_##kind##_scalar(vals + i, n_elems - i, val); \
+		return idx == CLIST_ERR ? CLIST_ERR : i + idx; \
+	}
+
+#	define CLIST_SIMD_SSE2_COUNT(kind, width, lane_type, load, splat, eq, to_int, sub) \
+	CLIST_HELPER size_t clist__count_eq_##kind##_sse2(const clist__elem_t_##kind *vals, size_t n_elems, clist__elem_t_##kind val) { \
+		size_t count = 0; \
+		size_t i = 0; \
+		while (i + (width) <= n_elems) { \
+			__m128i acc = _mm_setzero_si128(); \
+			lane_type lanes[16 / sizeof(lane_type)]; \
+			size_t end = (n_elems - i) / (width) > CLIST_SIMD_COUNT_CHUNK ? i + CLIST_SIMD_COUNT_CHUNK * (width) : n_elems; \
+			size_t j; \
+			for (; i + (width) <= end; i += (width)) { \
+				acc = sub(acc, to_int(eq(load(vals + i), splat(val)))); \
+			} \
+			_mm_storeu_si128((__m128i *) lanes, acc); \
+			for (j = 0; j < 16 / sizeof(lane_type); j++) { \
+				count += (size_t) lanes[j]; \
+			} \
+		} \
+		return count + clist__count_eq_##kind##_scalar(vals + i, n_elems - i, val); \
+	}
+
+#	define CLIST_SIMD_LOADU_SI128(ptr) _mm_loadu_si128((const __m128i *) (ptr))
+#	define CLIST_SIMD_SET1_I32(val) _mm_set1_epi32((int) (val))
+#	define CLIST_SIMD_MASK_I32(v) _mm_movemask_ps(_mm_castsi128_ps(v))
+#	define CLIST_SIMD_MASK_I64(v) _mm_movemask_pd(_mm_castsi128_pd(v))
+
+	/* SSE2 can only compare 32 bits at a time - a 64-bit lane
+	   matches when both of its halves do */
+CLIST_HELPER __m128i clist__sse2_cmpeq_epi64(__m128i a, __m128i b) {
+	__m128i eq = _mm_cmpeq_epi32(a, b);
+	return _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+}
+
+CLIST_HELPER __m128i clist__sse2_set1_u64(uint64_t val) {
+	uint64_t lanes[2];
+	lanes[0] = lanes[1] = val;
+	return _mm_loadu_si128((const __m128i *) lanes);
+}
+
+CLIST_SIMD_SSE2_SEARCH(i32, 4, CLIST_SIMD_LOADU_SI128, CLIST_SIMD_SET1_I32, _mm_cmpeq_epi32, CLIST_SIMD_MASK_I32)
+CLIST_SIMD_SSE2_SEARCH(u32, 4, CLIST_SIMD_LOADU_SI128, CLIST_SIMD_SET1_I32, _mm_cmpeq_epi32, CLIST_SIMD_MASK_I32)
+CLIST_SIMD_SSE2_SEARCH(u64, 2, CLIST_SIMD_LOADU_SI128, clist__sse2_set1_u64, clist__sse2_cmpeq_epi64, CLIST_SIMD_MASK_I64)
+CLIST_SIMD_SSE2_SEARCH(f32, 4, _mm_loadu_ps, _mm_set1_ps, _mm_cmpeq_ps, _mm_movemask_ps)
+CLIST_SIMD_SSE2_SEARCH(f64, 2, _mm_loadu_pd, _mm_set1_pd, _mm_cmpeq_pd, _mm_movemask_pd)
+
+#	define CLIST_SIMD_SI128(v) (v) /* already integer lanes */
+CLIST_SIMD_SSE2_COUNT(i32, 4, uint32_t, CLIST_SIMD_LOADU_SI128, CLIST_SIMD_SET1_I32, _mm_cmpeq_epi32, CLIST_SIMD_SI128, _mm_sub_epi32)
+CLIST_SIMD_SSE2_COUNT(u32, 4, uint32_t, CLIST_SIMD_LOADU_SI128, CLIST_SIMD_SET1_I32, _mm_cmpeq_epi32, CLIST_SIMD_SI128, _mm_sub_epi32)
+CLIST_SIMD_SSE2_COUNT(u64, 2, uint64_t, CLIST_SIMD_LOADU_SI128, clist__sse2_set1_u64, clist__sse2_cmpeq_epi64, CLIST_SIMD_SI128, _mm_sub_epi64)
+CLIST_SIMD_SSE2_COUNT(f32, 4, uint32_t, _mm_loadu_ps, _mm_set1_ps, _mm_cmpeq_ps, _mm_castps_si128, _mm_sub_epi32)
+CLIST_SIMD_SSE2_COUNT(f64, 2, uint64_t, _mm_loadu_pd, _mm_set1_pd, _mm_cmpeq_pd, _mm_castpd_si128, _mm_sub_epi64)
+#endif
+
+#if CLIST_SIMD_AVX2
+/*
+	AVX2 - picked at runtime
+*/
+
+#	define CLIST_AVX2 __attribute__((__target__("avx2")))
+
+CLIST_HELPER CLIST_AVX2 int64_t clist__sum_i32_avx2(const int32_t *vals, size_t n_elems) {
+	__m256i acc0 = _mm256_setzero_si256();
+	__m256i acc1 = _mm256_setzero_si256();
+	uint64_t lanes[4];
+	size_t i;
+
+	for (i = 0; i + 8 <= n_elems; i += 8) {
+		__m256i v = _mm256_loadu_si256((const __m256i *) (vals + i));
+		acc0 = _mm256_add_epi64(acc0, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)));
+		acc1 = _mm256_add_epi64(acc1, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1)));
+	}
+
+	_mm256_storeu_si256((__m256i *) lanes, _mm256_add_epi64(acc0, acc1));
+	return (int64_t) (lanes[0] + lanes[1] + lanes[2] + lanes[3]) + clist__sum_i32_scalar(vals + i, n_elems - i);
+}
+
+CLIST_HELPER CLIST_AVX2 uint64_t clist__sum_u32_avx2(const clist__u32 *vals, size_t n_elems) {
+	__m256i acc0 = _mm256_setzero_si256();
+	__m256i acc1 = _mm256_setzero_si256();
+	uint64_t lanes[4];
+	size_t i;
+
+	for (i = 0; i + 8 <= n_elems; i += 8) {
+		__m256i v = _mm256_loadu_si256((const __m256i *) (vals + i));
+		acc0 = _mm256_add_epi64(acc0, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(v)));
+		acc1 = _mm256_add_epi64(acc1, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(v, 1)));
+	}
+
+	_mm256_storeu_si256((__m256i *) lanes, _mm256_add_epi64(acc0, acc1));
+	return lanes[0] + lanes[1] + lanes[2] + lanes[3] + clist__sum_u32_scalar(vals + i, n_elems - i);
+}
+
+CLIST_HELPER CLIST_AVX2 uint64_t clist__sum_u64_avx2(const clist__u64 *vals, size_t n_elems) {
+	__m256i acc0 = _mm256_setzero_si256();
+	__m256i acc1 = _mm256_setzero_si256();
+	uint64_t lanes[4];
+	size_t i;
+
+	for (i = 0; i + 8 <= n_elems; i += 8) {
+		acc0 = _mm256_add_epi64(acc0, _mm256_loadu_si256((const __m256i *) (vals + i)));
+		acc1 = _mm256_add_epi64(acc1, _mm256_loadu_si256((const __m256i *) (vals + i + 4)));
+	}
+
+	_mm256_storeu_si256((__m256i *) lanes, _mm256_add_epi64(acc0, acc1));
+	return lanes[0] + lanes[1] + lanes[2] + lanes[3] + clist__sum_u64_scalar(vals + i, n_elems - i);
+}
+
+CLIST_HELPER CLIST_AVX2 float clist__sum_f32_avx2(const float *vals, size_t n_elems) {
+	__m256 acc0 = _mm256_setzero_ps();
+	__m256 acc1 = _mm256_setzero_ps();
+	float lanes[8];
+	size_t i;
+
+	for (i = 0; i + 16 <= n_elems; i += 16) {
+		acc0 = _mm256_add_ps(acc0, _mm256_loadu_ps(vals + i));
+		acc1 = _mm256_add_ps(acc1, _mm256_loadu_ps(vals + i + 8));
+	}
+
+	_mm256_storeu_ps(lanes, _mm256_add_ps(acc0, acc1));
+	return ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]))
+		+ clist__sum_f32_scalar(vals + i, n_elems - i);
+}
+
+CLIST_HELPER CLIST_AVX2 double clist__sum_f64_avx2(const double *vals, size_t n_elems) {
+	__m256d acc0 = _mm256_setzero_pd();
+	__m256d acc1 = _mm256_setzero_pd();
+	double lanes[4];
+	size_t i;
+
+	for (i = 0; i + 8 <= n_elems; i += 8) {
+		acc0 = _mm256_add_pd(acc0, _mm256_loadu_pd(vals + i));
+		acc1 = _mm256_add_pd(acc1, _mm256_loadu_pd(vals + i + 4));
+	}
+
+	_mm256_storeu_pd(lanes, _mm256_add_pd(acc0, acc1));
+	return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]) + clist__sum_f64_scalar(vals + i, n_elems - i);
+}
+
+	/* `min`/`max` produce the lane-wise minimum/maximum of two vectors */
+#	define CLIST_SIMD_AVX2_MINMAX(kind, vec, width, load, splat, store, min, max) \
+	CLIST_HELPER CLIST_AVX2 void clist__minmax_##kind##_avx2(const clist__elem_t_##kind *vals, size_t n_elems, clist__elem_t_##kind *min_out, clist__elem_t_##kind *max_out) { \
+		vec vmin = splat(*min_out); \
+		vec vmax = splat(*max_out); \
+		clist__elem_t_##kind lanes[width]; \
+		size_t i; \
+		for (i = 0; i + (width) <= n_elems; i += (width)) { \
+			vec v = load(vals + i); \
+			vmin = min(vmin, v); \
+			vmax = max(vmax, v); \
+		} \
+		store(lanes, vmin); \
+		clist__minmax_##kind##_scalar(lanes, (width), min_out, max_out); \
+		store(lanes, vmax); \
+		clist__minmax_##kind##_scalar(lanes, (width), min_out, max_out); \
+		clist__minmax_##kind##_scalar(vals + i, n_elems - i, min_out, max_out); \
+	}
+
+#	define CLIST_SIMD_LOADU_SI256(ptr) _mm256_loadu_si256((const __m256i *) (ptr))
+#	define CLIST_SIMD_STOREU_SI256(ptr, v) _mm256_storeu_si256((__m256i *) (ptr), (v))
+#	define CLIST_SIMD_SET1_I32_256(val) _mm256_set1_epi32((int) (val))
+
+	/* there's only a signed 64-bit comparison; flipping the top bit
+	   makes it order unsigned values correctly */
+CLIST_HELPER CLIST_AVX2 __m256i clist__avx2_set1_u64(uint64_t val) {
+	uint64_t lanes[4];
+	lanes[0] = lanes[1] = lanes[2] = lanes[3] = val;
+	return _mm256_loadu_si256((const __m256i *) lanes);
+}
+
+CLIST_HELPER CLIST_AVX2 __m256i clist__avx2_set1_i64(int64_t val) {
+	return clist__avx2_set1_u64((uint64_t) val);
+}
+
+CLIST_HELPER CLIST_AVX2 __m256i clist__avx2_min_epi64(__m256i a, __m256i b) {
+	return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b));
+}
+
+CLIST_HELPER CLIST_AVX2 __m256i clist__avx2_max_epi64(__m256i a, __m256i b) {
+	return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(a, b));
+}
+
+CLIST_HELPER CLIST_AVX2 __m256i clist__avx2_flip_u64(__m256i a) {
+	return _mm256_xor_si256(a, clist__avx2_set1_u64((uint64_t) 1 << 63));
+}
+
+CLIST_HELPER CLIST_AVX2 __m256i clist__avx2_min_epu64(__m256i a, __m256i b) {
+	return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(clist__avx2_flip_u64(a), clist__avx2_flip_u64(b)));
+}
+
+CLIST_HELPER CLIST_AVX2 __m256i clist__avx2_max_epu64(__m256i a, __m256i b) {
+	return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(clist__avx2_flip_u64(a), clist__avx2_flip_u64(b)));
+}
+
+CLIST_SIMD_AVX2_MINMAX(i32, __m256i, 8, CLIST_SIMD_LOADU_SI256, CLIST_SIMD_SET1_I32_256, CLIST_SIMD_STOREU_SI256, _mm256_min_epi32, _mm256_max_epi32)
+CLIST_SIMD_AVX2_MINMAX(u32, __m256i, 8, CLIST_SIMD_LOADU_SI256, CLIST_SIMD_SET1_I32_256, CLIST_SIMD_STOREU_SI256, _mm256_min_epu32, _mm256_max_epu32)
+CLIST_SIMD_AVX2_MINMAX(i64, __m256i, 4, CLIST_SIMD_LOADU_SI256, clist__avx2_set1_i64, CLIST_SIMD_STOREU_SI256, clist__avx2_min_epi64, clist__avx2_max_epi64)
+CLIST_SIMD_AVX2_MINMAX(u64, __m256i, 4, CLIST_SIMD_LOADU_SI256, clist__avx2_set1_u64, CLIST_SIMD_STOREU_SI256, clist__avx2_min_epu64, clist__avx2_max_epu64)
+CLIST_SIMD_AVX2_MINMAX(f32, __m256, 8, _mm256_loadu_ps, _mm256_set1_ps, _mm256_storeu_ps, _mm256_min_ps, _mm256_max_ps)
+CLIST_SIMD_AVX2_MINMAX(f64, __m256d, 4, _mm256_loadu_pd, _mm256_set1_pd, _mm256_storeu_pd, _mm256_min_pd, _mm256_max_pd)
+
+	/* same as the SSE2 ones, just twice as wide */
+#	define CLIST_SIMD_AVX2_SEARCH(kind, width, load, splat, eq, mask) \
+	CLIST_HELPER CLIST_AVX2 size_t clist__find_##kind##_avx2(const clist__elem_t_##kind *vals, size_t n_elems, clist__elem_t_##kind val) { \
+		size_t i; \
+		size_t idx; \
+		for (i = 0; i + (width) <= n_elems; i += (width)) { \
+			int bits = mask(eq(load(vals + i), splat(val))); \
+			if (bits != 0) return i + (size_t) __builtin_ctz((unsigned) bits); \
+		} \
+		idx = clist__find_##kind##_scalar(vals + i, n_elems - i, val); \
+		return idx == CLIST_ERR ? CLIST_ERR : i + idx; \
+	}
+
+#	define CLIST_SIMD_AVX2_COUNT(kind, width, lane_type, load, splat, eq, to_int, sub) \
+	CLIST_HELPER CLIST_AVX2 size_t clist__count_eq_##kind##_avx2(const clist__elem_t_##kind *vals, size_t n_elems, clist__elem_t_##kind val) { \
+		size_t count = 0; \
+		size_t i = 0; \
+		while (i + (width) <= n_elems) { \
+			__m256i acc = _mm256_setzero_si256(); \
+			lane_type lanes[32 / sizeof(lane_type)]; \
+			size_t end = (n_elems - i) / (width) > CLIST_SIMD_COUNT_CHUNK ? i + CLIST_SIMD_COUNT_CHUNK * (width) : n_elems; \
+			size_t j; \
+			for (; i + (width) <= end; i += (width)) { \
+				acc = sub(acc, to_int(eq(load(vals + i), splat(val)))); \
+			} \
+			_mm256_storeu_si256((__m256i *) lanes, acc); \
+			for (j = 0; j < 32 / sizeof(lane_type); j++) { \
+				count += (size_t) lanes[j]; \
+			} \
+		} \
+		return count + clist__count_eq_##kind##_scalar(vals + i, n_elems - i, val); \
+	}
+
+#	define CLIST_SIMD_MASK_I32_256(v) _mm256_movemask_ps(_mm256_castsi256_ps(v))
+#	define CLIST_SIMD_MASK_I64_256(v) _mm256_movemask_pd(_mm256_castsi256_pd(v))
+#	define CLIST_SIMD_CMPEQ_PS(a, b) _mm256_cmp_ps((a), (b), _CMP_EQ_OQ)
+#	define CLIST_SIMD_CMPEQ_PD(a, b) _mm256_cmp_pd((a), (b), _CMP_EQ_OQ)
+
+CLIST_SIMD_AVX2_SEARCH(i32, 8, CLIST_SIMD_LOADU_SI256, CLIST_SIMD_SET1_I32_256, _mm256_cmpeq_epi32, CLIST_SIMD_MASK_I32_256)
+CLIST_SIMD_AVX2_SEARCH(u32, 8, CLIST_SIMD_LOADU_SI256, CLIST_SIMD_SET1_I32_256, _mm256_cmpeq_epi32, CLIST_SIMD_MASK_I32_256)
+CLIST_SIMD_AVX2_SEARCH(u64, 4, CLIST_SIMD_LOADU_SI256, clist__avx2_set1_u64, _mm256_cmpeq_epi64, CLIST_SIMD_MASK_I64_256)
+CLIST_SIMD_AVX2_SEARCH(f32, 8, _mm256_loadu_ps, _mm256_set1_ps, CLIST_SIMD_CMPEQ_PS, _mm256_movemask_ps)
+CLIST_SIMD_AVX2_SEARCH(f64, 4, _mm256_loadu_pd, _mm256_set1_pd, CLIST_SIMD_CMPEQ_PD, _mm256_movemask_pd)
+
+CLIST_SIMD_AVX2_COUNT(i32, 8, uint32_t, CLIST_SIMD_LOADU_SI256, CLIST_SIMD_SET1_I32_256, _mm256_cmpeq_epi32, CLIST_SIMD_SI128, _mm256_sub_epi32)
+CLIST_SIMD_AVX2_COUNT(u32, 8, uint32_t, CLIST_SIMD_LOADU_SI256, CLIST_SIMD_SET1_I32_256, _mm256_cmpeq_epi32, CLIST_SIMD_SI128, _mm256_sub_epi32)
+CLIST_SIMD_AVX2_COUNT(u64, 4, uint64_t, CLIST_SIMD_LOADU_SI256, clist__avx2_set1_u64, _mm256_cmpeq_epi64, CLIST_SIMD_SI128, _mm256_sub_epi64)
+CLIST_SIMD_AVX2_COUNT(f32, 8, uint32_t, _mm256_loadu_ps, _mm256_set1_ps, CLIST_SIMD_CMPEQ_PS, _mm256_castps_si256, _mm256_sub_epi32)
+CLIST_SIMD_AVX2_COUNT(f64, 4, uint64_t, _mm256_loadu_pd, _mm256_set1_pd, CLIST_SIMD_CMPEQ_PD, _mm256_castpd_si256, _mm256_sub_epi64)
+#endif
+
+
+/*
+	the dispatchers everything else calls
+*/
+
+#if CLIST_SIMD_SSE2
+	/* 0 = plain loops, 1 = SSE2, 2 = AVX2. detected on first use;
+	   passing a level >= 0 overrides it (e.g. to test or benchmark the
+	   narrower kernels) - it must not be more than the CPU supports. */
+CLIST_HELPER int clist__simd_level(int set) {
+	static int level = -1;
+
+	if (set >= 0) {
+		level = set;
+	} else if (CLIST_UNLIKELY(level < 0)) {
+#	if CLIST_SIMD_AVX2
+		level = __builtin_cpu_supports("avx2") ? 2 : 1;
+#	else
+		level = 1;
+#	endif
+	}
+
+	return level;
+}
+#endif
+
+	/* calls `name` with _scalar, _sse2 or _avx2 pasted on; `ret` is either
+	   `return` or empty for void kernels */
+#if CLIST_SIMD_AVX2
+#	define CLIST_SIMD_DISPATCH(ret, name, args) do { \
+			int __cls_level = clist__simd_level(-1); \
+			if (__cls_level >= 2) { \
+				ret name##_avx2 args; \
+			} else if (__cls_level == 1) { \
+				ret name##_sse2 args; \
+			} else { \
+				ret name##_scalar args; \
+			} \
+		} while (0)
+#elif CLIST_SIMD_SSE2
+#	define CLIST_SIMD_DISPATCH(ret, name, args) do { \
+			if (clist__simd_level(-1) >= 1) { \
+				ret name##_sse2 args; \
+			} else { \
+				ret name##_scalar args; \
+			} \
+		} while (0)
+#else
+#	define CLIST_SIMD_DISPATCH(ret, name, args) do { ret name##_scalar args; } while (0)
+#endif
+
+#define CLIST_SIMD_VOID
+
+#define CLIST_SIMD_KERNELS(kind) \
+	CLIST_HELPER clist__sum_t_##kind clist__sum_##kind(const clist__elem_t_##kind *vals, size_t n_elems) { \
+		CLIST_SIMD_DISPATCH(return, clist__sum_##kind, (vals, n_elems)); \
+	} \
+	CLIST_HELPER void clist__minmax_##kind(const clist__elem_t_##kind *vals, size_t n_elems, clist__elem_t_##kind *min_out, clist__elem_t_##kind *max_out) { \
+		*min_out = *max_out = vals[0]; \
+		CLIST_SIMD_DISPATCH(CLIST_SIMD_VOID, clist__minmax_##kind, (vals, n_elems, min_out, max_out)); \
+	} \
+	CLIST_HELPER size_t clist__find_##kind(const clist__elem_t_##kind *vals, size_t n_elems, clist__elem_t_##kind val) { \
+		CLIST_SIMD_DISPATCH(return, clist__find_##kind, (vals, n_elems, val)); \
+	} \
+	CLIST_HELPER size_t clist__count_eq_##kind(const clist__elem_t_##kind *vals, size_t n_elems, clist__elem_t_##kind val) { \
+		CLIST_SIMD_DISPATCH(return, clist__count_eq_##kind, (vals, n_elems, val)); \
+	}
+
+#if CLIST_SIMD_SSE2
+	/* the sums, finds and counts of (un)signed integers are bit-for-bit
+	   the same, so the signed ones reuse the unsigned kernels */
+#	define clist__sum_i64_sse2(vals, n_elems) ((int64_t) clist__sum_u64_sse2((const clist__u64 *) (vals), (n_elems)))
+#	define clist__find_i64_sse2(vals, n_elems, val) clist__find_u64_sse2((const clist__u64 *) (vals), (n_elems), (uint64_t) (val))
+#	define clist__count_eq_i64_sse2(vals, n_elems, val) clist__count_eq_u64_sse2((const clist__u64 *) (vals), (n_elems), (uint64_t) (val))
+#endif
+#if CLIST_SIMD_AVX2
+#	define clist__sum_i64_avx2(vals, n_elems) ((int64_t) clist__sum_u64_avx2((const clist__u64 *) (vals), (n_elems)))
+#	define clist__find_i64_avx2(vals, n_elems, val) clist__find_u64_avx2((const clist__u64 *) (vals), (n_elems), (uint64_t) (val))
+#	define clist__count_eq_i64_avx2(vals, n_elems, val) clist__count_eq_u64_avx2((const clist__u64 *) (vals), (n_elems), (uint64_t) (val))
+#endif
+
+CLIST_SIMD_KERNELS(i32)
+CLIST_SIMD_KERNELS(u32)
+CLIST_SIMD_KERNELS(i64)
+CLIST_SIMD_KERNELS(u64)
+CLIST_SIMD_KERNELS(f32)
+CLIST_SIMD_KERNELS(f64)
+
+	/* pointers are handled as unsigned integers of the same width */
+#if UINTPTR_MAX == UINT64_MAX
+typedef clist__elem_t_u64 clist__elem_t_ptr;
+typedef clist__sum_t_u64 clist__sum_t_ptr;
+#	define clist__sum_ptr clist__sum_u64
+#	define clist__minmax_ptr clist__minmax_u64
+#	define clist__find_ptr clist__find_u64
+#	define clist__count_eq_ptr clist__count_eq_u64
+#else
+typedef clist__elem_t_u32 clist__elem_t_ptr;
+typedef clist__sum_t_u32 clist__sum_t_ptr;
+#	define clist__sum_ptr clist__sum_u32
+#	define clist__minmax_ptr clist__minmax_u32
+#	define clist__find_ptr clist__find_u32
+#	define clist__count_eq_ptr clist__count_eq_u32
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
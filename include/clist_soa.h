@@ -0,0 +1,258 @@
+/*
+	Structure-of-arrays lists - included by clist_type.h when
+	CLIST_FIELDS is defined. Do not include this file directly.
+
+	      struct sample {
+	          int foo;
+	          int bar;
+	      };
+
+	      #define CLIST_TYPE struct sample
+	      #define CLIST_NAME sample
+	      #define CLIST_FIELDS(X) X(int, foo) X(int, bar)
+	      #include "clist_type.h"
+
+	      clist_sample_soa S;
+	      clist_sample_soa_init(&S);
+	      clist_sample_soa_add(&S, sample);
+
+	      // one field at a time
+	      int *foos = clist_sample_soa_col_foo(&S);
+	      for (i = 0; i < clist_sample_soa_count(&S); i++) {
+	          sum += foos[i];
+	      }
+
+	      clist_sample_soa_free(&S);
+
+	CLIST_FIELDS(X) lists the fields of CLIST_TYPE as X(type, name), and
+	generates clist_NAME_soa, which keeps each of those fields in a
+	column of its own (S.cols.foo, S.cols.bar...) instead of whole
+	structs side by side. Scans that only touch a few fields then only
+	pull those through the cache, and loops over a column are plain
+	array loops that the compiler can vectorize.
+
+	All columns share a count and a capacity and grow together, by the
+	same rules as the list itself. Rows go in and come out whole with
+	clist_NAME_soa_add(), clist_NAME_soa_get() and clist_NAME_soa_set();
+	single fields with clist_NAME_soa_get_FIELD() and
+	clist_NAME_soa_set_FIELD(); and whole columns with
+	clist_NAME_soa_col_FIELD(), which is valid until the next add or
+	reserve. Fields of CLIST_TYPE that aren't listed aren't stored and
+	come back zeroed from clist_NAME_soa_get().
+
+	Columns are moved bitwise when they grow, so under C++ field types
+	have to be trivially copyable.
+*/
+
+/* see header comment - DO NOT PRAGMA ONCE OR INCLUDE GUARD! */
+
+#define CLIST__SOA_COLUMN(type, name) type *name;
+
+typedef struct CLIST(soa) {
+	size_t count;
+	size_t capacity;
+	struct {
+		CLIST_FIELDS(CLIST__SOA_COLUMN)
+	} cols;
+} CLIST(soa);
+
+#undef CLIST__SOA_COLUMN
+
+/* grows (or first allocates) one column from `old_size` bytes. returns
+   1 on success, or 0 with errno set, leaving the column alone. */
+CLIST_API int CLIST__PRIVATE(soa_column_resize) (void **column, size_t old_size, size_t size) {
+	if (*column == NULL) {
+		CLIST_ALLOC(column, size);
+		return *column != NULL;
+	}
+
+	return CLIST__PRIVATE(heap_realloc)(column, old_size, size);
+}
+
+CLIST_API void CLIST(soa_init) (CLIST(soa) *soa) {
+	CLIST_ASSERT(soa != NULL);
+	memset(soa, 0, sizeof(*soa));
+}
+
+CLIST_API void CLIST(soa_free) (CLIST(soa) *soa) {
+	CLIST_ASSERT(soa != NULL);
+
+#define CLIST__SOA_FREE(type, name) \
+	if (soa->cols.name != NULL) { \
+		CLIST_FREE(soa->cols.name); \
+	}
+
+	CLIST_FIELDS(CLIST__SOA_FREE)
+
+#undef CLIST__SOA_FREE
+
+	memset(soa, 0, sizeof(*soa));
+}
+
+CLIST_API size_t CLIST(soa_count) (const CLIST(soa) *soa) {
+	CLIST_ASSERT(soa != NULL);
+	return soa->count;
+}
+
+/* keeps the capacity */
+CLIST_API void CLIST(soa_clear) (CLIST(soa) *soa) {
+	CLIST_ASSERT(soa != NULL);
+	soa->count = 0;
+}
+
+/* makes room for at least `n_elems` rows in every column. returns 0 on
+   success, or 1 with errno set. */
+CLIST_API int CLIST(soa_reserve) (CLIST(soa) *soa, size_t n_elems) {
+	size_t capacity;
+	int ok = 1;
+
+	CLIST_ASSERT(soa != NULL);
+
+	if (n_elems <= soa->capacity) {
+		return 0;
+	}
+
+	if (CLIST_UNLIKELY(clist__grow_capacity(
+		soa->capacity,
+		n_elems,
+		sizeof(CLIST(type)),
+		CLIST_BLOCK_SIZE,
+		CLIST_BLOCK_GROWTH_RATE,
+		&capacity
+	) != 0)) {
+		return 1;
+	}
+
+	/* a column that fails leaves the ones before it bigger than they
+	   need to be, which is harmless */
+#ifdef __cplusplus
+#	define CLIST__SOA_RESIZE(type, name) \
+		static_assert(std::is_trivially_copyable<type>::value, "columns are moved bitwise when they grow"); \
+		ok = ok && CLIST__PRIVATE(soa_column_resize)((void **) &soa->cols.name, soa->capacity * sizeof(type), capacity * sizeof(type));
+#else
+#	define CLIST__SOA_RESIZE(type, name) \
+		ok = ok && CLIST__PRIVATE(soa_column_resize)((void **) &soa->cols.name, soa->capacity * sizeof(type), capacity * sizeof(type));
+#endif
+
+	CLIST_FIELDS(CLIST__SOA_RESIZE)
+
+#undef CLIST__SOA_RESIZE
+
+	if (CLIST_UNLIKELY(!ok)) {
+		/* errno already set */
+		return 1;
+	}
+
+	soa->capacity = capacity;
+	return 0;
+}
+
+/* scatters `val` over the columns. returns the new row's index, or
+   CLIST_ERR with errno set. */
+CLIST_API size_t CLIST(soa_add) (CLIST(soa) *soa, const CLIST(type) CLIST_REF val) {
+	size_t idx;
+
+	CLIST_ASSERT(soa != NULL);
+
+	idx = soa->count;
+
+	if (CLIST_UNLIKELY(idx == soa->capacity)) {
+		if (CLIST_UNLIKELY(idx >= CLIST_MAX_INDEX)) {
+			errno = EOVERFLOW;
+			return CLIST_ERR;
+		}
+
+		if (CLIST_UNLIKELY(CLIST(soa_reserve)(soa, idx + 1) != 0)) {
+			/* errno already set */
+			return CLIST_ERR;
+		}
+	}
+
+#define CLIST__SOA_SCATTER(type, name) soa->cols.name[idx] = val.name;
+	CLIST_FIELDS(CLIST__SOA_SCATTER)
+#undef CLIST__SOA_SCATTER
+
+	soa->count = idx + 1;
+	return idx;
+}
+
+/* appends every element of `list`, one column at a time. returns 0 on
+   success, or 1 with errno set. */
+CLIST_API int CLIST(soa_add_list) (CLIST(soa) *soa, const CLIST_T *list) {
+	size_t i;
+
+	CLIST_ASSERT(soa != NULL);
+	CLIST_ASSERT(list != NULL);
+
+	if (CLIST_UNLIKELY(list->count > CLIST_MAX_INDEX - soa->count)) {
+		errno = EOVERFLOW;
+		return 1;
+	}
+
+	if (CLIST_UNLIKELY(CLIST(soa_reserve)(soa, soa->count + list->count) != 0)) {
+		/* errno already set */
+		return 1;
+	}
+
+#define CLIST__SOA_SCATTER_ALL(type, name) \
+	for (i = 0; i < list->count; i++) { \
+		soa->cols.name[soa->count + i] = list->block[i].name; \
+	}
+	CLIST_FIELDS(CLIST__SOA_SCATTER_ALL)
+#undef CLIST__SOA_SCATTER_ALL
+
+	soa->count += list->count;
+	return 0;
+}
+
+/* gathers row `index` back into a struct */
+CLIST_API CLIST(type) CLIST(soa_get) (const CLIST(soa) *soa, size_t index) {
+#ifdef __cplusplus
+	CLIST(type) row = CLIST(type)();
+#else
+	CLIST(type) row;
+	memset(&row, 0, sizeof(row));
+#endif
+
+	CLIST_ASSERT(soa != NULL);
+	CLIST_ASSERT(index < soa->count);
+
+#define CLIST__SOA_GATHER(type, name) row.name = soa->cols.name[index];
+	CLIST_FIELDS(CLIST__SOA_GATHER)
+#undef CLIST__SOA_GATHER
+
+	return row;
+}
+
+CLIST_API void CLIST(soa_set) (CLIST(soa) *soa, size_t index, const CLIST(type) CLIST_REF val) {
+	CLIST_ASSERT(soa != NULL);
+	CLIST_ASSERT(index < soa->count);
+
+#define CLIST__SOA_SCATTER(type, name) soa->cols.name[index] = val.name;
+	CLIST_FIELDS(CLIST__SOA_SCATTER)
+#undef CLIST__SOA_SCATTER
+}
+
+/* clist_NAME_soa_col_FIELD(), clist_NAME_soa_get_FIELD() and
+   clist_NAME_soa_set_FIELD() for every field */
+#define CLIST__SOA_ACCESSORS(type, name) \
+	CLIST_API type *CLIST(soa_col_ ## name) (const CLIST(soa) *soa) { \
+		CLIST_ASSERT(soa != NULL); \
+		return soa->cols.name; \
+	} \
+	\
+	CLIST_API type CLIST(soa_get_ ## name) (const CLIST(soa) *soa, size_t index) { \
+		CLIST_ASSERT(soa != NULL); \
+		CLIST_ASSERT(index < soa->count); \
+		return soa->cols.name[index]; \
+	} \
+	\
+	CLIST_API void CLIST(soa_set_ ## name) (CLIST(soa) *soa, size_t index, type val) { \
+		CLIST_ASSERT(soa != NULL); \
+		CLIST_ASSERT(index < soa->count); \
+		soa->cols.name[index] = val; \
+	}
+
+CLIST_FIELDS(CLIST__SOA_ACCESSORS)
+
+#undef CLIST__SOA_ACCESSORS
@@ -0,0 +1,402 @@
+/*
+	Spill-to-disk lists - included by clist_type.h when CLIST_SPILL is
+	defined. Do not include this file directly.
+
+	      #define CLIST_SPILL
+	      #define CLIST_TYPE struct event
+	      #define CLIST_NAME event
+	      #include "clist_type.h"
+
+	      clist_event_spill S;
+	      clist_event_spill_init(&S, NULL, 0);
+
+	      clist_event_spill_add(&S, ev);
+
+	      // sequential scans, a block at a time
+	      for (i = 0; i < clist_event_spill_count(&S); i += n) {
+	          struct event *evs;
+	          n = clist_event_spill_scan(&S, i, &evs);
+	          ... evs[0] through evs[n - 1] ...
+	      }
+
+	      // random access
+	      struct event *e = clist_event_spill_get(&S, 12345);
+
+	      clist_event_spill_free(&S);
+
+	A clist_NAME_spill is an append-only list for more elements than
+	fit in memory. Elements are kept in blocks of about
+	CLIST_SPILL_BLOCK_BYTES. The last CLIST_SPILL_HOT_BLOCKS blocks stay
+	in memory, and once they're full they're written to an unlinked
+	temporary file with one write(2). Reading a block that's already on
+	disk goes through a cache of CLIST_SPILL_CACHE_BLOCKS blocks, so a
+	list never holds more than (HOT + CACHE) blocks in memory no matter
+	how long it gets, and never reallocates. A cache miss reads a whole
+	block, so lists that are mostly read at random want a smaller
+	CLIST_SPILL_BLOCK_BYTES.
+
+	The file is created in `dir`, or in $TMPDIR or /tmp if that's NULL,
+	and is gone once the list is freed (or the process dies). Passing
+	CLIST_SPILL_DIRECT opens it with O_DIRECT so that spilled blocks
+	bypass the page cache; that needs _GNU_SOURCE on Linux and silently
+	falls back to buffered I/O when the file system or the allocator
+	can't do it (check for the flag in S.flags afterwards).
+
+	Pointers from clist_NAME_spill_get() and clist_NAME_spill_scan() are
+	only valid until the next call on the list. Only for element types
+	without pointers in them; under C++ the type has to be trivially
+	copyable. Not thread safe.
+*/
+
+#ifndef CLIST_SPILL_H__
+#define CLIST_SPILL_H__
+
+#ifndef CLIST_CORE_HAS_UNISTD
+#	error "CLIST_SPILL needs POSIX file I/O"
+#endif
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define CLIST_SPILL_DIRECT 1
+
+#ifndef CLIST_SPILL_BLOCK_BYTES
+#	define CLIST_SPILL_BLOCK_BYTES ((size_t) 1 << 20)
+#endif
+
+#ifndef CLIST_SPILL_HOT_BLOCKS
+#	define CLIST_SPILL_HOT_BLOCKS 4
+#endif
+
+#ifndef CLIST_SPILL_CACHE_BLOCKS
+#	define CLIST_SPILL_CACHE_BLOCKS 4
+#endif
+
+/* what O_DIRECT wants buffers, offsets and sizes to be multiples of */
+#ifndef CLIST_SPILL_DIRECT_ALIGN
+#	define CLIST_SPILL_DIRECT_ALIGN 4096
+#endif
+
+/* elements per block - a whole number of CLIST_SPILL_DIRECT_ALIGN
+   units, so that every block starts on an aligned file offset */
+CLIST_HELPER size_t clist__spill_block_elems(size_t elem_size) {
+	size_t a = elem_size;
+	size_t b = CLIST_SPILL_DIRECT_ALIGN;
+	size_t unit;
+
+	while (b != 0) {
+		size_t t = a % b;
+		a = b;
+		b = t;
+	}
+
+	/* the smallest number of elements that fills whole units */
+	unit = CLIST_SPILL_DIRECT_ALIGN / a;
+
+	if (CLIST_SPILL_BLOCK_BYTES / elem_size < unit) {
+		return unit;
+	}
+
+	return CLIST_SPILL_BLOCK_BYTES / elem_size / unit * unit;
+}
+
+/* creates a file only we know about; returns its descriptor, or -1
+   with errno set */
+CLIST_HELPER int clist__spill_open(const char *dir, int direct) {
+	static unsigned long counter = 0;
+	char path[4096];
+	int tries;
+
+	if (dir == NULL) {
+		dir = getenv("TMPDIR");
+	}
+
+	if (dir == NULL || *dir == '\0') {
+		dir = "/tmp";
+	}
+
+	if (CLIST_UNLIKELY(strlen(dir) > sizeof(path) - 64)) {
+		errno = ENAMETOOLONG;
+		return -1;
+	}
+
+	for (tries = 0; tries < 100; tries++) {
+		int fd;
+		int oflags = O_RDWR | O_CREAT | O_EXCL;
+
+		sprintf(path, "%s/clist-spill-%ld-%lu", dir, (long) getpid(), __atomic_fetch_add(&counter, 1, __ATOMIC_RELAXED));
+
+#ifdef O_DIRECT
+		if (direct) {
+			oflags |= O_DIRECT;
+		}
+#else
+		(void) direct;
+#endif
+
+		fd = open(path, oflags, 0600);
+
+#ifdef O_DIRECT
+		if (fd < 0 && errno == EINVAL && direct) {
+			/* tmpfs and friends - some kernels create it before they refuse */
+			(void) unlink(path);
+			errno = EINVAL;
+			return -1;
+		}
+#endif
+
+		if (fd >= 0) {
+			/* nothing else can get at it now, and it goes away with us */
+			(void) unlink(path);
+			return fd;
+		}
+
+		if (errno != EEXIST) {
+			/* errno already set */
+			return -1;
+		}
+	}
+
+	return -1;
+}
+
+/* reads or writes `size` bytes at `offset` */
+CLIST_HELPER int clist__spill_io(int fd, void *data, size_t size, size_t offset, int writing) {
+	char *p = (char *) data;
+
+	if (CLIST_UNLIKELY(lseek(fd, (off_t) offset, SEEK_SET) == (off_t) -1)) {
+		/* errno already set */
+		return 1;
+	}
+
+	while (size > 0) {
+		ssize_t n = writing ? write(fd, p, size) : read(fd, p, size);
+
+		if (n < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+
+			/* errno already set */
+			return 1;
+		}
+
+		if (n == 0) {
+			/* the file is shorter than what we've written to it */
+			errno = EIO;
+			return 1;
+		}
+
+		p += n;
+		size -= (size_t) n;
+	}
+
+	return 0;
+}
+#endif
+
+/* see header comment - DO NOT PRAGMA ONCE OR INCLUDE GUARD! */
+
+typedef struct CLIST(spill) {
+	int fd;
+	int flags;
+	size_t count;
+	size_t block_elems;
+	size_t block_bytes;
+	CLIST(type) *hot; /* blocks hot_first, hot_first + 1, ... */
+	size_t hot_first;
+	CLIST(type) *cache;
+	size_t cache_tags[CLIST_SPILL_CACHE_BLOCKS]; /* the block in each slot, or CLIST_ERR */
+} CLIST(spill);
+
+/* `dir` may be NULL; `flags` may be CLIST_SPILL_DIRECT. returns 0 on
+   success, or 1 with errno set. */
+CLIST_API int CLIST(spill_init) (CLIST(spill) *spill, const char *dir, int flags) {
+	size_t i;
+
+#ifdef __cplusplus
+	static_assert(std::is_trivially_copyable<CLIST(type)>::value, "elements are spilled to disk as raw bytes");
+#endif
+
+	CLIST_ASSERT(spill != NULL);
+
+	spill->count = 0;
+	spill->hot_first = 0;
+	spill->block_elems = clist__spill_block_elems(sizeof(CLIST(type)));
+	spill->block_bytes = spill->block_elems * sizeof(CLIST(type));
+	spill->hot = NULL;
+	spill->cache = NULL;
+	spill->flags = flags;
+	spill->fd = -1;
+
+	for (i = 0; i < CLIST_SPILL_CACHE_BLOCKS; i++) {
+		spill->cache_tags[i] = CLIST_ERR;
+	}
+
+	CLIST_ALLOC((void **) &spill->hot, CLIST_SPILL_HOT_BLOCKS * spill->block_bytes);
+	if (CLIST_UNLIKELY(spill->hot == NULL)) {
+		/* errno already set */
+		return 1;
+	}
+
+	CLIST_ALLOC((void **) &spill->cache, CLIST_SPILL_CACHE_BLOCKS * spill->block_bytes);
+	if (CLIST_UNLIKELY(spill->cache == NULL)) {
+		CLIST_FREE(spill->hot);
+		return 1;
+	}
+
+#ifndef O_DIRECT
+	spill->flags &= ~CLIST_SPILL_DIRECT;
+#endif
+
+	/* O_DIRECT transfers straight out of (and into) our buffers */
+	if ((size_t) spill->hot % CLIST_SPILL_DIRECT_ALIGN != 0 || (size_t) spill->cache % CLIST_SPILL_DIRECT_ALIGN != 0) {
+		spill->flags &= ~CLIST_SPILL_DIRECT;
+	}
+
+	if (spill->flags & CLIST_SPILL_DIRECT) {
+		spill->fd = clist__spill_open(dir, 1);
+		if (spill->fd < 0 && errno == EINVAL) {
+			spill->flags &= ~CLIST_SPILL_DIRECT;
+		}
+	}
+
+	if (spill->fd < 0 && !(spill->flags & CLIST_SPILL_DIRECT)) {
+		spill->fd = clist__spill_open(dir, 0);
+	}
+
+	if (CLIST_UNLIKELY(spill->fd < 0)) {
+		CLIST_FREE(spill->cache);
+		CLIST_FREE(spill->hot);
+		return 1;
+	}
+
+	return 0;
+}
+
+CLIST_API void CLIST(spill_free) (CLIST(spill) *spill) {
+	CLIST_ASSERT(spill != NULL);
+
+	(void) close(spill->fd);
+	CLIST_FREE(spill->cache);
+	CLIST_FREE(spill->hot);
+
+	spill->fd = -1;
+	spill->hot = NULL;
+	spill->cache = NULL;
+	spill->count = 0;
+}
+
+CLIST_API size_t CLIST(spill_count) (const CLIST(spill) *spill) {
+	CLIST_ASSERT(spill != NULL);
+	return spill->count;
+}
+
+/* returns the new element's index, or CLIST_ERR with errno set */
+CLIST_API size_t CLIST(spill_add) (CLIST(spill) *spill, const CLIST(type) CLIST_REF val) {
+	size_t idx;
+	size_t hot_idx;
+
+	CLIST_ASSERT(spill != NULL);
+
+	idx = spill->count;
+	hot_idx = idx - spill->hot_first * spill->block_elems;
+
+	if (CLIST_UNLIKELY(hot_idx == CLIST_SPILL_HOT_BLOCKS * spill->block_elems)) {
+		/* the file offsets run out long before the indices do */
+		if (CLIST_UNLIKELY(spill->hot_first + 2 * CLIST_SPILL_HOT_BLOCKS > CLIST_MAX_INDEX / spill->block_bytes)) {
+			errno = EOVERFLOW;
+			return CLIST_ERR;
+		}
+
+		/* seal all of them at once - the hot blocks are contiguous on disk too */
+		if (CLIST_UNLIKELY(clist__spill_io(spill->fd, spill->hot, CLIST_SPILL_HOT_BLOCKS * spill->block_bytes, spill->hot_first * spill->block_bytes, 1) != 0)) {
+			/* errno already set */
+			return CLIST_ERR;
+		}
+
+		spill->hot_first += CLIST_SPILL_HOT_BLOCKS;
+		hot_idx = 0;
+	}
+
+	spill->hot[hot_idx] = val;
+	spill->count = idx + 1;
+	return idx;
+}
+
+/* returns the elements of block `block` (which must hold at least one
+   element), or NULL with errno set */
+CLIST_API CLIST(type) *CLIST(spill_block) (CLIST(spill) *spill, size_t block) {
+	CLIST(type) *slot;
+	size_t which;
+
+	CLIST_ASSERT(spill != NULL);
+	CLIST_ASSERT(block * spill->block_elems < spill->count);
+
+	if (block >= spill->hot_first) {
+		return spill->hot + (block - spill->hot_first) * spill->block_elems;
+	}
+
+	which = block % CLIST_SPILL_CACHE_BLOCKS;
+	slot = spill->cache + which * spill->block_elems;
+
+	if (spill->cache_tags[which] != block) {
+		/* blocks on disk never change, so the slot only needs reading */
+		if (CLIST_UNLIKELY(clist__spill_io(spill->fd, slot, spill->block_bytes, block * spill->block_bytes, 0) != 0)) {
+			spill->cache_tags[which] = CLIST_ERR;
+			return NULL;
+		}
+
+		spill->cache_tags[which] = block;
+	}
+
+	return slot;
+}
+
+/* returns the element at `index`, or NULL with errno set */
+CLIST_API CLIST(type) *CLIST(spill_get) (CLIST(spill) *spill, size_t index) {
+	CLIST(type) *block;
+
+	CLIST_ASSERT(spill != NULL);
+	CLIST_ASSERT(index < spill->count);
+
+	block = CLIST(spill_block)(spill, index / spill->block_elems);
+	if (CLIST_UNLIKELY(block == NULL)) {
+		return NULL;
+	}
+
+	return block + index % spill->block_elems;
+}
+
+/* points `*elems` at the element at `index` and returns how many
+   elements follow it contiguously (at least 1), or 0 once `index`
+   reaches the end. returns CLIST_ERR with errno set if the block can't
+   be read. */
+CLIST_API size_t CLIST(spill_scan) (CLIST(spill) *spill, size_t index, CLIST(type) **elems) {
+	CLIST(type) *block;
+	size_t offset;
+	size_t n;
+
+	CLIST_ASSERT(spill != NULL);
+	CLIST_ASSERT(elems != NULL);
+
+	if (index >= spill->count) {
+		return 0;
+	}
+
+	block = CLIST(spill_block)(spill, index / spill->block_elems);
+	if (CLIST_UNLIKELY(block == NULL)) {
+		return CLIST_ERR;
+	}
+
+	offset = index % spill->block_elems;
+	n = spill->block_elems - offset;
+	if (n > spill->count - index) {
+		n = spill->count - index;
+	}
+
+	*elems = block + offset;
+	return n;
+}
@@ -0,0 +1,198 @@
+#ifndef CLIST_STATS_H__
+#define CLIST_STATS_H__
+/*
+	Statistics - included by clist_type.h when CLIST_STATS is defined;
+	include clist_type.h rather than this file.
+
+	      #define CLIST_STATS
+	      #define CLIST_TYPE int
+	      #define CLIST_NAME int
+	      #include "clist_type.h"
+
+	      clist_stats st;
+	      clist_int_stats(&L, &st); // one list, as it is now
+	      clist_int_stats_type(&st); // every list of the type so far
+
+	      clist_stats_dump(stderr); // every type, one line each
+
+	Each list counts what happens to it: elements added, times its
+	capacity went up, moves from the stack block to the heap, bytes
+	asked of the allocator, bytes copied around (by the list itself or
+	by a realloc(3) that had to move the block) and the largest
+	capacity it had. Those are plain increments on the list itself, so
+	they cost next to nothing, and without CLIST_STATS none of it is
+	compiled in at all.
+
+	clist_free() folds a list's counters into the totals of its type,
+	along with its count and capacity at that point (so capacity -
+	count is what was left unused when lists were done with). Lists
+	that live for a long time can be folded in early with
+	clist_NAME_stats_flush(). Folding takes a spinlock for the type, so
+	lists of the same type on different threads can do it at once.
+
+	A type shows up in the registry once one of its lists has been
+	folded in. clist_stats_each() walks it to hand the totals to a
+	metrics system; clist_stats_dump() writes them as key=value lines.
+	Counters only ever go up.
+
+	The registry is per translation unit, as the library is header-only.
+	To share one across a program, define CLIST_STATS_REGISTRY to an
+	lvalue of type clist_stats_type * that all of them can see, e.g.
+
+	      extern clist_stats_type *my_registry;
+	      #define CLIST_STATS_REGISTRY my_registry
+*/
+
+#include <stddef.h>
+#include <stdio.h>
+
+#include "./clist_core.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct clist_stats {
+	size_t adds; /* elements added */
+	size_t expansions; /* times the capacity went up */
+	size_t promotions; /* moves from the stack block to the heap */
+	size_t bytes_allocated; /* asked of the allocator, reallocs included */
+	size_t bytes_copied; /* moved by the list or by realloc() */
+	size_t peak_capacity; /* in elements */
+	size_t lists; /* lists freed, or 1 for a single list */
+	size_t count; /* for a list, as it is now; for a type, summed */
+	size_t capacity; /* over its lists as they were freed */
+} clist_stats;
+
+typedef struct clist_stats_type {
+	const char *name;
+	size_t elem_size;
+	clist_stats totals;
+	int registered;
+	int lock;
+	struct clist_stats_type *next;
+} clist_stats_type;
+
+/* "clist_NAME", from the list's type name */
+#define CLIST__STATS_NAME(type) CLIST__STATS_NAME_(type)
+#define CLIST__STATS_NAME_(type) #type
+
+#ifndef CLIST_STATS_REGISTRY
+static clist_stats_type *clist__stats_registry = NULL;
+#	define CLIST_STATS_REGISTRY clist__stats_registry
+#endif
+
+CLIST_HELPER void clist__stats_lock(clist_stats_type *type) {
+	while (__atomic_exchange_n(&type->lock, 1, __ATOMIC_ACQUIRE)) {
+		while (__atomic_load_n(&type->lock, __ATOMIC_RELAXED)) {
+			/* spin */
+		}
+	}
+}
+
+CLIST_HELPER void clist__stats_unlock(clist_stats_type *type) {
+	__atomic_store_n(&type->lock, 0, __ATOMIC_RELEASE);
+}
+
+/* adds `stats` to the totals of `type`, registering the type the first
+   time around. `retired` lists also count towards lists, count and
+   capacity. */
+CLIST_HELPER void clist__stats_fold(clist_stats_type *type, const clist_stats *stats, int retired) {
+	CLIST_ASSERT(type != NULL);
+	CLIST_ASSERT(stats != NULL);
+
+	/* one uncontended lock is a lot cheaper than an atomic add per
+	   counter, which matters for lists that don't live long */
+	clist__stats_lock(type);
+
+	if (CLIST_UNLIKELY(!type->registered)) {
+		clist_stats_type *head = __atomic_load_n(&CLIST_STATS_REGISTRY, __ATOMIC_ACQUIRE);
+		do {
+			type->next = head;
+		} while (!__atomic_compare_exchange_n(&CLIST_STATS_REGISTRY, &head, type, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+		type->registered = 1;
+	}
+
+	type->totals.adds += stats->adds;
+	type->totals.expansions += stats->expansions;
+	type->totals.promotions += stats->promotions;
+	type->totals.bytes_allocated += stats->bytes_allocated;
+	type->totals.bytes_copied += stats->bytes_copied;
+	if (stats->peak_capacity > type->totals.peak_capacity) {
+		type->totals.peak_capacity = stats->peak_capacity;
+	}
+
+	if (retired) {
+		type->totals.lists++;
+		type->totals.count += stats->count;
+		type->totals.capacity += stats->capacity;
+	}
+
+	clist__stats_unlock(type);
+}
+
+/* the totals of `type` so far */
+CLIST_HELPER void clist_stats_snapshot(clist_stats_type *type, clist_stats *out) {
+	CLIST_ASSERT(type != NULL);
+	CLIST_ASSERT(out != NULL);
+
+	clist__stats_lock(type);
+	*out = type->totals;
+	clist__stats_unlock(type);
+}
+
+typedef int (*clist_stats_fn)(void *ctx, const clist_stats_type *type, const clist_stats *stats);
+
+/* calls `fn` with the totals of every registered type, newest first,
+   until it returns non-zero. returns what `fn` last returned, or 0. */
+CLIST_HELPER int clist_stats_each(clist_stats_fn fn, void *ctx) {
+	clist_stats_type *type;
+	clist_stats stats;
+	int result;
+
+	CLIST_ASSERT(fn != NULL);
+
+	for (type = __atomic_load_n(&CLIST_STATS_REGISTRY, __ATOMIC_ACQUIRE); type != NULL; type = type->next) {
+		clist_stats_snapshot(type, &stats);
+
+		result = fn(ctx, type, &stats);
+		if (result != 0) {
+			return result;
+		}
+	}
+
+	return 0;
+}
+
+CLIST_HELPER int clist__stats_dump_one(void *ctx, const clist_stats_type *type, const clist_stats *stats) {
+	int written = fprintf(
+		(FILE *) ctx,
+		"%s elem_size=%lu adds=%lu expansions=%lu promotions=%lu bytes_allocated=%lu bytes_copied=%lu peak_capacity=%lu lists=%lu count=%lu capacity=%lu\n",
+		type->name,
+		(unsigned long) type->elem_size,
+		(unsigned long) stats->adds,
+		(unsigned long) stats->expansions,
+		(unsigned long) stats->promotions,
+		(unsigned long) stats->bytes_allocated,
+		(unsigned long) stats->bytes_copied,
+		(unsigned long) stats->peak_capacity,
+		(unsigned long) stats->lists,
+		(unsigned long) stats->count,
+		(unsigned long) stats->capacity
+	);
+
+	return written < 0;
+}
+
+/* writes one line per registered type to `f`. returns 0 on success,
+   or 1 with errno set. */
+CLIST_HELPER int clist_stats_dump(FILE *f) {
+	CLIST_ASSERT(f != NULL);
+	return clist_stats_each(&clist__stats_dump_one, f);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
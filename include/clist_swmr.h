@@ -0,0 +1,243 @@
+/*
+	Single-writer/multi-reader lists - included by clist_type.h when
+	CLIST_SWMR is defined. Do not include this file directly.
+
+	      #define CLIST_SWMR
+	      #define CLIST_TYPE struct entry
+	      #define CLIST_NAME entry
+	      #include "clist_type.h"
+
+	      clist_epoch E;
+	      clist_epoch_init(&E);
+
+	      clist_entry_swmr L;
+	      clist_entry_swmr_init(&L, &E);
+
+	      // the one writer thread
+	      clist_entry_swmr_add(&L, entry);
+
+	      // any number of reader threads
+	      clist_epoch_reader *r = clist_epoch_register(&E);
+	      clist_epoch_enter(r);
+	      n = clist_entry_swmr_count(&L);
+	      for (i = 0; i < n; i++) {
+	          struct entry *e = clist_entry_swmr_get(&L, i);
+	          ...
+	      }
+	      clist_epoch_leave(r);
+
+	A clist_NAME_swmr is a list that one thread appends to while any
+	number of other threads read it, none of them taking a lock.
+	Growing allocates a new block, copies the elements over and
+	publishes it atomically; the old block is retired and only freed
+	once every reader that might still be looking at it has left its
+	read section (see clist_epoch.h). Readers never wait on anything.
+
+	Pointers from clist_NAME_swmr_get() are only valid until the reader
+	calls clist_epoch_leave(). clist_NAME_swmr_count() and
+	clist_NAME_swmr_get() can be called from the writer without
+	entering at all, since only the writer frees anything.
+
+	Elements are copied into the new block bitwise while readers might
+	still read the old copies, so under C++ the type has to be
+	CLIST_RELOCATABLE.
+
+	Several lists can share one clist_epoch. clist_NAME_swmr_init() and
+	clist_NAME_swmr_free() must not race with anything else.
+*/
+
+/* see header comment - DO NOT PRAGMA ONCE OR INCLUDE GUARD! */
+
+typedef struct CLIST(swmr_block) {
+	size_t capacity;
+	size_t retired_at; /* the epoch tag it was retired with */
+	struct CLIST(swmr_block) *next_retired;
+} CLIST(swmr_block);
+
+/* the elements follow the header, which is padded to a cache line (or
+   to CLIST_ALIGNMENT, if that's more) so that they're as aligned as
+   the block is */
+#if defined(CLIST_ALIGNMENT) && CLIST_ALIGNMENT > CLIST_EPOCH_CACHE_LINE
+#	define CLIST_SWMR_HEADER CLIST_PAGE_ROUND(sizeof(CLIST(swmr_block)), CLIST_ALIGNMENT)
+#else
+#	define CLIST_SWMR_HEADER CLIST_PAGE_ROUND(sizeof(CLIST(swmr_block)), CLIST_EPOCH_CACHE_LINE)
+#endif
+
+#define CLIST_SWMR_ELEMS(block) ((CLIST(type) *) (void *) ((char *) (block) + CLIST_SWMR_HEADER))
+
+typedef struct CLIST(swmr) {
+	CLIST(swmr_block) *block; /* published with release */
+	size_t count; /* published with release */
+	clist_epoch *epoch;
+	CLIST(swmr_block) *retired; /* only the writer touches these */
+} CLIST(swmr);
+
+CLIST_API void CLIST(swmr_init) (CLIST(swmr) *list, clist_epoch *epoch) {
+	CLIST_ASSERT(list != NULL);
+	CLIST_ASSERT(epoch != NULL);
+
+	list->block = NULL;
+	list->count = 0;
+	list->epoch = epoch;
+	list->retired = NULL;
+}
+
+/* writer only - frees every retired block that no reader can still see */
+CLIST_API void CLIST(swmr_reclaim) (CLIST(swmr) *list) {
+	CLIST(swmr_block) **link;
+
+	CLIST_ASSERT(list != NULL);
+
+	link = &list->retired;
+	while (*link != NULL) {
+		CLIST(swmr_block) *block = *link;
+
+		if (clist_epoch_safe(list->epoch, block->retired_at)) {
+			*link = block->next_retired;
+			CLIST__PRIVATE(owned_free)(NULL, block);
+		} else {
+			link = &block->next_retired;
+		}
+	}
+}
+
+CLIST_API void CLIST(swmr_free) (CLIST(swmr) *list) {
+	CLIST_ASSERT(list != NULL);
+
+	if (list->block != NULL) {
+#ifdef __cplusplus
+		size_t i;
+		for (i = 0; i < list->count; i++) {
+			CLIST_SWMR_ELEMS(list->block)[i].~CLIST(type)();
+		}
+#endif
+
+		CLIST__PRIVATE(owned_free)(NULL, list->block);
+	}
+
+	/* no readers left, so everything can go */
+	while (list->retired != NULL) {
+		CLIST(swmr_block) *block = list->retired;
+		list->retired = block->next_retired;
+		CLIST__PRIVATE(owned_free)(NULL, block);
+	}
+
+	list->block = NULL;
+	list->count = 0;
+}
+
+/* wait-free; safe from any thread */
+CLIST_API size_t CLIST(swmr_count) (const CLIST(swmr) *list) {
+	CLIST_ASSERT(list != NULL);
+	return __atomic_load_n(&list->count, __ATOMIC_ACQUIRE);
+}
+
+/* wait-free; readers have to be between clist_epoch_enter() and
+   clist_epoch_leave(), and `index` below a count they've read */
+CLIST_API CLIST(type) *CLIST(swmr_get) (const CLIST(swmr) *list, size_t index) {
+	CLIST(swmr_block) *block;
+
+	CLIST_ASSERT(list != NULL);
+
+	block = __atomic_load_n(&list->block, __ATOMIC_ACQUIRE);
+	CLIST_ASSERT(block != NULL && index < block->capacity);
+
+	return &CLIST_SWMR_ELEMS(block)[index];
+}
+
+/* writer only - moves the elements to a block that holds at least
+   `n_elems`, retiring the old one. returns 0 on success, or 1 with
+   errno set. */
+CLIST_API int CLIST(swmr_grow) (CLIST(swmr) *list, size_t n_elems) {
+	CLIST(swmr_block) *old_block;
+	CLIST(swmr_block) *new_block;
+	size_t capacity;
+
+#ifdef __cplusplus
+	static_assert(CLIST_RELOCATABLE, "readers may still be reading the old copies of moved elements");
+#endif
+
+	CLIST_ASSERT(list != NULL);
+
+	old_block = list->block;
+	capacity = old_block != NULL ? old_block->capacity : 0;
+
+	if (n_elems <= capacity) {
+		return 0;
+	}
+
+	if (CLIST_UNLIKELY(clist__grow_capacity(
+		capacity,
+		n_elems,
+		sizeof(CLIST(type)),
+		CLIST_BLOCK_SIZE,
+		CLIST_BLOCK_GROWTH_RATE,
+		&capacity
+	) != 0)) {
+		return 1;
+	}
+
+	if (CLIST_UNLIKELY(capacity > (CLIST_MAX_INDEX - CLIST_SWMR_HEADER) / sizeof(CLIST(type)))) {
+		errno = ENOMEM;
+		return 1;
+	}
+
+	/* no arena and no counters, but otherwise like a list's blocks */
+	new_block = (CLIST(swmr_block) *) CLIST__PRIVATE(owned_alloc)(NULL, NULL, CLIST_SWMR_HEADER + capacity * sizeof(CLIST(type)), false);
+	if (CLIST_UNLIKELY(new_block == NULL)) {
+		/* errno already set */
+		return 1;
+	}
+
+	new_block->capacity = capacity;
+	new_block->retired_at = 0;
+	new_block->next_retired = NULL;
+
+	if (old_block != NULL) {
+		CLIST_MEMCPY((void *) CLIST_SWMR_ELEMS(new_block), CLIST_SWMR_ELEMS(old_block), list->count * sizeof(CLIST(type)));
+	}
+
+	__atomic_store_n(&list->block, new_block, __ATOMIC_RELEASE);
+
+	if (old_block != NULL) {
+		old_block->retired_at = clist_epoch_retire(list->epoch);
+		old_block->next_retired = list->retired;
+		list->retired = old_block;
+		CLIST(swmr_reclaim)(list);
+	}
+
+	return 0;
+}
+
+/* writer only - returns the new element's index, or CLIST_ERR with errno set */
+CLIST_API size_t CLIST(swmr_add) (CLIST(swmr) *list, const CLIST(type) CLIST_REF val) {
+	size_t idx;
+
+	CLIST_ASSERT(list != NULL);
+
+	idx = list->count; /* only this thread writes it */
+
+	if (CLIST_UNLIKELY(list->block == NULL || idx == list->block->capacity)) {
+		if (CLIST_UNLIKELY(idx >= CLIST_MAX_INDEX)) {
+			errno = EOVERFLOW;
+			return CLIST_ERR;
+		}
+
+		if (CLIST_UNLIKELY(CLIST(swmr_grow)(list, idx + 1) != 0)) {
+			/* errno already set */
+			return CLIST_ERR;
+		}
+	}
+
+#ifdef __cplusplus
+	new (&CLIST_SWMR_ELEMS(list->block)[idx]) CLIST(type)(val);
+#else
+	CLIST_SWMR_ELEMS(list->block)[idx] = val;
+#endif
+
+	__atomic_store_n(&list->count, idx + 1, __ATOMIC_RELEASE);
+	return idx;
+}
+
+#undef CLIST_SWMR_ELEMS
+#undef CLIST_SWMR_HEADER
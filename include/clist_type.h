@@ -18,11 +18,132 @@
 	      define CLIST_SAFE_REALLOC. Note that this has a potential
 	      performance penalty since the memory is no longer aligned
 	      and the block allocations will be forced to fall back
-	      to malloc(3).
+	      to malloc(3). Lists with a CLIST_ALIGNMENT stay aligned, but
+	      copy their elements to a new block every time they grow.
+
+	NOTE: If you define your own CLIST_ALLOC/CLIST_REALLOC/CLIST_FREE
+	      you can also define CLIST_CALLOC(ptrptr, size) to hand out
+	      zeroed memory; otherwise clist_resize() falls back to
+	      CLIST_ALLOC() followed by a memset(3).
+
+	NOTE: On Linux, defining CLIST_USE_MMAP gives every heap block its own
+	      anonymous mapping that grows through mremap(2) without copying.
+	      _GNU_SOURCE must be defined before any system header is included.
+	      Define CLIST_MMAP_HUGEPAGES as well to ask for transparent huge
+	      pages, and use clist_trim() to drop unused pages again.
+	      Custom CLIST_ALLOC/CLIST_REALLOC/CLIST_FREE hooks take precedence.
+
+	NOTE: Each list carries room for CLIST_INLINE_CAPACITY elements
+	      inside of itself (CLIST_BLOCK_SIZE by default) before it
+	      allocates. Set it lower (or to 0) to keep lists small when
+	      they're embedded in other structures or arrays.
 
 	NOTE: If you're using C++, you probably also want to define
 	      CLIST_REF prior to including this header.
 
+	NOTE: Under C++, elements are moved (move-constructed and then
+	      destructed) whenever the list has to shift or reallocate them,
+	      unless CLIST_RELOCATABLE is true, in which case they are simply
+	      memcpy()'d. It defaults to std::is_trivially_copyable<type>;
+	      define it to 1 for types that are safe to move bitwise
+	      (e.g. structs holding std::unique_ptr).
+
+	NOTE: Under C++, named lists also get a clist::NAME wrapper class.
+	      Define CLIST_NO_CLASS to skip it (e.g. when the un-namespaced
+	      `clist` type from clist.h is used in the same file).
+
+	NOTE: Defining CLIST_SEGMENTED also generates clist_NAME_seg, a list
+	      whose elements never move once added (see clist_segmented.h).
+
+	NOTE: Defining CLIST_CONCURRENT also generates clist_NAME_conc, an
+	      append-only list that any number of threads can add to at
+	      once without locking (see clist_concurrent.h).
+
+	NOTE: Defining CLIST_SHARDED also generates clist_NAME_sharded, a
+	      set of per-thread lists that can be merged into one list with
+	      a single allocation (see clist_sharded.h).
+
+	NOTE: Defining CLIST_RING also generates clist_NAME_ring, a bounded
+	      single-producer/single-consumer queue that uses a list's
+	      block as a ring (see clist_ring.h).
+
+	NOTE: Defining CLIST_SWMR also generates clist_NAME_swmr, a list
+	      that one thread appends to while others read it without
+	      locking, with old blocks freed through epoch based
+	      reclamation (see clist_swmr.h and clist_epoch.h).
+
+	NOTE: Defining CLIST_PERSIST generates clist_save() and clist_load(),
+	      which write lists of pointer-free elements to a file and read
+	      them back, and clist_map(), which uses such a file as a list
+	      without copying it (see clist_persist.h). POSIX only.
+
+	NOTE: Defining CLIST_SPILL also generates clist_NAME_spill, an
+	      append-only list that keeps a bounded number of blocks in
+	      memory and writes the rest to a temporary file (see
+	      clist_spill.h). POSIX only.
+
+	NOTE: Defining CLIST_SHM also generates clist_NAME_shm, a list kept
+	      in a named POSIX shared memory segment that one process
+	      appends to and others read in place (see clist_shm.h).
+
+	NOTE: Defining CLIST_FIELDS(X) to the fields of a struct CLIST_TYPE,
+	      as X(type, name) for each, also generates clist_NAME_soa, a
+	      structure-of-arrays list with one column per field (see
+	      clist_soa.h). e.g.
+
+	          #define CLIST_FIELDS(X) X(int, foo) X(int, bar)
+
+	NOTE: Defining CLIST_ARENA lets lists of that type take their heap
+	      blocks from a shared clist_arena via clist_NAME_init_arena()
+	      (see clist_arena.h).
+
+	NOTE: Defining CLIST_GROWTH lets each list of that type have its own
+	      growth policy (geometric, linear, capped doubling or a
+	      callback) via clist_NAME_set_growth(), in place of
+	      CLIST_BLOCK_GROWTH_RATE (see clist_growth.h).
+
+	NOTE: Defining CLIST_ALIGNMENT to a power of two (e.g. 64 for cache
+	      lines, 32 for AVX) aligns every list's elements to it, on the
+	      heap, in an arena and in the stack block alike. Heap blocks
+	      are grown with realloc(3) only where that is sure to keep them
+	      aligned (up to CLIST_MALLOC_ALIGNMENT, or a page with
+	      CLIST_USE_MMAP). Otherwise they are grown in place by
+	      CLIST_EXPAND(&success, ptr, size) if that is defined (e.g.
+	      around mimalloc's mi_expand() or jemalloc's xallocx()), and
+	      moved to a new aligned block when it isn't or can't. The
+	      stack block is only aligned if the list itself is, which
+	      lists on the stack or in static storage always are. Custom
+	      CLIST_ALLOC hooks have to honor it, too.
+
+	NOTE: Defining CLIST_STATS makes lists of that type count adds,
+	      expansions, moves to the heap and bytes allocated and copied,
+	      which clist_NAME_stats() reports and clist_free() adds to
+	      per-type totals (see clist_stats.h). Without it, none of
+	      this is compiled in.
+
+	NOTE: Defining CLIST_KIND to one of i32, u32, i64, u64, f32, f64 or
+	      ptr (matching CLIST_TYPE) generates vectorized clist_sum(),
+	      clist_minmax(), clist_find() and clist_count_eq() (see
+	      clist_simd.h). The default void* list is a ptr list.
+
+	NOTE: Defining CLIST_CMP(a, b) to a comparison of two elements that
+	      is negative, zero or positive (like strcmp(3)) generates
+	      clist_sort(), clist_lower_bound() and clist_bsearch() with
+	      the comparison inlined. Its arguments may be evaluated more
+	      than once. e.g.
+
+	          #define CLIST_CMP(a, b) (((a) > (b)) - ((a) < (b)))
+
+	NOTE: CLIST_KIND lists also get clist_radix_sort(), a stable LSD radix
+	      sort (see clist_radix.h). Other lists can have one too by
+	      defining CLIST_RADIX_KEY(elem) to an unsigned integer key:
+
+	          #define CLIST_RADIX_KEY(s) ((uint32_t) (s).id)
+
+	NOTE: Defining CLIST_PARALLEL generates clist_parallel_for() and
+	      clist_parallel_reduce(), which spread the list over a pool of
+	      pthreads (see clist_parallel.h). Link with -lpthread.
+
 	NOTE: clist_swap() is available if CLIST_MEMSWAP(p1,p2,n) is
 	      defined beforehand. It should return 0 for success.
 */
@@ -38,7 +159,11 @@
 #	define CLIST_T CLIST_T__(CLIST_NAME)
 #	define CLIST_T__(name) CLIST_T_(name)
 #	define CLIST_T_(name) clist_##name
-#	define CLIST_SHOULD_CLASSIFY 1
+#	ifdef CLIST_NO_CLASS
+#		define CLIST_SHOULD_CLASSIFY 0
+#	else
+#		define CLIST_SHOULD_CLASSIFY 1
+#	endif
 #else
 #	define CLIST(thing) clist_##thing
 #	define CLIST_T clist
@@ -50,8 +175,14 @@
 #	define CLIST_SHOULD_CLASSIFY 0
 #endif
 
+/* per-type helpers that aren't part of the API: clist_NAME__thing */
+#define CLIST__PRIVATE(thing) CLIST(_##thing)
+
 #ifndef CLIST_TYPE
 #	define CLIST_TYPE void*
+#	ifndef CLIST_KIND
+#		define CLIST_KIND ptr
+#	endif
 #endif
 
 #if defined(__cplusplus) && !defined(CLIST_NO_REF)
@@ -73,95 +204,111 @@
 #	define CLIST_BLOCK_SIZE 512
 #endif
 
+#ifndef CLIST_INLINE_CAPACITY
+	/* how many elements live inside the list itself before
+	   it goes to the heap; may be 0 */
+#	define CLIST_INLINE_CAPACITY CLIST_BLOCK_SIZE
+#endif
+
 #ifndef CLIST_BLOCK_GROWTH_RATE
 	/* yes, 4 - you'll eat lots of memory but allocate less */
 #	define CLIST_BLOCK_GROWTH_RATE 4
 #endif
 
+#if defined(CLIST_ALIGNMENT) && ((CLIST_ALIGNMENT) <= 0 || ((CLIST_ALIGNMENT) & ((CLIST_ALIGNMENT) - 1)) != 0)
+#	error "CLIST_ALIGNMENT must be a power of two"
+#endif
+
 #ifndef _POSIX_SOURCE
 #	define _POSIX_SOURCE
 #endif
 
-#include <assert.h>
-#include <errno.h>
-#include <stdbool.h>
-#include <stddef.h>
-#include <stdlib.h>
-#include <string.h>
-#if defined (__unix__) || (defined (__APPLE__) && defined (__MACH__))
-#	define CLIST_HAS_UNISTD
-#	include <unistd.h>
+#include "./clist_core.h"
+#ifdef CLIST_KIND
+#	include "./clist_simd.h"
+#endif
+#ifdef CLIST_PARALLEL
+#	include "./clist_parallel.h"
 #endif
-#if defined(_WIN32) || defined(_WIN32_)
-#	define CLIST_HAS_WINDOWS
-#	include <windows.h>
+#if defined(CLIST_KIND) || defined(CLIST_RADIX_KEY)
+#	include "./clist_radix.h"
 #endif
 
 #ifdef __cplusplus
-#	include <new>
+#	include <type_traits>
 
 extern "C" {
 #endif
 
-#ifndef CLIST_META__
-#define CLIST_META__
-	/* the following is copied from rapidstring - thanks to John Boyer <john.boyer@tutanota.com> */
-	/* include-guarded since it only needs to be evaluated once */
-#	ifdef __GNUC__
-#	define CLIST_GCC_VERSION \
- 	       (__GNUC__ * 10000 + __GNUC_MINOR__ * 100 + __GNUC_PATCHLEVEL__)
-#	else
-#	define CLIST_GCC_VERSION (0)
+#if defined(CLIST_USE_MMAP) && !defined(CLIST_MMAP__)
+#define CLIST_MMAP__
+	/* opt-in backend that gives every heap block its own anonymous mapping.
+	   growing goes through mremap(2), which moves page table entries around
+	   instead of copying the data. mappings start with one page holding
+	   their length since the hooks are never told the old size. */
+#	ifndef __linux__
+#		error "CLIST_USE_MMAP is only supported on Linux"
 #	endif
-
-/* GCC version 2.96 required for branch prediction expectation. */
-#	if CLIST_GCC_VERSION > 29600
-#		define CLIST_EXPECT(expr, val) __builtin_expect((expr), val)
-#	else
-#		define CLIST_EXPECT(expr, val) (expr)
+#	include <sys/mman.h>
+#	ifndef MREMAP_MAYMOVE
+#		error "CLIST_USE_MMAP needs mremap(2) - define _GNU_SOURCE before including any system header"
 #	endif
 
-	/* note that `expr` must be either 0 or 1 for this to work - the 1/0 are not
-	   booleans but instead literal integral values.*/
-	/* https://gcc.gnu.org/onlinedocs/gcc/Other-Builtins.html#index-_005f_005fbuiltin_005fexpect */
-#	define CLIST_LIKELY(expr) CLIST_EXPECT((expr), 1)
-#	define CLIST_UNLIKELY(expr) CLIST_EXPECT((expr), 0)
+CLIST_HELPER void *clist__mmap_alloc(size_t size) {
+	size_t pgsz;
+	size_t len;
+	void *map;
 
-#	ifdef __STDC_VERSION__
-#		define CLIST_C99 (__STDC_VERSION__ >= 199901L)
-#		define CLIST_C11 (__STDC_VERSION__ >= 201112L)
-#	else
-#		define CLIST_C99 (0)
-#		define CLIST_C11 (0)
-#	endif
+	CLIST_PAGE_SIZE(&pgsz);
+	len = pgsz + CLIST_PAGE_ROUND(size, pgsz);
 
-#	define CLIST_ASSERT_RETURN(cond, ret) do { \
-			if (CLIST_UNLIKELY(!(cond))) return ret; \
-		} while (0)
+	map = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (CLIST_UNLIKELY(map == MAP_FAILED)) {
+		/* errno already set */
+		return NULL;
+	}
 
-#	define CLIST_ASSERT(cond) assert(cond) /* don't care about the likelihood here since it's debug-only */
-
-#	define CLIST_ERR ((size_t) -1)
-#	define CLIST_MAX_INDEX ((size_t) -2) /* inclusive */
-
-#	ifndef CLIST_PAGE_SIZE
-#		if defined(CLIST_HAS_UNISTD) && _POSIX_VERSION >= 200112L
-#			define CLIST_PAGE_SIZE(_ptr) do { \
-					*(_ptr) = sysconf(_SC_PAGESIZE); \
-				} while (0)
-#		elif defined(CLIST_HAS_WINDOWS)
-#			define CLIST_PAGE_SIZE(_ptr) do { \
-					SYSTEM_INFO __cl_psz_sysInfo; \
-					GetSystemInfo(&__cl_psz_sysInfo); \
-					*(_ptr) = __cl_psz_sysInfo.dwPageSize; \
-				} while (0)
-#		else
-#			define CLIST_PAGE_SIZE(_ptr) do { \
-					/* sane default :P */ \
-					*(_ptr) = 4096; \
-				} while (0)
-#		endif
+#	if defined(CLIST_MMAP_HUGEPAGES) && defined(MADV_HUGEPAGE)
+	/* only a hint - not fatal if THP is disabled */
+	(void) madvise(map, len, MADV_HUGEPAGE);
 #	endif
+
+	*(size_t *) map = len;
+	return (char *) map + pgsz;
+}
+
+CLIST_HELPER int clist__mmap_realloc(void **ptr, size_t size) {
+	size_t pgsz;
+	size_t len;
+	char *map;
+
+	CLIST_PAGE_SIZE(&pgsz);
+	map = (char *) *ptr - pgsz;
+	len = pgsz + CLIST_PAGE_ROUND(size, pgsz);
+
+	if (len != *(size_t *) map) {
+		void *new_map = mremap(map, *(size_t *) map, len, MREMAP_MAYMOVE);
+		if (CLIST_UNLIKELY(new_map == MAP_FAILED)) {
+			/* errno already set */
+			return 0;
+		}
+
+		map = (char *) new_map;
+		*(size_t *) map = len;
+	}
+
+	*ptr = map + pgsz;
+	return 1;
+}
+
+CLIST_HELPER void clist__mmap_free(void *ptr) {
+	size_t pgsz;
+	char *map;
+
+	CLIST_PAGE_SIZE(&pgsz);
+	map = (char *) ptr - pgsz;
+	(void) munmap(map, *(size_t *) map);
+}
 #endif
 
 /* usage: CLIST_ALLOC(&dest_ptr, size) (it is a statement, not an expression) */
@@ -175,63 +322,85 @@ extern "C" {
 #	ifndef CLIST_FREE
 #		error "Either CLIST_ALLOC or CLIST_REALLOC were defined but CLIST_FREE was not. All three (or none of them) must be defined."
 #	endif
+
+	/* the alignment CLIST_REALLOC() is trusted to keep; see CLIST__PRIVATE(heap_realloc) */
+#	define CLIST_REALLOC_ALIGNMENT CLIST_MALLOC_ALIGNMENT
+#elif defined(CLIST_USE_MMAP)
+	/* mremap(2) keeps mappings page aligned */
+#	define CLIST_REALLOC_ALIGNMENT 4096
+#	define CLIST_ALLOC(_ptrptr, _size) do { \
+			*(_ptrptr) = clist__mmap_alloc((_size)); \
+		} while (0)
+
+#	define CLIST_REALLOC(_success_out, _ptrptr, _size) do { \
+			*(_success_out) = clist__mmap_realloc((_ptrptr), (_size)); \
+		} while (0)
+
+#	define CLIST_FREE(_ptr) clist__mmap_free((_ptr))
+
+	/* anonymous mappings are always zeroed */
+#	define CLIST_CALLOC(_ptrptr, _size) CLIST_ALLOC((_ptrptr), (_size))
+
+#	define CLIST_DISCARD(_ptr, _size) do { \
+			(void) madvise((_ptr), (_size), MADV_DONTNEED); \
+		} while (0)
 #else
-#	if !defined(CLIST_SAFE_REALLOC) && (defined(CLIST_HAS_UNISTD) && _POSIX_VERSION >= 200112L)
+#	if defined(CLIST_ALIGNMENT) && !defined(CLIST_CORE_HAS_ALIGNED_ALLOC)
+#		error "CLIST_ALIGNMENT needs posix_memalign(3) or aligned_alloc(3) - define _POSIX_C_SOURCE to 200112L or later before including any system header, or bring your own CLIST_ALLOC/CLIST_REALLOC/CLIST_FREE"
+#	endif
+#	ifdef CLIST_ALIGNMENT
 #		define CLIST_ALLOC(_ptrptr, _size) do { \
-				size_t __cla_pgsz; \
-				size_t __cla_rlsz; \
-				int __cla_res; \
-				CLIST_PAGE_SIZE(&__cla_pgsz); \
-				__cla_rlsz = (_size); \
-				__cla_rlsz += __cla_rlsz % __cla_pgsz; \
-				__cla_res = posix_memalign((_ptrptr), __cla_pgsz, __cla_rlsz); \
-				if (CLIST_UNLIKELY(__cla_res != 0)) { \
-					(*(_ptrptr)) = NULL; \
-					errno = __cla_res; \
-				} \
+				*(_ptrptr) = clist__alloc_aligned((_size), CLIST_ALIGNMENT); \
 			} while (0)
-#	elif !defined(CLIST_SAFE_REALLOC) && (defined(_ISOC11_SOURCE) || CLIST_C11)
-		/* yes, if you're using this library with -std=c11 on a non-posix system, you
-		   get a bit of an optimization with memory aligned data */
+#	elif defined(CLIST_SAFE_REALLOC)
 #		define CLIST_ALLOC(_ptrptr, _size) do { \
-				size_t __cla_pgsz; \
-				size_t __cla_rlsz; \
-				CLIST_PAGE_SIZE(&__cla_pgsz); \
-				__cla_rlsz = (_size); \
-				__cla_rlsz += __cla_rlsz % __cla_pgsz; \
-				*(_ptrptr) = aligned_alloc(__cla_pgsz, __cla_rlsz); \
+				*(_ptrptr) = clist__alloc_unaligned((_size)); \
 			} while (0)
-#	else /* CLIST_SAFE_REALLOC */
-		/* not much else we can do */
+#	else
 #		define CLIST_ALLOC(_ptrptr, _size) do { \
-				size_t __cla_pgsz; \
-				size_t __cla_rlsz; \
-				CLIST_PAGE_SIZE(&__cla_pgsz); \
-				__cla_rlsz = (_size); \
-				__cla_rlsz += __cla_rlsz % __cla_pgsz; \
-				*(_ptrptr) = malloc(__cla_rlsz); \
+				*(_ptrptr) = clist__alloc((_size)); \
 			} while (0)
 #	endif
 
-	/* no standardized aligned reallocs, unfortunately :/ */
-	/* feel free to define your own */
 #	define CLIST_REALLOC(_success_out, _ptrptr, _size) do { \
-			void *__cla_np; \
-			size_t __cla_pgsz; \
-			size_t __cla_rlsz; \
-			CLIST_PAGE_SIZE(&__cla_pgsz); \
-			__cla_rlsz = (_size); \
-			__cla_rlsz += __cla_rlsz % __cla_pgsz; \
-			__cla_np = realloc(*(_ptrptr), __cla_rlsz); \
-			if (CLIST_UNLIKELY(__cla_np == NULL)) { \
-				*(_success_out) = 0; \
-			} else { \
-				*(_success_out) = 1; \
-				*(_ptrptr) = __cla_np; \
-			} \
+			*(_success_out) = clist__realloc((_ptrptr), (_size)); \
+		} while (0)
+
+#	define CLIST_FREE(_ptr) clist__free((_ptr))
+
+#	ifdef CLIST_SAFE_REALLOC
+		/* blocks that were aligned can't be realloc()'d at all */
+#		define CLIST_REALLOC_ALIGNMENT 0
+#	else
+#		define CLIST_REALLOC_ALIGNMENT CLIST_MALLOC_ALIGNMENT
+#	endif
+
+	/* calloc(3) doesn't align; CLIST_ALIGNMENT lists get the
+	   CLIST_ALLOC() + memset(3) fallback below */
+#	if !defined(CLIST_CALLOC) && !defined(CLIST_ALIGNMENT)
+#		define CLIST_CALLOC(_ptrptr, _size) do { \
+				*(_ptrptr) = clist__calloc((_size)); \
+			} while (0)
+#	endif
+#endif
+
+/* usage: CLIST_DISCARD(ptr, size) - optional; tells the system that the
+   (page aligned) memory isn't needed for now, without giving it back */
+#ifndef CLIST_DISCARD
+#	define CLIST_DISCARD(_ptr, _size) do { \
+			(void) (_ptr); \
+			(void) (_size); \
 		} while (0)
+#endif
 
-#	define CLIST_FREE(_ptr) free((_ptr))
+/* usage: CLIST_CALLOC(&dest_ptr, size) - optional; must return memory that CLIST_FREE can release */
+#ifndef CLIST_CALLOC
+#	define CLIST_CALLOC(_ptrptr, _size) do { \
+			CLIST_ALLOC((_ptrptr), (_size)); \
+			if (CLIST_LIKELY(*(_ptrptr) != NULL)) { \
+				CLIST_MEMSET(*(_ptrptr), 0, (_size)); \
+			} \
+		} while (0)
 #endif
 
 #ifndef CLIST_API
@@ -270,21 +439,69 @@ extern "C" {
 #	endif
 #endif
 
+#ifdef CLIST_ARENA
+#	include "./clist_arena.h"
+#endif
+
+#ifdef CLIST_SWMR
+#	include "./clist_epoch.h"
+#endif
+
+#ifdef CLIST_GROWTH
+#	include "./clist_growth.h"
+#endif
+
+#ifdef CLIST_STATS
+#	include "./clist_stats.h"
+#	define CLIST_STAT(list, counter, n) ((list)->stats.counter += (n))
+	/* owners without counters pass NULL */
+#	define CLIST__STAT_TO(stats, counter, n) ((stats) != NULL ? (void) ((stats)->counter += (n)) : (void) 0)
+#else
+#	define CLIST_STAT(list, counter, n) ((void) 0)
+#	define CLIST__STAT_TO(stats, counter, n) ((void) 0)
+#endif
+
 /*
 	DATATYPES
 */
 
 typedef CLIST_TYPE CLIST(type);
-#define CLIST_STACK(list) ((CLIST(type)*)(&((list)->stack_block[0])))
 #undef CLIST_TYPE /* make sure we use the typedef and not the type itself */
 
 #define CLIST_BLOCK_SIZE_BYTES (CLIST_BLOCK_SIZE * sizeof(CLIST(type)))
+#define CLIST_INLINE_BYTES (CLIST_INLINE_CAPACITY * sizeof(CLIST(type)))
+
+#if CLIST_INLINE_CAPACITY > 0
+#	define CLIST_STACK(list) ((CLIST(type)*)(&((list)->stack_block[0])))
+#else
+#	define CLIST_STACK(list) ((CLIST(type)*) NULL)
+#endif
+#define CLIST_ON_HEAP(list) ((list)->block != CLIST_STACK(list))
+
+#if defined(__cplusplus) && !defined(CLIST_RELOCATABLE)
+#	define CLIST_RELOCATABLE (std::is_trivially_copyable<CLIST(type)>::value)
+#endif
 
 typedef struct CLIST_T {
 	size_t count;
-	size_t blocks;
-	CLIST(type) *block;
-	char stack_block[CLIST_BLOCK_SIZE_BYTES];
+	size_t capacity; /* number of elements `block` can hold */
+	CLIST(type) *block; /* either the stack block or a heap block */
+#ifdef CLIST_ARENA
+	clist_arena *arena;
+#endif
+#ifdef CLIST_GROWTH
+	const clist_growth *growth; /* NULL for CLIST_BLOCK_GROWTH_RATE */
+#endif
+#ifdef CLIST_STATS
+	clist_stats stats; /* since init or the last flush */
+#endif
+#if CLIST_INLINE_CAPACITY > 0
+#	ifdef CLIST_ALIGNMENT
+	CLIST_ALIGNAS(CLIST_ALIGNMENT) char stack_block[CLIST_INLINE_BYTES];
+#	else
+	char stack_block[CLIST_INLINE_BYTES];
+#	endif
+#endif
 } CLIST_T;
 
 /*
@@ -294,41 +511,246 @@ typedef struct CLIST_T {
 CLIST_API void CLIST(init) (CLIST_T *list) {
 	CLIST_ASSERT(list != NULL);
 	list->count = 0;
-	list->blocks = 0;
+	list->capacity = CLIST_INLINE_CAPACITY;
+	list->block = CLIST_STACK(list);
+#ifdef CLIST_ARENA
+	list->arena = NULL;
+#endif
+#ifdef CLIST_GROWTH
+	list->growth = NULL;
+#endif
+#ifdef CLIST_STATS
+	CLIST_MEMSET(&list->stats, 0, sizeof(list->stats));
+	list->stats.peak_capacity = list->capacity;
+#endif
 }
 
-CLIST_API int CLIST(init_capacity) (CLIST_T *list, size_t n_elems) {
+#ifdef CLIST_ARENA
+/* initializes a list whose heap blocks come out of `arena` */
+CLIST_API void CLIST(init_arena) (CLIST_T *list, clist_arena *arena) {
+	CLIST(init)(list);
+	list->arena = arena;
+}
+#endif
+
+#ifdef CLIST_GROWTH
+/* how the list grows from now on; see clist_growth.h */
+CLIST_API void CLIST(set_growth) (CLIST_T *list, const clist_growth *growth) {
 	CLIST_ASSERT(list != NULL);
+	list->growth = growth;
+}
+#endif
 
-	list->count = n_elems;
+#ifdef CLIST_STATS
+static clist_stats_type CLIST(stats_totals) = {
+	CLIST__STATS_NAME(CLIST_T),
+	sizeof(CLIST(type)),
+	{ 0, 0, 0, 0, 0, 0, 0, 0, 0 },
+	0,
+	0,
+	NULL
+};
 
-	if (CLIST_LIKELY(n_elems < CLIST_BLOCK_SIZE)) {
-		list->blocks = 0;
-		list->count = n_elems;
-		CLIST_MEMSET(list->stack_block, 0, n_elems * sizeof(CLIST(type)));
-		return 0;
-	}
+/* the list's counters since it was initialized (or last flushed) */
+CLIST_API void CLIST(stats) (const CLIST_T *list, clist_stats *out) {
+	CLIST_ASSERT(list != NULL);
+	CLIST_ASSERT(out != NULL);
 
-	list->blocks = (n_elems / CLIST_BLOCK_SIZE) + 1;
+	*out = list->stats;
+	out->lists = 1;
+	out->count = list->count;
+	out->capacity = list->capacity;
+}
 
-	CLIST_ALLOC((void **) &list->block, list->blocks * CLIST_BLOCK_SIZE_BYTES);
-	if (CLIST_UNLIKELY((void*) list->block == NULL)) {
-		/* repair list */
-		list->blocks = 0;
-		list->block = CLIST_STACK(list);
-		list->count = 0;
+/* adds the list's counters to the totals of its type and starts them
+   over; clist_free() does this on its own */
+CLIST_API void CLIST(stats_flush) (CLIST_T *list) {
+	CLIST_ASSERT(list != NULL);
+
+	clist__stats_fold(&CLIST(stats_totals), &list->stats, 0);
+	CLIST_MEMSET(&list->stats, 0, sizeof(list->stats));
+	list->stats.peak_capacity = list->capacity;
+}
+
+/* the totals of every list of this type that has been freed or flushed */
+CLIST_API void CLIST(stats_type) (clist_stats *out) {
+	clist_stats_snapshot(&CLIST(stats_totals), out);
+}
+#endif
+
+/* CLIST_REALLOC(), except that CLIST_ALIGNMENT is kept. returns 1 on
+   success, or 0 with errno set, leaving the block as it was. */
+CLIST_API int CLIST__PRIVATE(heap_realloc) (void **ptr, size_t old_size, size_t size) {
+	int success;
+
+#ifdef CLIST_ALIGNMENT
+	if ((size_t) CLIST_ALIGNMENT > (size_t) CLIST_REALLOC_ALIGNMENT) {
+		/* realloc() could move the block somewhere that isn't aligned
+		   (and then it's too late to back out), so the block is only
+		   grown where it is, if CLIST_EXPAND() can, and moved by hand
+		   otherwise */
+		void *moved;
+
+#	ifdef CLIST_EXPAND
+		CLIST_EXPAND(&success, *ptr, size);
+		if (success) {
+			return 1;
+		}
+#	endif
+
+		CLIST_ALLOC(&moved, size);
+		if (CLIST_UNLIKELY(moved == NULL)) {
+			/* errno already set */
+			return 0;
+		}
+
+		CLIST_MEMCPY(moved, *ptr, old_size < size ? old_size : size);
+		CLIST_FREE(*ptr);
+		*ptr = moved;
 		return 1;
 	}
+#endif
 
-	return 0;
+	(void) old_size;
+	CLIST_REALLOC(&success, ptr, size);
+	return success;
+}
+
+/*
+	all heap memory a list uses goes through the following. it is
+	accounted to an owner: the arena it comes out of and the counters it
+	shows up in, if there are any. that's the list itself, or something
+	built on lists' memory such as a segmented list.
+*/
+
+struct clist_arena;
+struct clist_stats;
+
+#ifdef CLIST_ARENA
+#	define CLIST__OWNER_ARENA(owner) ((owner)->arena)
+#else
+#	define CLIST__OWNER_ARENA(owner) ((struct clist_arena *) NULL)
+#endif
+#ifdef CLIST_STATS
+#	define CLIST__OWNER_STATS(owner) (&(owner)->stats)
+#else
+#	define CLIST__OWNER_STATS(owner) ((struct clist_stats *) NULL)
+#endif
+
+CLIST_API void *CLIST__PRIVATE(owned_alloc) (struct clist_arena *arena, struct clist_stats *stats, size_t size, bool zeroed) {
+	void *ptr;
+
+#ifdef CLIST_ARENA
+	if (arena != NULL) {
+#	ifdef CLIST_ALIGNMENT
+		ptr = clist_arena_alloc_aligned(arena, size, CLIST_ALIGNMENT);
+#	else
+		ptr = clist_arena_alloc(arena, size);
+#	endif
+		if (CLIST_LIKELY(ptr != NULL)) {
+			if (zeroed) {
+				CLIST_MEMSET(ptr, 0, size);
+			}
+			CLIST__STAT_TO(stats, bytes_allocated, size);
+		}
+		return ptr;
+	}
+#else
+	(void) arena;
+#endif
+
+	if (zeroed) {
+		CLIST_CALLOC(&ptr, size);
+	} else {
+		CLIST_ALLOC(&ptr, size);
+	}
+
+	if (CLIST_LIKELY(ptr != NULL)) {
+		CLIST__STAT_TO(stats, bytes_allocated, size);
+	}
+
+#ifdef CLIST_ALIGNMENT
+	/* custom hooks have to honor it, too */
+	CLIST_ASSERT(ptr == NULL || (size_t) ptr % CLIST_ALIGNMENT == 0);
+#endif
+
+	(void) stats;
+	return ptr;
+}
+
+CLIST_API int CLIST__PRIVATE(owned_realloc) (struct clist_arena *arena, struct clist_stats *stats, void **ptr, size_t old_size, size_t size) {
+	int realloc_success;
+#ifdef CLIST_STATS
+	void *old_ptr = *ptr;
+#endif
+
+#ifdef CLIST_ARENA
+	if (arena != NULL) {
+#	ifdef CLIST_ALIGNMENT
+		realloc_success = !clist_arena_realloc_aligned(arena, ptr, old_size, size, CLIST_ALIGNMENT);
+#	else
+		realloc_success = !clist_arena_realloc(arena, ptr, old_size, size);
+#	endif
+	} else
+#endif
+	{
+		realloc_success = CLIST__PRIVATE(heap_realloc)(ptr, old_size, size);
+	}
+
+#ifdef CLIST_STATS
+	if (CLIST_LIKELY(realloc_success)) {
+		CLIST__STAT_TO(stats, bytes_allocated, size);
+		if (*ptr != old_ptr) {
+			/* it had to move */
+			CLIST__STAT_TO(stats, bytes_copied, old_size < size ? old_size : size);
+		}
+	}
+#endif
+	(void) arena;
+	(void) stats;
+
+	return !realloc_success;
+}
+
+CLIST_API void CLIST__PRIVATE(owned_free) (struct clist_arena *arena, void *ptr) {
+#ifdef CLIST_ARENA
+	if (arena != NULL) {
+		clist_arena_release(arena, ptr);
+		return;
+	}
+#else
+	(void) arena;
+#endif
+
+	CLIST_FREE(ptr);
+}
+
+CLIST_API void *CLIST(mem_alloc) (CLIST_T *list, size_t size, bool zeroed) {
+	(void) list;
+	return CLIST__PRIVATE(owned_alloc)(CLIST__OWNER_ARENA(list), CLIST__OWNER_STATS(list), size, zeroed);
+}
+
+CLIST_API int CLIST(mem_realloc) (CLIST_T *list, void **ptr, size_t old_size, size_t size) {
+	(void) list;
+	return CLIST__PRIVATE(owned_realloc)(CLIST__OWNER_ARENA(list), CLIST__OWNER_STATS(list), ptr, old_size, size);
+}
+
+CLIST_API void CLIST(mem_free) (CLIST_T *list, void *ptr) {
+	(void) list;
+	CLIST__PRIVATE(owned_free)(CLIST__OWNER_ARENA(list), ptr);
 }
 
 CLIST_API void CLIST(free) (CLIST_T *list) {
 	CLIST_ASSERT(list != NULL);
-	CLIST_ASSERT(list->blocks == 0 || list->block != NULL);
 
-	if (list->blocks > 1) {
-		free(list->block);
+#ifdef CLIST_STATS
+	list->stats.count = list->count;
+	list->stats.capacity = list->capacity;
+	clist__stats_fold(&CLIST(stats_totals), &list->stats, 1);
+#endif
+
+	if (CLIST_ON_HEAP(list)) {
+		CLIST(mem_free)(list, list->block);
 	}
 }
 
@@ -342,148 +764,1443 @@ CLIST_API bool CLIST(empty) (const CLIST_T *list) {
 	return list->count == 0;
 }
 
-CLIST_API int CLIST(expand) (CLIST_T *list, size_t block_idx) {
+#ifdef __cplusplus
+/* moves `n_elems` elements from `src` over to `dest`, ending the lifetime
+   of the originals. the ranges may overlap. */
+CLIST_API void CLIST(relocate) (CLIST(type) *dest, CLIST(type) *src, size_t n_elems) {
+	clist__relocate(dest, src, n_elems, CLIST_RELOCATABLE);
+}
+#endif
+
+/* the number of elements the list can hold before it has to allocate again */
+CLIST_API size_t CLIST(capacity) (const CLIST_T *list) {
+	CLIST_ASSERT(list != NULL);
+	return list->capacity;
+}
+
+/* rounds `n_elems` up to whole blocks; returns non-zero
+   (and sets errno) if that would be too large */
+CLIST_API int CLIST(capacity_for) (size_t n_elems, size_t *capacity_out) {
+	return clist__capacity_for(n_elems, sizeof(CLIST(type)), CLIST_BLOCK_SIZE, capacity_out);
+}
+
+/* moves the list's storage to a heap block of exactly `new_capacity`
+   elements, or back onto the stack block if `new_capacity` fits in it.
+   the elements must fit. */
+CLIST_API int CLIST(set_capacity) (CLIST_T *list, size_t new_capacity) {
 	CLIST_ASSERT(list != NULL);
+	CLIST_ASSERT(list->count <= new_capacity);
+
+	if (new_capacity <= CLIST_INLINE_CAPACITY) {
+		if (CLIST_ON_HEAP(list)) {
+			CLIST(type) *heap = list->block;
 
-	/* this is the case when a high capacity has been set */
-	if (CLIST_UNLIKELY(block_idx < list->blocks)) {
+#if CLIST_INLINE_CAPACITY > 0
+#	ifdef __cplusplus
+			CLIST(relocate)(CLIST_STACK(list), heap, list->count);
+#	else
+			CLIST_MEMCPY((void *) CLIST_STACK(list), heap, list->count * sizeof(CLIST(type)));
+#	endif
+			CLIST_STAT(list, bytes_copied, list->count * sizeof(CLIST(type)));
+#endif
+			CLIST(mem_free)(list, heap);
+		}
+
+		list->block = CLIST_STACK(list);
+		list->capacity = CLIST_INLINE_CAPACITY;
 		return 0;
 	}
 
-	if (CLIST_LIKELY(block_idx >= 2)) {
-		int realloc_success;
+#ifdef __cplusplus
+	if (!CLIST_RELOCATABLE && CLIST_ON_HEAP(list)) {
+		/* realloc() would move the elements behind their back */
+		CLIST(type) *heap = (CLIST(type) *) CLIST(mem_alloc)(list, new_capacity * sizeof(CLIST(type)), false);
 
-		CLIST_ASSERT(list->block != NULL);
-		CLIST_ASSERT(list->block != CLIST_STACK(list));
-		CLIST_ASSERT(list->blocks >= 2);
+		if (CLIST_UNLIKELY(heap == NULL)) {
+			/* errno already set */
+			return 1;
+		}
 
-		CLIST_REALLOC(
-			&realloc_success,
+		CLIST(relocate)(heap, list->block, list->count);
+		CLIST_STAT(list, bytes_copied, list->count * sizeof(CLIST(type)));
+		CLIST(mem_free)(list, list->block);
+		list->block = heap;
+	} else
+#endif
+	if (CLIST_LIKELY(CLIST_ON_HEAP(list))) {
+		if (CLIST_UNLIKELY(CLIST(mem_realloc)(
+			list,
 			(void **) &list->block,
-			(
-				list->blocks * CLIST_BLOCK_GROWTH_RATE
-			) * CLIST_BLOCK_SIZE_BYTES
-		);
-
-		if (CLIST_UNLIKELY(!realloc_success)) {
-			/* blocks are unmodified */
+			list->capacity * sizeof(CLIST(type)),
+			new_capacity * sizeof(CLIST(type))
+		) != 0)) {
+			/* capacity is unmodified */
 			/* errno already set */
 			return 1;
 		}
+	} else {
+		CLIST(type) *heap = (CLIST(type) *) CLIST(mem_alloc)(list, new_capacity * sizeof(CLIST(type)), false);
 
-		list->blocks *= CLIST_BLOCK_GROWTH_RATE;
-	} else if (CLIST_UNLIKELY(block_idx == 0)) {
-		CLIST_ASSERT(list->blocks == 0);
-
-		list->block = CLIST_STACK(list);
-		list->blocks = 1;
-	} else if (CLIST_UNLIKELY(block_idx == 1)) {
-		CLIST_ASSERT(list->block == CLIST_STACK(list));
-		CLIST_ASSERT(list->blocks == 1);
-
-		CLIST_ALLOC((void **) &list->block, CLIST_BLOCK_GROWTH_RATE * CLIST_BLOCK_SIZE_BYTES);
-
-		if (CLIST_UNLIKELY(list->block == NULL)) {
-			/* repair the list */
-			list->block = CLIST_STACK(list);
+		if (CLIST_UNLIKELY(heap == NULL)) {
 			/* errno already set */
 			return 1;
 		}
 
-		CLIST_MEMCPY(list->block, CLIST_STACK(list), CLIST_BLOCK_SIZE_BYTES);
-		list->blocks = CLIST_BLOCK_GROWTH_RATE;
+#if CLIST_INLINE_CAPACITY > 0
+#	ifdef __cplusplus
+		CLIST(relocate)(heap, CLIST_STACK(list), list->count);
+#	else
+		/* new_capacity > CLIST_INLINE_CAPACITY, so this fits */
+		CLIST_MEMCPY((void *) heap, CLIST_STACK(list), CLIST_INLINE_BYTES);
+#	endif
+		CLIST_STAT(list, promotions, 1);
+		CLIST_STAT(list, bytes_copied, list->count * sizeof(CLIST(type)));
+#endif
+
+		list->block = heap;
 	}
 
-	return 0;
-}
+#ifdef CLIST_STATS
+	if (new_capacity > list->capacity) {
+		CLIST_STAT(list, expansions, 1);
+		if (new_capacity > list->stats.peak_capacity) {
+			list->stats.peak_capacity = new_capacity;
+		}
+	}
+#endif
 
-CLIST_API CLIST(type) CLIST_REF_PTR CLIST(get) (const CLIST_T *list, size_t index) {
-	CLIST_ASSERT(list != NULL);
-	CLIST_ASSERT(index < list->count);
-	CLIST_ASSERT(index <= CLIST_MAX_INDEX);
-	CLIST_ASSERT(index != CLIST_ERR);
-	return CLIST_REF_ADDROF list->block[index];
+	list->capacity = new_capacity;
+	return 0;
 }
 
-CLIST_API size_t CLIST(add) (CLIST_T *list, const CLIST(type) CLIST_REF val) {
-	size_t idx = list->count++;
-	size_t block = idx / CLIST_BLOCK_SIZE;
+CLIST_API int CLIST(grow) (CLIST_T *list, size_t n_elems) {
+	size_t new_capacity;
 
 	CLIST_ASSERT(list != NULL);
-	CLIST_ASSERT(list->count <= CLIST_MAX_INDEX);
 
-	if (CLIST_UNLIKELY(idx > CLIST_MAX_INDEX)) {
-		errno = EOVERFLOW;
-		return CLIST_ERR;
+	/* this is also the case when a high capacity has been set */
+	if (CLIST_LIKELY(n_elems <= list->capacity)) {
+		return 0;
 	}
 
-	if (CLIST_UNLIKELY(block == list->blocks)) {
-		if (CLIST_UNLIKELY(CLIST(expand)(list, block) != 0)) {
-			return CLIST_ERR;
+#ifdef CLIST_GROWTH
+	if (list->growth != NULL) {
+		if (CLIST_UNLIKELY(clist__growth_capacity(list->growth, list->capacity, n_elems, sizeof(CLIST(type)), CLIST_BLOCK_SIZE, &new_capacity) != 0)) {
+			return 1;
 		}
-	}
 
-#ifdef __cplusplus
-	new (&list->block[idx]) CLIST(type)(val);
-#else
-	list->block[idx] = val;
+		return CLIST(set_capacity)(list, new_capacity);
+	}
 #endif
-	return idx;
-}
 
-#ifdef CLIST_MEMSWAP
-CLIST_API int CLIST(swap) (CLIST_T *list_a, CLIST_T *list_b) {
-	size_t tmp_size;
-	CLIST(type) *tmp_ptr;
+	if (CLIST_UNLIKELY(clist__grow_capacity(
+		list->capacity,
+		n_elems,
+		sizeof(CLIST(type)),
+		CLIST_BLOCK_SIZE,
+		CLIST_BLOCK_GROWTH_RATE,
+		&new_capacity
+	) != 0)) {
+		return 1;
+	}
 
-	CLIST_ASSERT(list_a != NULL);
-	CLIST_ASSERT(list_b != NULL);
+	return CLIST(set_capacity)(list, new_capacity);
+}
 
-	if (list_a->blocks && list_b->blocks) {
-		tmp_size = list_a->blocks;
-		tmp_ptr = list_a->block;
-		list_a->blocks = list_b->blocks;
-		list_a->block = list_b->block;
-		list_b->blocks = tmp_size;
-		list_b->block = tmp_ptr;
-	} else if (!list_a->blocks && !list_b->blocks) {
-		return CLIST_MEMSWAP(&list_a->stack_block[0], &list_b->stack_block[0], sizeof(CLIST_BLOCK_SIZE_BYTES));
-	} else {
-		CLIST_T *stack_list;
-		CLIST_T *heap_list;
+CLIST_API int CLIST(expand) (CLIST_T *list, size_t block_idx) {
+	CLIST_ASSERT(list != NULL);
+	CLIST_ASSERT(block_idx < CLIST_MAX_INDEX / CLIST_BLOCK_SIZE);
+	return CLIST(grow)(list, (block_idx + 1) * CLIST_BLOCK_SIZE);
+}
 
-		if (list_a->blocks) {
-			heap_list = list_a;
-			stack_list = list_b;
-		} else {
-			heap_list = list_b;
-			stack_list = list_a;
-		}
+/* makes room for at least `n_elems` elements without changing the count.
+   unlike growing through add(), exactly as many blocks as are needed
+   are allocated. */
+CLIST_API int CLIST(reserve) (CLIST_T *list, size_t n_elems) {
+	size_t new_capacity;
+
+	CLIST_ASSERT(list != NULL);
 
-		CLIST_ASSERT(heap_list->blocks > 0);
-		CLIST_ASSERT(heap_list->block != CLIST_STACK(heap_list));
-		CLIST_ASSERT(stack_list->blocks == 0);
-		CLIST_ASSERT(stack_list->block == CLIST_STACK(stack_list));
+	if (n_elems <= list->capacity) {
+		return 0;
+	}
 
-		stack_list->blocks = heap_list->blocks;
-		stack_list->block = heap_list->block;
-		heap_list->blocks = 0;
-		heap_list->block = CLIST_STACK(heap_list);
-		CLIST_MEMCPY(CLIST_STACK(list_a), CLIST_STACK(list_b), sizeof(CLIST_BLOCK_SIZE_BYTES));
+	if (CLIST_UNLIKELY(CLIST(capacity_for)(n_elems, &new_capacity) != 0)) {
+		return 1;
 	}
 
-	return 0;
+	return CLIST(set_capacity)(list, new_capacity);
 }
-#endif
+
+/* gives back any blocks that aren't needed to hold the current elements,
+   moving them back onto the stack block if they fit there */
+CLIST_API int CLIST(shrink) (CLIST_T *list) {
+	size_t new_capacity;
+
+	CLIST_ASSERT(list != NULL);
+
+	if (!CLIST_ON_HEAP(list)) {
+		return 0;
+	}
+
+	if (list->count <= CLIST_INLINE_CAPACITY) {
+		return CLIST(set_capacity)(list, CLIST_INLINE_CAPACITY);
+	}
+
+	if (CLIST_UNLIKELY(CLIST(capacity_for)(list->count, &new_capacity) != 0)) {
+		return 1;
+	}
+
+	if (new_capacity >= list->capacity) {
+		return 0;
+	}
+
+	return CLIST(set_capacity)(list, new_capacity);
+}
+
+/* lets the system reclaim the pages behind the unused capacity of a heap
+   block while keeping the capacity itself (see CLIST_DISCARD) */
+CLIST_API void CLIST(trim) (CLIST_T *list) {
+	size_t pgsz;
+	size_t misalign;
+	size_t from;
+	size_t to;
+
+	CLIST_ASSERT(list != NULL);
+
+	if (!CLIST_ON_HEAP(list)) {
+		return;
+	}
+
+	CLIST_PAGE_SIZE(&pgsz);
+
+	/* offsets from the start of the page the block begins on */
+	misalign = (size_t) list->block % pgsz;
+	from = CLIST_PAGE_ROUND(misalign + list->count * sizeof(CLIST(type)), pgsz);
+	to = ((misalign + list->capacity * sizeof(CLIST(type))) / pgsz) * pgsz;
+
+	if (from < to) {
+		CLIST_DISCARD((char *) list->block - misalign + from, to - from);
+	}
+}
+
+/* sets the count to `n_elems`. new elements are zeroed (value-initialized
+   under C++); removed elements are destructed under C++. */
+CLIST_API int CLIST(resize) (CLIST_T *list, size_t n_elems) {
+	CLIST_ASSERT(list != NULL);
+
+	if (CLIST_UNLIKELY(n_elems > CLIST_MAX_INDEX)) {
+		errno = EOVERFLOW;
+		return 1;
+	}
+
+	if (n_elems <= list->count) {
+#ifdef __cplusplus
+		size_t i;
+		for (i = n_elems; i < list->count; i++) {
+			list->block[i].~CLIST(type)();
+		}
+#endif
+		list->count = n_elems;
+		return 0;
+	}
+
+#ifdef __cplusplus
+	if (CLIST_UNLIKELY(CLIST(grow)(list, n_elems) != 0)) {
+		return 1;
+	}
+
+	{
+		size_t i;
+		for (i = list->count; i < n_elems; i++) {
+			new (&list->block[i]) CLIST(type)();
+		}
+	}
+#else
+	if (n_elems > list->capacity && !CLIST_ON_HEAP(list)) {
+		/* a brand new heap block - let the allocator hand us
+		   pages that are already zero instead of memset()ing them */
+		CLIST(type) *heap;
+		size_t new_capacity;
+
+		if (CLIST_UNLIKELY(CLIST(capacity_for)(n_elems, &new_capacity) != 0)) {
+			return 1;
+		}
+
+		heap = (CLIST(type) *) CLIST(mem_alloc)(list, new_capacity * sizeof(CLIST(type)), true);
+		if (CLIST_UNLIKELY(heap == NULL)) {
+			/* errno already set */
+			return 1;
+		}
+
+		if (list->count > 0) {
+			CLIST_MEMCPY(heap, list->block, list->count * sizeof(CLIST(type)));
+		}
+
+#ifdef CLIST_STATS
+		CLIST_STAT(list, expansions, 1);
+		if (CLIST_INLINE_CAPACITY > 0) {
+			CLIST_STAT(list, promotions, 1);
+		}
+		CLIST_STAT(list, bytes_copied, list->count * sizeof(CLIST(type)));
+		if (new_capacity > list->stats.peak_capacity) {
+			list->stats.peak_capacity = new_capacity;
+		}
+#endif
+
+		list->block = heap;
+		list->capacity = new_capacity;
+	} else {
+		if (CLIST_UNLIKELY(CLIST(grow)(list, n_elems) != 0)) {
+			return 1;
+		}
+
+		CLIST_MEMSET(&list->block[list->count], 0, (n_elems - list->count) * sizeof(CLIST(type)));
+	}
+#endif
+
+	list->count = n_elems;
+	return 0;
+}
+
+CLIST_API int CLIST(init_capacity) (CLIST_T *list, size_t n_elems) {
+	CLIST_ASSERT(list != NULL);
+
+	CLIST(init)(list);
+
+	if (CLIST_UNLIKELY(CLIST(resize)(list, n_elems) != 0)) {
+		/* errno already set */
+		return 1;
+	}
+
+	return 0;
+}
+
+CLIST_API CLIST(type) CLIST_REF_PTR CLIST(get) (const CLIST_T *list, size_t index) {
+	CLIST_ASSERT(list != NULL);
+	CLIST_ASSERT(index < list->count);
+	CLIST_ASSERT(index <= CLIST_MAX_INDEX);
+	CLIST_ASSERT(index != CLIST_ERR);
+	return CLIST_REF_ADDROF list->block[index];
+}
+
+/* makes sure there's room for at least one more element */
+CLIST_API int CLIST(make_room) (CLIST_T *list) {
+	CLIST_ASSERT(list != NULL);
+
+	if (CLIST_LIKELY(list->count < list->capacity)) {
+		return 0;
+	}
+
+	if (CLIST_UNLIKELY(list->count >= CLIST_MAX_INDEX)) {
+		errno = EOVERFLOW;
+		return 1;
+	}
+
+	return CLIST(grow)(list, list->count + 1);
+}
+
+/* the elements are always laid out contiguously; the pointer is valid
+   until the list next changes its capacity (or is moved/swapped) */
+CLIST_API CLIST(type) *CLIST(data) (const CLIST_T *list) {
+	CLIST_ASSERT(list != NULL);
+#ifdef CLIST_ALIGNMENT
+	return (CLIST(type) *) CLIST_ASSUME_ALIGNED(list->block, CLIST_ALIGNMENT);
+#else
+	return list->block;
+#endif
+}
+
+CLIST_API size_t CLIST(add) (CLIST_T *list, const CLIST(type) CLIST_REF val) {
+	size_t idx;
+
+	CLIST_ASSERT(list != NULL);
+
+	idx = list->count;
+
+	if (CLIST_UNLIKELY(idx == list->capacity)) {
+#if defined(__cplusplus) && !defined(CLIST_NO_REF)
+		if (&val >= list->block && &val < list->block + idx) {
+			/* `val` lives in the list itself, which is about to move */
+			CLIST(type) tmp(val);
+
+			if (CLIST_UNLIKELY(CLIST(make_room)(list) != 0)) {
+				return CLIST_ERR;
+			}
+
+			new (&list->block[idx]) CLIST(type)(std::move(tmp));
+			list->count = idx + 1;
+			CLIST_STAT(list, adds, 1);
+			return idx;
+		}
+#endif
+
+		if (CLIST_UNLIKELY(idx >= CLIST_MAX_INDEX)) {
+			errno = EOVERFLOW;
+			return CLIST_ERR;
+		}
+
+		if (CLIST_UNLIKELY(CLIST(grow)(list, idx + 1) != 0)) {
+			return CLIST_ERR;
+		}
+	}
+
+#ifdef __cplusplus
+	new (&list->block[idx]) CLIST(type)(val);
+#else
+	list->block[idx] = val;
+#endif
+	list->count = idx + 1;
+	CLIST_STAT(list, adds, 1);
+	return idx;
+}
+
+/* copies `n_elems` elements from `vals` onto the end of the list, growing
+   the list at most once; `vals` must not point into the list itself.
+   returns the index of the first added element or CLIST_ERR on failure,
+   in which case the list is left untouched. */
+CLIST_API size_t CLIST(add_n) (CLIST_T *list, const CLIST(type) *vals, size_t n_elems) {
+	size_t idx;
+
+	CLIST_ASSERT(list != NULL);
+	CLIST_ASSERT(vals != NULL || n_elems == 0);
+
+	idx = list->count;
+
+	if (CLIST_UNLIKELY(n_elems > CLIST_MAX_INDEX - idx)) {
+		errno = EOVERFLOW;
+		return CLIST_ERR;
+	}
+
+	if (CLIST_UNLIKELY(CLIST(grow)(list, idx + n_elems) != 0)) {
+		return CLIST_ERR;
+	}
+
+#ifdef __cplusplus
+	{
+		CLIST(type) *dest = &list->block[idx];
+		const CLIST(type) *end = vals + n_elems;
+		while (vals != end) {
+			new (dest++) CLIST(type)(*vals++);
+		}
+	}
+#else
+	CLIST_MEMCPY(&list->block[idx], vals, n_elems * sizeof(CLIST(type)));
+#endif
+
+	list->count = idx + n_elems;
+	CLIST_STAT(list, adds, n_elems);
+	return idx;
+}
+
+/* inserts `val` at `index`, shifting everything after it up by one;
+   `index` may be equal to the count. returns `index` or CLIST_ERR. */
+CLIST_API size_t CLIST(insert) (CLIST_T *list, size_t index, const CLIST(type) CLIST_REF val) {
+	size_t count;
+#ifdef __cplusplus
+	const CLIST(type) *src = &val;
+	size_t src_idx = CLIST_ERR;
+#endif
+
+	CLIST_ASSERT(list != NULL);
+	CLIST_ASSERT(index <= list->count);
+
+	count = list->count;
+
+	if (CLIST_UNLIKELY(count >= CLIST_MAX_INDEX)) {
+		errno = EOVERFLOW;
+		return CLIST_ERR;
+	}
+
+#ifdef __cplusplus
+	/* `val` might live in the list itself and be moved around below */
+	if (count > 0 && src >= list->block && src < list->block + count) {
+		src_idx = (size_t) (src - list->block);
+	}
+#endif
+
+	if (CLIST_UNLIKELY(CLIST(grow)(list, count + 1) != 0)) {
+		return CLIST_ERR;
+	}
+
+	if (index < count) {
+#ifdef __cplusplus
+		CLIST(relocate)(&list->block[index + 1], &list->block[index], count - index);
+#else
+		memmove((void *) &list->block[index + 1], &list->block[index], (count - index) * sizeof(CLIST(type)));
+#endif
+	}
+
+#ifdef __cplusplus
+	if (src_idx != CLIST_ERR) {
+		src = &list->block[src_idx + (src_idx >= index)];
+	}
+
+	new (&list->block[index]) CLIST(type)(*src);
+#else
+	list->block[index] = val;
+#endif
+
+	list->count = count + 1;
+	CLIST_STAT(list, adds, 1);
+	return index;
+}
+
+/* removes the last element and returns it */
+CLIST_API CLIST(type) CLIST(pop) (CLIST_T *list) {
+	CLIST_ASSERT(list != NULL);
+	CLIST_ASSERT(list->count > 0);
+
+#ifdef __cplusplus
+	CLIST(type) val(std::move(list->block[--list->count]));
+	list->block[list->count].~CLIST(type)();
+	return val;
+#else
+	return list->block[--list->count];
+#endif
+}
+
+/* removes the element at `index`, shifting everything after it down by one */
+CLIST_API void CLIST(remove) (CLIST_T *list, size_t index) {
+	CLIST_ASSERT(list != NULL);
+	CLIST_ASSERT(index < list->count);
+
+#ifdef __cplusplus
+	list->block[index].~CLIST(type)();
+#endif
+
+	if (index < --list->count) {
+#ifdef __cplusplus
+		CLIST(relocate)(&list->block[index], &list->block[index + 1], list->count - index);
+#else
+		memmove((void *) &list->block[index], &list->block[index + 1], (list->count - index) * sizeof(CLIST(type)));
+#endif
+	}
+}
+
+/* removes the element at `index` by moving the last element into its
+   place. O(1), but does not preserve the order of the list. */
+CLIST_API void CLIST(swap_remove) (CLIST_T *list, size_t index) {
+	CLIST_ASSERT(list != NULL);
+	CLIST_ASSERT(index < list->count);
+
+#ifdef __cplusplus
+	list->block[index].~CLIST(type)();
+#endif
+
+	if (CLIST_LIKELY(index != --list->count)) {
+#ifdef __cplusplus
+		CLIST(relocate)(&list->block[index], &list->block[list->count], 1);
+#else
+		CLIST_MEMCPY((void *) &list->block[index], &list->block[list->count], sizeof(CLIST(type)));
+#endif
+	}
+}
+
+/* removes every element but keeps the capacity around */
+CLIST_API void CLIST(clear) (CLIST_T *list) {
+	CLIST_ASSERT(list != NULL);
+
+#ifdef __cplusplus
+	{
+		size_t i;
+		for (i = 0; i < list->count; i++) {
+			list->block[i].~CLIST(type)();
+		}
+	}
+#endif
+
+	list->count = 0;
+}
+
+/* moves the contents of `src` into `dest`, which must be uninitialized
+   (or already freed). heap blocks change hands; elements on the stack
+   block are moved over. `src` is left empty but still initialized. */
+CLIST_API void CLIST(move) (CLIST_T *dest, CLIST_T *src) {
+	CLIST_ASSERT(dest != NULL);
+	CLIST_ASSERT(src != NULL);
+	CLIST_ASSERT(dest != src);
+
+	dest->count = src->count;
+	dest->capacity = src->capacity;
+#ifdef CLIST_ARENA
+	dest->arena = src->arena;
+#endif
+#ifdef CLIST_GROWTH
+	dest->growth = src->growth;
+#endif
+#ifdef CLIST_STATS
+	/* the counters go with the elements */
+	dest->stats = src->stats;
+	CLIST_MEMSET(&src->stats, 0, sizeof(src->stats));
+	src->stats.peak_capacity = CLIST_INLINE_CAPACITY;
+#endif
+
+	if (CLIST_ON_HEAP(src)) {
+		dest->block = src->block;
+	} else {
+		dest->block = CLIST_STACK(dest);
+#if CLIST_INLINE_CAPACITY > 0
+#	ifdef __cplusplus
+		CLIST(relocate)(CLIST_STACK(dest), CLIST_STACK(src), src->count);
+#	else
+		CLIST_MEMCPY((void *) CLIST_STACK(dest), CLIST_STACK(src), src->count * sizeof(CLIST(type)));
+#	endif
+#endif
+	}
+
+	src->count = 0;
+	src->capacity = CLIST_INLINE_CAPACITY;
+	src->block = CLIST_STACK(src);
+}
+
+#ifdef CLIST_MEMSWAP
+CLIST_API int CLIST(swap) (CLIST_T *list_a, CLIST_T *list_b) {
+	size_t tmp_size;
+	CLIST(type) *tmp_ptr;
+
+	CLIST_ASSERT(list_a != NULL);
+	CLIST_ASSERT(list_b != NULL);
+
+#ifdef CLIST_ARENA
+	{
+		/* heap blocks stay with the arena they came from */
+		clist_arena *tmp_arena = list_a->arena;
+		list_a->arena = list_b->arena;
+		list_b->arena = tmp_arena;
+	}
+#endif
+
+	tmp_size = list_a->count;
+	list_a->count = list_b->count;
+	list_b->count = tmp_size;
+
+	/* without a stack block there's nothing to copy; an empty list's
+	   NULL block trades places like any other */
+	if (CLIST_INLINE_CAPACITY == 0 || (CLIST_ON_HEAP(list_a) && CLIST_ON_HEAP(list_b))) {
+		tmp_size = list_a->capacity;
+		tmp_ptr = list_a->block;
+		list_a->capacity = list_b->capacity;
+		list_a->block = list_b->block;
+		list_b->capacity = tmp_size;
+		list_b->block = tmp_ptr;
+	}
+#if CLIST_INLINE_CAPACITY > 0
+	else if (!CLIST_ON_HEAP(list_a) && !CLIST_ON_HEAP(list_b)) {
+#	ifdef __cplusplus
+		if (!CLIST_RELOCATABLE) {
+			/* counts are already swapped */
+			size_t common = list_a->count < list_b->count ? list_a->count : list_b->count;
+			size_t i;
+
+			for (i = 0; i < common; i++) {
+				std::swap(list_a->block[i], list_b->block[i]);
+			}
+
+			if (list_a->count > common) {
+				CLIST(relocate)(&list_a->block[common], &list_b->block[common], list_a->count - common);
+			} else {
+				CLIST(relocate)(&list_b->block[common], &list_a->block[common], list_b->count - common);
+			}
+
+			return 0;
+		}
+#	endif
+		return CLIST_MEMSWAP(&list_a->stack_block[0], &list_b->stack_block[0], CLIST_INLINE_BYTES);
+	} else {
+		CLIST_T *stack_list;
+		CLIST_T *heap_list;
+
+		if (CLIST_ON_HEAP(list_a)) {
+			heap_list = list_a;
+			stack_list = list_b;
+		} else {
+			heap_list = list_b;
+			stack_list = list_a;
+		}
+
+		/* counts are already swapped */
+#	ifdef __cplusplus
+		CLIST(relocate)(CLIST_STACK(heap_list), CLIST_STACK(stack_list), heap_list->count);
+#	else
+		CLIST_MEMCPY((void *) CLIST_STACK(heap_list), CLIST_STACK(stack_list), heap_list->count * sizeof(CLIST(type)));
+#	endif
+
+		stack_list->capacity = heap_list->capacity;
+		stack_list->block = heap_list->block;
+		heap_list->capacity = CLIST_INLINE_CAPACITY;
+		heap_list->block = CLIST_STACK(heap_list);
+	}
+#endif
+
+	return 0;
+}
+#endif
+
+#ifdef CLIST_KIND
+/* fails to compile if CLIST_KIND doesn't fit CLIST_TYPE */
+typedef char CLIST(kind_check)[sizeof(CLIST(type)) == sizeof(CLIST_SIMD(elem_t, CLIST_KIND)) ? 1 : -1];
+
+/* adds up every element (see clist_simd.h for the type of the sum) */
+CLIST_API CLIST_SIMD(sum_t, CLIST_KIND) CLIST(sum) (const CLIST_T *list) {
+	CLIST_ASSERT(list != NULL);
+	return CLIST_SIMD(sum, CLIST_KIND)((const CLIST_SIMD(elem_t, CLIST_KIND) *) list->block, list->count);
+}
+
+/* finds the smallest and largest elements; the list must not be empty */
+CLIST_API void CLIST(minmax) (const CLIST_T *list, CLIST(type) *min_out, CLIST(type) *max_out) {
+	CLIST_SIMD(elem_t, CLIST_KIND) min;
+	CLIST_SIMD(elem_t, CLIST_KIND) max;
+
+	CLIST_ASSERT(list != NULL);
+	CLIST_ASSERT(list->count > 0);
+	CLIST_ASSERT(min_out != NULL);
+	CLIST_ASSERT(max_out != NULL);
+
+	CLIST_SIMD(minmax, CLIST_KIND)((const CLIST_SIMD(elem_t, CLIST_KIND) *) list->block, list->count, &min, &max);
+	CLIST_MEMCPY((void *) min_out, &min, sizeof(min));
+	CLIST_MEMCPY((void *) max_out, &max, sizeof(max));
+}
+
+/* returns the index of the first element equal to `val`, or CLIST_ERR */
+CLIST_API size_t CLIST(find) (const CLIST_T *list, CLIST(type) val) {
+	CLIST_SIMD(elem_t, CLIST_KIND) needle;
+
+	CLIST_ASSERT(list != NULL);
+
+	CLIST_MEMCPY(&needle, &val, sizeof(needle));
+	return CLIST_SIMD(find, CLIST_KIND)((const CLIST_SIMD(elem_t, CLIST_KIND) *) list->block, list->count, needle);
+}
+
+/* counts the elements equal to `val` */
+CLIST_API size_t CLIST(count_eq) (const CLIST_T *list, CLIST(type) val) {
+	CLIST_SIMD(elem_t, CLIST_KIND) needle;
+
+	CLIST_ASSERT(list != NULL);
+
+	CLIST_MEMCPY(&needle, &val, sizeof(needle));
+	return CLIST_SIMD(count_eq, CLIST_KIND)((const CLIST_SIMD(elem_t, CLIST_KIND) *) list->block, list->count, needle);
+}
+#endif
+
+#ifdef CLIST_PARALLEL
+typedef struct CLIST(parallel_task) {
+	CLIST(type) *block;
+	size_t count;
+	size_t chunk_size;
+	void (*fn)(CLIST(type) *block, size_t begin, size_t end, void *ctx);
+	void (*map)(const CLIST(type) *block, size_t begin, size_t end, void *partial, void *ctx);
+	void *ctx;
+	const void *identity;
+	char *partials;
+	size_t partial_size;
+	size_t partial_stride;
+} CLIST(parallel_task);
+
+CLIST_API void CLIST(parallel_for_chunk) (void *task_ptr, size_t chunk) {
+	CLIST(parallel_task) *task = (CLIST(parallel_task) *) task_ptr;
+	size_t begin = chunk * task->chunk_size;
+	size_t end = task->count - begin > task->chunk_size ? begin + task->chunk_size : task->count;
+
+	task->fn(task->block, begin, end, task->ctx);
+}
+
+CLIST_API void CLIST(parallel_reduce_chunk) (void *task_ptr, size_t chunk) {
+	CLIST(parallel_task) *task = (CLIST(parallel_task) *) task_ptr;
+	size_t begin = chunk * task->chunk_size;
+	size_t end = task->count - begin > task->chunk_size ? begin + task->chunk_size : task->count;
+	char *partial = task->partials + chunk * task->partial_stride;
+
+	CLIST_MEMCPY(partial, task->identity, task->partial_size);
+	task->map(task->block, begin, end, partial, task->ctx);
+}
+
+/* calls `fn(block, begin, end, ctx)` for block-aligned ranges covering the
+   whole list, from several threads at once. `fn` may change the elements
+   in its range, but not the list itself. */
+CLIST_API void CLIST(parallel_for) (CLIST_T *list, void (*fn)(CLIST(type) *block, size_t begin, size_t end, void *ctx), void *ctx) {
+	CLIST(parallel_task) task;
+	size_t n_chunks;
+
+	CLIST_ASSERT(list != NULL);
+	CLIST_ASSERT(fn != NULL);
+
+	task.block = list->block;
+	task.count = list->count;
+	task.chunk_size = clist__parallel_chunk_size(list->count, CLIST_BLOCK_SIZE, &n_chunks);
+	task.fn = fn;
+	task.ctx = ctx;
+
+	clist__parallel_run(&CLIST(parallel_for_chunk), &task, n_chunks);
+}
+
+/* folds the list into `result` from several threads at once. `result`
+   must hold the identity; each range starts from its own copy of it,
+   `map(block, begin, end, partial, ctx)` folds the range into that copy,
+   and the copies are then folded into `result` in order with
+   `combine(result, partial, ctx)`. returns 0 on success, or 1 with errno
+   set if the per-range copies can't be allocated. */
+CLIST_API int CLIST(parallel_reduce) (
+	const CLIST_T *list,
+	void *result,
+	size_t result_size,
+	void (*map)(const CLIST(type) *block, size_t begin, size_t end, void *partial, void *ctx),
+	void (*combine)(void *result, const void *partial, void *ctx),
+	void *ctx
+) {
+	CLIST(parallel_task) task;
+	size_t n_chunks;
+	size_t i;
+
+	CLIST_ASSERT(list != NULL);
+	CLIST_ASSERT(result != NULL);
+	CLIST_ASSERT(result_size > 0);
+	CLIST_ASSERT(map != NULL);
+	CLIST_ASSERT(combine != NULL);
+
+	task.chunk_size = clist__parallel_chunk_size(list->count, CLIST_BLOCK_SIZE, &n_chunks);
+	if (n_chunks == 0) {
+		return 0;
+	}
+
+	/* a cache line (at least) each, so that neighbouring ranges don't fight over them */
+	task.partial_size = result_size;
+	task.partial_stride = CLIST_PAGE_ROUND(result_size, CLIST_PARALLEL_CACHE_LINE);
+	task.partials = (char *) clist__alloc(n_chunks * task.partial_stride);
+	if (CLIST_UNLIKELY(task.partials == NULL)) {
+		/* errno already set */
+		return 1;
+	}
+
+	task.block = list->block;
+	task.count = list->count;
+	task.map = map;
+	task.ctx = ctx;
+	task.identity = result;
+
+	clist__parallel_run(&CLIST(parallel_reduce_chunk), &task, n_chunks);
+
+	for (i = 0; i < n_chunks; i++) {
+		combine(result, task.partials + i * task.partial_stride, ctx);
+	}
+
+	clist__free(task.partials);
+	return 0;
+}
+#endif
+
+#ifdef CLIST_CMP
+#	define CLIST_LESS(a, b) (CLIST_CMP(a, b) < 0)
+#	ifdef __cplusplus
+#		define CLIST_MOVE(val) std::move(val)
+#	else
+#		define CLIST_MOVE(val) (val)
+#	endif
+
+	/* ranges at most this long are insertion sorted */
+#	define CLIST_SORT_THRESHOLD 24
+	/* elements compared per round of the block partition; offsets into
+	   a block have to fit in an unsigned char */
+#	define CLIST_SORT_BLOCK 64
+	/* ranges longer than this take the median of three medians as the pivot */
+#	define CLIST_SORT_NINTHER 128
+
+CLIST_API void CLIST(sort_swap) (CLIST(type) *a, CLIST(type) *b) {
+#ifdef __cplusplus
+	std::swap(*a, *b);
+#else
+	CLIST(type) tmp = *a;
+	*a = *b;
+	*b = tmp;
+#endif
+}
+
+/* `guarded` is 0 when the element before `lo` is known to be no bigger
+   than anything in the range, which saves a bounds check per step */
+CLIST_API void CLIST(sort_insertion) (CLIST(type) *lo, CLIST(type) *hi, int guarded) {
+	CLIST(type) *i;
+
+	for (i = lo + 1; i < hi; i++) {
+		CLIST(type) *j = i;
+
+		if (CLIST_LESS(*i, i[-1])) {
+			CLIST(type) tmp = CLIST_MOVE(*i);
+
+			do {
+				*j = CLIST_MOVE(j[-1]);
+				--j;
+			} while ((!guarded || j > lo) && CLIST_LESS(tmp, j[-1]));
+
+			*j = CLIST_MOVE(tmp);
+		}
+	}
+}
+
+CLIST_API void CLIST(sort_sift_down) (CLIST(type) *block, size_t root, size_t n_elems) {
+	CLIST(type) tmp = CLIST_MOVE(block[root]);
+	size_t child;
+
+	while ((child = 2 * root + 1) < n_elems) {
+		if (child + 1 < n_elems && CLIST_LESS(block[child], block[child + 1])) {
+			++child;
+		}
+
+		if (!CLIST_LESS(tmp, block[child])) {
+			break;
+		}
+
+		block[root] = CLIST_MOVE(block[child]);
+		root = child;
+	}
+
+	block[root] = CLIST_MOVE(tmp);
+}
+
+CLIST_API void CLIST(sort_heap) (CLIST(type) *block, size_t n_elems) {
+	size_t i;
+
+	for (i = n_elems / 2; i-- > 0;) {
+		CLIST(sort_sift_down)(block, i, n_elems);
+	}
+
+	for (i = n_elems - 1; i > 0; i--) {
+		CLIST(sort_swap)(&block[0], &block[i]);
+		CLIST(sort_sift_down)(block, 0, i);
+	}
+}
+
+/* sorts the three elements so that *a <= *b <= *c */
+CLIST_API void CLIST(sort_three) (CLIST(type) *a, CLIST(type) *b, CLIST(type) *c) {
+	if (CLIST_LESS(*b, *a)) CLIST(sort_swap)(a, b);
+	if (CLIST_LESS(*c, *b)) CLIST(sort_swap)(b, c);
+	if (CLIST_LESS(*b, *a)) CLIST(sort_swap)(a, b);
+}
+
+/* moves the pivot to the front, leaving something no smaller than it at the end */
+CLIST_API void CLIST(sort_pivot) (CLIST(type) *lo, CLIST(type) *hi) {
+	CLIST(type) *mid = lo + (hi - lo) / 2;
+
+	if (hi - lo > CLIST_SORT_NINTHER) {
+		CLIST(sort_three)(lo, mid, hi - 1);
+		CLIST(sort_three)(lo + 1, mid - 1, hi - 2);
+		CLIST(sort_three)(lo + 2, mid + 1, hi - 3);
+		CLIST(sort_three)(mid - 1, mid, mid + 1);
+		CLIST(sort_swap)(lo, mid);
+	} else {
+		CLIST(sort_three)(mid, lo, hi - 1);
+	}
+}
+
+/* partitions around the pivot at *lo, with everything equal to it going
+   right, and returns where the pivot ends up. the comparisons for a whole
+   block are done up front into offset buffers (see "BlockQuicksort",
+   Edelkamp & Weiss) so that their outcome never decides a branch. */
+CLIST_API CLIST(type) *CLIST(sort_partition_right) (CLIST(type) *lo, CLIST(type) *hi) {
+	CLIST(type) pivot = CLIST_MOVE(*lo);
+	CLIST(type) *first = lo;
+	CLIST(type) *last = hi;
+
+	/* the pivot's sentinels at either end stop these */
+	do {
+		++first;
+	} while (CLIST_LESS(*first, pivot));
+
+	if (first - 1 == lo) {
+		while (first < last) {
+			--last;
+			if (CLIST_LESS(*last, pivot)) break;
+		}
+	} else {
+		do {
+			--last;
+		} while (!CLIST_LESS(*last, pivot));
+	}
+
+	if (first < last) {
+		unsigned char offsets_l[CLIST_SORT_BLOCK];
+		unsigned char offsets_r[CLIST_SORT_BLOCK];
+		CLIST(type) *base_l;
+		CLIST(type) *base_r;
+		size_t num_l = 0;
+		size_t num_r = 0;
+		size_t start_l = 0;
+		size_t start_r = 0;
+
+		CLIST(sort_swap)(first, last);
+		++first;
+		base_l = first;
+		base_r = last;
+
+		while (first < last) {
+			size_t unknown = (size_t) (last - first);
+			size_t split_l = num_l == 0 ? (num_r == 0 ? unknown / 2 : unknown) : 0;
+			size_t split_r = num_r == 0 ? unknown - split_l : 0;
+			size_t num;
+			size_t i;
+
+			if (split_l > CLIST_SORT_BLOCK) {
+				split_l = CLIST_SORT_BLOCK;
+			}
+			if (split_r > CLIST_SORT_BLOCK) {
+				split_r = CLIST_SORT_BLOCK;
+			}
+
+			/* offsets of the elements that belong on the other side */
+			for (i = 0; i < split_l; i++) {
+				offsets_l[num_l] = (unsigned char) i;
+				num_l += !CLIST_LESS(*first, pivot);
+				++first;
+			}
+
+			for (i = 0; i < split_r; i++) {
+				offsets_r[num_r] = (unsigned char) (i + 1);
+				--last;
+				num_r += CLIST_LESS(*last, pivot);
+			}
+
+			num = num_l < num_r ? num_l : num_r;
+			for (i = 0; i < num; i++) {
+				CLIST(sort_swap)(base_l + offsets_l[start_l + i], base_r - offsets_r[start_r + i]);
+			}
+
+			num_l -= num;
+			num_r -= num;
+			start_l += num;
+			start_r += num;
+
+			if (num_l == 0) {
+				start_l = 0;
+				base_l = first;
+			}
+			if (num_r == 0) {
+				start_r = 0;
+				base_r = last;
+			}
+		}
+
+		/* whatever is left over of one side is swapped into place one by one */
+		while (num_l > 0) {
+			--num_l;
+			CLIST(sort_swap)(base_l + offsets_l[start_l + num_l], --last);
+			first = last;
+		}
+		while (num_r > 0) {
+			--num_r;
+			CLIST(sort_swap)(base_r - offsets_r[start_r + num_r], first);
+			last = ++first;
+		}
+	}
+
+	*lo = CLIST_MOVE(first[-1]);
+	first[-1] = CLIST_MOVE(pivot);
+	return first - 1;
+}
+
+/* partitions around the pivot at *lo with everything equal to it going
+   left; only used when the element before `lo` is equal to the pivot,
+   which means the whole left side is equal and thus done */
+CLIST_API CLIST(type) *CLIST(sort_partition_left) (CLIST(type) *lo, CLIST(type) *hi) {
+	CLIST(type) pivot = CLIST_MOVE(*lo);
+	CLIST(type) *first = lo;
+	CLIST(type) *last = hi;
+
+	do {
+		--last;
+	} while (CLIST_LESS(pivot, *last));
+
+	if (last + 1 == hi) {
+		while (first < last) {
+			++first;
+			if (CLIST_LESS(pivot, *first)) break;
+		}
+	} else {
+		do {
+			++first;
+		} while (!CLIST_LESS(pivot, *first));
+	}
+
+	while (first < last) {
+		CLIST(sort_swap)(first, last);
+		do {
+			--last;
+		} while (CLIST_LESS(pivot, *last));
+		do {
+			++first;
+		} while (!CLIST_LESS(pivot, *first));
+	}
+
+	*lo = CLIST_MOVE(*last);
+	*last = CLIST_MOVE(pivot);
+	return last;
+}
+
+/* quicksort that falls back to heapsort once it's gone `depth` levels
+   deep; `leftmost` is 0 if the element before `lo` belongs to the list
+   (and is no bigger than anything in [lo, hi)) */
+CLIST_API void CLIST(sort_intro) (CLIST(type) *lo, CLIST(type) *hi, size_t depth, int leftmost) {
+	while (hi - lo > CLIST_SORT_THRESHOLD) {
+		CLIST(type) *cut;
+
+		if (CLIST_UNLIKELY(depth == 0)) {
+			CLIST(sort_heap)(lo, (size_t) (hi - lo));
+			return;
+		}
+
+		--depth;
+		CLIST(sort_pivot)(lo, hi);
+
+		/* lots of equal elements - put them all to the left and skip them */
+		if (!leftmost && !CLIST_LESS(lo[-1], *lo)) {
+			lo = CLIST(sort_partition_left)(lo, hi) + 1;
+			continue;
+		}
+
+		cut = CLIST(sort_partition_right)(lo, hi);
+
+		/* recurse into the smaller half so the stack stays O(log n) */
+		if (cut - lo < hi - cut) {
+			CLIST(sort_intro)(lo, cut, depth, leftmost);
+			lo = cut + 1;
+			leftmost = 0;
+		} else {
+			CLIST(sort_intro)(cut + 1, hi, depth, 0);
+			hi = cut;
+		}
+	}
+
+	CLIST(sort_insertion)(lo, hi, leftmost);
+}
+
+/* sorts the list in place with CLIST_CMP; not stable */
+CLIST_API void CLIST(sort) (CLIST_T *list) {
+	size_t depth = 0;
+	size_t n;
+
+	CLIST_ASSERT(list != NULL);
+
+	for (n = list->count; n > 1; n >>= 1) {
+		depth += 2;
+	}
+
+	CLIST(sort_intro)(list->block, list->block + list->count, depth, 1);
+}
+
+/* returns the index of the first element that isn't less than `val` (the
+   count if there's none); the list must be sorted */
+CLIST_API size_t CLIST(lower_bound) (const CLIST_T *list, const CLIST(type) CLIST_REF val) {
+	const CLIST(type) *base;
+	size_t n;
+
+	CLIST_ASSERT(list != NULL);
+
+	if (list->count == 0) {
+		return 0;
+	}
+
+	/* the answer is always in [base, base + n]; halving the range without
+	   a branch keeps the loop free of mispredictions */
+	base = list->block;
+	for (n = list->count; n > 1; n -= n / 2) {
+		base = CLIST_LESS(base[n / 2], val) ? base + n / 2 : base;
+	}
+
+	return (size_t) (base - list->block) + CLIST_LESS(*base, val);
+}
+
+/* returns the index of an element equal to `val`, or CLIST_ERR; the list
+   must be sorted */
+CLIST_API size_t CLIST(bsearch) (const CLIST_T *list, const CLIST(type) CLIST_REF val) {
+	size_t idx = CLIST(lower_bound)(list, val);
+
+	if (idx < list->count && CLIST_CMP(list->block[idx], val) == 0) {
+		return idx;
+	}
+
+	return CLIST_ERR;
+}
+
+#	undef CLIST_LESS
+#	undef CLIST_MOVE
+#	undef CLIST_SORT_THRESHOLD
+#	undef CLIST_SORT_BLOCK
+#	undef CLIST_SORT_NINTHER
+#endif
+
+#if defined(CLIST_KIND) || defined(CLIST_RADIX_KEY)
+#	ifdef CLIST_RADIX_KEY
+#		define CLIST_RADIX_KEY_OF(elem) ((uint64_t) (CLIST_RADIX_KEY(elem)))
+#		define CLIST_RADIX_BYTES sizeof(CLIST_RADIX_KEY(*(CLIST(type) *) NULL))
+#	else
+#		define CLIST_RADIX_KEY_OF(elem) CLIST_SIMD(radix_key, CLIST_KIND)(*(const CLIST_SIMD(elem_t, CLIST_KIND) *) &(elem))
+#		define CLIST_RADIX_BYTES sizeof(CLIST_SIMD(elem_t, CLIST_KIND))
+#	endif
+
+typedef struct CLIST(radix_task) {
+	CLIST(type) *src;
+	CLIST(type) *dst;
+	size_t count;
+	size_t chunk_size;
+	size_t byte; /* the byte being sorted on, or CLIST_RADIX_BYTES to count all of them */
+	size_t *counts; /* [chunk][byte][256] */
+	size_t *offsets; /* [chunk][256] */
+} CLIST(radix_task);
+
+CLIST_API void CLIST(radix_count_chunk) (void *task_ptr, size_t chunk) {
+	CLIST(radix_task) *task = (CLIST(radix_task) *) task_ptr;
+	size_t begin = chunk * task->chunk_size;
+	size_t end = task->count - begin > task->chunk_size ? begin + task->chunk_size : task->count;
+	size_t *counts = task->counts + chunk * CLIST_RADIX_BYTES * 256;
+	size_t i;
+
+	if (task->byte == CLIST_RADIX_BYTES) {
+		CLIST_MEMSET(counts, 0, CLIST_RADIX_BYTES * 256 * sizeof(size_t));
+
+		for (i = begin; i < end; i++) {
+			uint64_t key = CLIST_RADIX_KEY_OF(task->src[i]);
+			size_t b;
+
+			for (b = 0; b < CLIST_RADIX_BYTES; b++) {
+				++counts[b * 256 + ((key >> (8 * b)) & 0xFF)];
+			}
+		}
+	} else {
+		size_t shift = 8 * task->byte;
+
+		counts += task->byte * 256;
+		CLIST_MEMSET(counts, 0, 256 * sizeof(size_t));
+
+		for (i = begin; i < end; i++) {
+			++counts[(CLIST_RADIX_KEY_OF(task->src[i]) >> shift) & 0xFF];
+		}
+	}
+}
+
+CLIST_API void CLIST(radix_scatter_chunk) (void *task_ptr, size_t chunk) {
+	CLIST(radix_task) *task = (CLIST(radix_task) *) task_ptr;
+	size_t begin = chunk * task->chunk_size;
+	size_t end = task->count - begin > task->chunk_size ? begin + task->chunk_size : task->count;
+	size_t *offsets = task->offsets + chunk * 256;
+	size_t shift = 8 * task->byte;
+	size_t i;
+
+	for (i = begin; i < end; i++) {
+		size_t digit = (size_t) (CLIST_RADIX_KEY_OF(task->src[i]) >> shift) & 0xFF;
+		CLIST_MEMCPY((void *) &task->dst[offsets[digit]++], (const void *) &task->src[i], sizeof(CLIST(type)));
+	}
+}
+
+CLIST_API void CLIST(radix_run) (clist__radix_fn fn, CLIST(radix_task) *task, size_t n_chunks) {
+	size_t i;
+
+#ifdef CLIST_PARALLEL
+	if (n_chunks > 1) {
+		clist__parallel_run(fn, task, n_chunks);
+		return;
+	}
+#endif
+
+	for (i = 0; i < n_chunks; i++) {
+		fn(task, i);
+	}
+}
+
+/* the list is cut into `n_chunks` ranges that are counted and scattered
+   separately (and in parallel, with CLIST_PARALLEL) */
+CLIST_API int CLIST(radix_sort_chunks) (CLIST_T *list, size_t n_chunks) {
+	CLIST(radix_task) task;
+	size_t counts_size;
+	size_t b;
+	int moved = 0;
+	void *mem;
 
 #ifdef __cplusplus
+	static_assert(CLIST_RELOCATABLE, "radix sorting moves the elements with memcpy()");
+#endif
+
+	CLIST_ASSERT(list != NULL);
+	CLIST_ASSERT(n_chunks > 0);
+
+	if (list->count < 2) {
+		return 0;
+	}
+
+	task.count = list->count;
+	task.chunk_size = task.count / n_chunks + (task.count % n_chunks != 0);
+	n_chunks = task.count / task.chunk_size + (task.count % task.chunk_size != 0);
+
+	/* the counts go first so that the scratch elements after them stay aligned */
+	counts_size = n_chunks * (CLIST_RADIX_BYTES + 1) * 256 * sizeof(size_t);
+	mem = CLIST(mem_alloc)(list, counts_size + task.count * sizeof(CLIST(type)), false);
+	if (CLIST_UNLIKELY(mem == NULL)) {
+		/* errno already set */
+		return 1;
+	}
+
+	task.counts = (size_t *) mem;
+	task.offsets = task.counts + n_chunks * CLIST_RADIX_BYTES * 256;
+	task.src = list->block;
+	task.dst = (CLIST(type) *) ((char *) mem + counts_size);
+
+	task.byte = CLIST_RADIX_BYTES;
+	CLIST(radix_run)(&CLIST(radix_count_chunk), &task, n_chunks);
+
+	for (b = 0; b < CLIST_RADIX_BYTES; b++) {
+		CLIST(type) *tmp;
+
+		/* the totals don't depend on the order, so the first counts
+		   are good enough to tell whether the pass can be skipped */
+		if (!clist__radix_offsets(task.counts + b * 256, CLIST_RADIX_BYTES * 256, n_chunks, task.count, task.offsets)) {
+			continue;
+		}
+
+		task.byte = b;
+
+		/* ...but what each chunk holds does once anything has moved */
+		if (moved && n_chunks > 1) {
+			CLIST(radix_run)(&CLIST(radix_count_chunk), &task, n_chunks);
+			clist__radix_offsets(task.counts + b * 256, CLIST_RADIX_BYTES * 256, n_chunks, task.count, task.offsets);
+		}
+
+		CLIST(radix_run)(&CLIST(radix_scatter_chunk), &task, n_chunks);
+
+		tmp = task.src;
+		task.src = task.dst;
+		task.dst = tmp;
+		moved = 1;
+	}
+
+	if (task.src != list->block) {
+		CLIST_MEMCPY((void *) list->block, (const void *) task.src, task.count * sizeof(CLIST(type)));
+	}
+
+	CLIST(mem_free)(list, mem);
+	return 0;
+}
+
+/* sorts the list by key, keeping equal keys in order. needs a scratch
+   copy of the list from the list's allocator; returns 0 on success, or
+   1 with errno set if it can't get one. */
+CLIST_API int CLIST(radix_sort) (CLIST_T *list) {
+	return CLIST(radix_sort_chunks)(list, 1);
+}
+
+#	ifdef CLIST_PARALLEL
+/* clist_radix_sort() with the counting and scattering spread over the
+   thread pool (see clist_parallel.h) */
+CLIST_API int CLIST(parallel_radix_sort) (CLIST_T *list) {
+	CLIST_ASSERT(list != NULL);
+
+	if (list->count < CLIST_RADIX_PARALLEL_MIN) {
+		return CLIST(radix_sort)(list);
+	}
+
+	return CLIST(radix_sort_chunks)(list, clist_parallel_threads(0));
+}
+#	endif
+
+#	undef CLIST_RADIX_KEY_OF
+#	undef CLIST_RADIX_BYTES
+#endif
+
+#ifdef CLIST_SEGMENTED
+#	include "./clist_segmented.h"
+#endif
+
+#ifdef CLIST_CONCURRENT
+#	include "./clist_concurrent.h"
+#endif
+
+#ifdef CLIST_SHARDED
+#	include "./clist_sharded.h"
+#endif
+
+#ifdef CLIST_RING
+#	include "./clist_ring.h"
+#endif
+
+#ifdef CLIST_SWMR
+#	include "./clist_swmr.h"
+#endif
+
+#ifdef CLIST_PERSIST
+#	include "./clist_persist.h"
+#endif
+
+#ifdef CLIST_SPILL
+#	include "./clist_spill.h"
+#endif
+
+#ifdef CLIST_SHM
+#	include "./clist_shm.h"
+#endif
+
+#ifdef CLIST_FIELDS
+#	include "./clist_soa.h"
+#endif
+
+#ifdef __cplusplus
+}
+
+#	ifdef CLIST_PARALLEL
+template <typename Fn>
+CLIST_INLINE void CLIST(parallel_for_each) (CLIST(type) *block, size_t begin, size_t end, void *ctx) {
+	Fn &fn = *static_cast<Fn *>(ctx);
+
+	for (; begin < end; begin++) {
+		fn(block[begin]);
+	}
+}
+
+/* calls `fn(elem)` for every element, from several threads at once */
+template <typename Fn>
+CLIST_INLINE void CLIST(parallel_for) (CLIST_T *list, Fn &&fn) {
+	typedef typename std::remove_reference<Fn>::type fn_type;
+	CLIST(parallel_for)(list, &CLIST(parallel_for_each)<fn_type>, (void *) &fn);
+}
+
+template <typename R, typename Map, typename Combine>
+struct CLIST(reducer) {
+	Map *map;
+	Combine *combine;
+
+	static void range(const CLIST(type) *block, size_t begin, size_t end, void *partial, void *ctx) {
+		Map &map = *static_cast<CLIST(reducer) *>(ctx)->map;
+		R acc = *static_cast<R *>(partial);
+
+		for (; begin < end; begin++) {
+			acc = map(acc, block[begin]);
+		}
+
+		*static_cast<R *>(partial) = acc;
+	}
+
+	static void fold(void *result, const void *partial, void *ctx) {
+		Combine &combine = *static_cast<CLIST(reducer) *>(ctx)->combine;
+		*static_cast<R *>(result) = combine(*static_cast<R *>(result), *static_cast<const R *>(partial));
+	}
+};
+
+/* folds every element into `*result` (which must hold the identity) from
+   several threads at once; `map(acc, elem)` and `combine(acc, partial)`
+   both return the new accumulator */
+template <typename R, typename Map, typename Combine>
+CLIST_INLINE int CLIST(parallel_reduce) (const CLIST_T *list, R *result, Map &&map, Combine &&combine) {
+	typedef CLIST(reducer)<R, typename std::remove_reference<Map>::type, typename std::remove_reference<Combine>::type> reducer;
+	static_assert(std::is_trivially_copyable<R>::value, "the partial results are copied around with memcpy()");
+
+	reducer ctx = { &map, &combine };
+	return CLIST(parallel_reduce)(list, (void *) result, sizeof(R), &reducer::range, &reducer::fold, (void *) &ctx);
 }
+#	endif
 
 #	if CLIST_SHOULD_CLASSIFY
 namespace clist {
 
 struct CLIST_NAME {
 	typedef CLIST(type) type;
+	typedef CLIST(type) value_type;
+	typedef CLIST(type) *iterator;
+	typedef const CLIST(type) *const_iterator;
 
 	CLIST_INLINE CLIST_NAME() noexcept {
 		CLIST(init)(&L);
@@ -493,10 +2210,6 @@ struct CLIST_NAME {
 		int res = CLIST(init_capacity)(&L, capacity);
 		(void) res;
 		CLIST_ASSERT(res == 0);
-
-		for (size_t i = 0; i < capacity; i++) {
-			new (&L.block[i]) CLIST(type)();
-		}
 	}
 
 	template <typename T>
@@ -510,13 +2223,28 @@ struct CLIST_NAME {
 		}
 	}
 
+	CLIST_INLINE CLIST_NAME(CLIST_NAME &&other) noexcept {
+		CLIST(move)(&L, &other.L);
+	}
+
+	CLIST_NAME(const CLIST_NAME &) = delete;
+	CLIST_NAME &operator=(const CLIST_NAME &) = delete;
+
 	CLIST_INLINE ~CLIST_NAME() noexcept {
-		for (size_t i = 0; i < L.count; i++) {
-			L.block[i].~CLIST(type)();
-		}
+		CLIST(clear)(&L);
 		CLIST(free)(&L);
 	}
 
+	CLIST_INLINE CLIST_NAME &operator=(CLIST_NAME &&other) noexcept {
+		if (this != &other) {
+			CLIST(clear)(&L);
+			CLIST(free)(&L);
+			CLIST(move)(&L, &other.L);
+		}
+
+		return *this;
+	}
+
 	CLIST_INLINE size_t count() const noexcept {
 		return CLIST(count)(&L);
 	}
@@ -525,6 +2253,26 @@ struct CLIST_NAME {
 		return CLIST(empty)(&L);
 	}
 
+	CLIST_INLINE size_t capacity() const noexcept {
+		return CLIST(capacity)(&L);
+	}
+
+	CLIST_INLINE int reserve(size_t n_elems) noexcept {
+		return CLIST(reserve)(&L, n_elems);
+	}
+
+	CLIST_INLINE int resize(size_t n_elems) {
+		return CLIST(resize)(&L, n_elems);
+	}
+
+	CLIST_INLINE int shrink() noexcept {
+		return CLIST(shrink)(&L);
+	}
+
+	CLIST_INLINE void trim() noexcept {
+		CLIST(trim)(&L);
+	}
+
 	CLIST_INLINE CLIST(type) CLIST_REF_PTR get(size_t index) const noexcept {
 		return CLIST(get)(&L, index);
 	}
@@ -533,9 +2281,57 @@ struct CLIST_NAME {
 		return CLIST(add)(&L, val);
 	}
 
+	CLIST_INLINE size_t add_n(const CLIST(type) *vals, size_t n_elems) {
+		return CLIST(add_n)(&L, vals, n_elems);
+	}
+
+#	ifndef CLIST_NO_REF
+	CLIST_INLINE size_t add(CLIST(type) &&val) {
+		return emplace(std::move(val));
+	}
+#	endif
+
+	/* constructs the new element right in its slot */
 	template <typename... Args>
-	CLIST_INLINE size_t emplace(Args const& ...args) {
-		return CLIST(add)(&L, CLIST(type)(args...));
+	CLIST_INLINE size_t emplace(Args &&...args) {
+		size_t idx = L.count;
+
+		if (CLIST_UNLIKELY(idx == L.capacity)) {
+			/* the arguments might refer to elements that are about to move */
+			CLIST(type) tmp(std::forward<Args>(args)...);
+
+			if (CLIST_UNLIKELY(CLIST(make_room)(&L) != 0)) {
+				return CLIST_ERR;
+			}
+
+			new (&L.block[idx]) CLIST(type)(std::move(tmp));
+		} else {
+			new (&L.block[idx]) CLIST(type)(std::forward<Args>(args)...);
+		}
+
+		L.count = idx + 1;
+		CLIST_STAT(&L, adds, 1);
+		return idx;
+	}
+
+	CLIST_INLINE size_t insert(size_t index, const CLIST(type) CLIST_REF val) {
+		return CLIST(insert)(&L, index, val);
+	}
+
+	CLIST_INLINE CLIST(type) pop() {
+		return CLIST(pop)(&L);
+	}
+
+	CLIST_INLINE void remove(size_t index) {
+		CLIST(remove)(&L, index);
+	}
+
+	CLIST_INLINE void swap_remove(size_t index) {
+		CLIST(swap_remove)(&L, index);
+	}
+
+	CLIST_INLINE void clear() noexcept {
+		CLIST(clear)(&L);
 	}
 
 	CLIST_INLINE CLIST(type) CLIST_REF_PTR operator[](size_t index) const noexcept {
@@ -546,6 +2342,120 @@ struct CLIST_NAME {
 		return get(count() - 1);
 	}
 
+	CLIST_INLINE CLIST(type) *data() noexcept {
+		return CLIST(data)(&L);
+	}
+
+	CLIST_INLINE const CLIST(type) *data() const noexcept {
+		return CLIST(data)(&L);
+	}
+
+	CLIST_INLINE iterator begin() noexcept {
+		return L.block;
+	}
+
+	CLIST_INLINE iterator end() noexcept {
+		return L.block + L.count;
+	}
+
+	CLIST_INLINE const_iterator begin() const noexcept {
+		return L.block;
+	}
+
+	CLIST_INLINE const_iterator end() const noexcept {
+		return L.block + L.count;
+	}
+
+	CLIST_INLINE const_iterator cbegin() const noexcept {
+		return begin();
+	}
+
+	CLIST_INLINE const_iterator cend() const noexcept {
+		return end();
+	}
+
+#	ifdef CLIST_KIND
+	CLIST_INLINE CLIST_SIMD(sum_t, CLIST_KIND) sum() const noexcept {
+		return CLIST(sum)(&L);
+	}
+
+	CLIST_INLINE void minmax(CLIST(type) &min_out, CLIST(type) &max_out) const noexcept {
+		CLIST(minmax)(&L, &min_out, &max_out);
+	}
+
+	CLIST_INLINE size_t find(CLIST(type) val) const noexcept {
+		return CLIST(find)(&L, val);
+	}
+
+	CLIST_INLINE size_t count_eq(CLIST(type) val) const noexcept {
+		return CLIST(count_eq)(&L, val);
+	}
+#	endif
+
+#	ifdef CLIST_CMP
+	CLIST_INLINE void sort() {
+		CLIST(sort)(&L);
+	}
+
+	CLIST_INLINE size_t lower_bound(const CLIST(type) CLIST_REF val) const {
+		return CLIST(lower_bound)(&L, val);
+	}
+
+	CLIST_INLINE size_t bsearch(const CLIST(type) CLIST_REF val) const {
+		return CLIST(bsearch)(&L, val);
+	}
+#	endif
+
+#	if defined(CLIST_KIND) || defined(CLIST_RADIX_KEY)
+	CLIST_INLINE int radix_sort() {
+		return CLIST(radix_sort)(&L);
+	}
+
+#		ifdef CLIST_PARALLEL
+	CLIST_INLINE int parallel_radix_sort() {
+		return CLIST(parallel_radix_sort)(&L);
+	}
+#		endif
+#	endif
+
+#	ifdef CLIST_PARALLEL
+	/* calls `fn(elem)` for every element, from several threads at once */
+	template <typename Fn>
+	CLIST_INLINE void parallel_for(Fn &&fn) {
+		CLIST(parallel_for)(&L, std::forward<Fn>(fn));
+	}
+
+	/* `map(acc, elem)` and `combine(acc, partial)` return the new accumulator */
+	template <typename R, typename Map, typename Combine>
+	CLIST_INLINE R parallel_reduce(R identity, Map &&map, Combine &&combine) const {
+		int res = CLIST(parallel_reduce)(&L, &identity, std::forward<Map>(map), std::forward<Combine>(combine));
+		(void) res;
+		CLIST_ASSERT(res == 0);
+		return identity;
+	}
+#	endif
+
+#	ifdef CLIST_PERSIST
+	CLIST_INLINE int save(const char *path) const {
+		return CLIST(save)(&L, path);
+	}
+
+	/* appends the elements in the file */
+	CLIST_INLINE int load(const char *path) {
+		return CLIST(load)(&L, path);
+	}
+#	endif
+
+#	ifdef CLIST_STATS
+	CLIST_INLINE void stats(clist_stats *out) const noexcept {
+		CLIST(stats)(&L, out);
+	}
+
+	CLIST_INLINE void stats_flush() noexcept {
+		CLIST(stats_flush)(&L);
+	}
+#	endif
+
 #	ifdef CLIST_MEMSWAP
 	CLIST_INLINE void swap(CLIST_NAME &other) noexcept {
 		int res = CLIST(swap)(&L, &other.L);
@@ -565,24 +2475,91 @@ private:
 #undef CLIST
 #undef CLIST_
 #undef CLIST__
+#undef CLIST__PRIVATE
 #undef CLIST_T
 #undef CLIST_T_
 #undef CLIST_T__
 #undef CLIST_NAME
 #undef CLIST_API
-#undef CLIST_HAS_UNISTD
-#undef CLIST_HAS_WINDOWS
 #undef CLIST_ALLOC
 #undef CLIST_REALLOC
 #undef CLIST_FREE
+#undef CLIST_EXPAND
+#undef CLIST_CALLOC
+#undef CLIST_REALLOC_ALIGNMENT
+#undef CLIST_DISCARD
 #undef CLIST_BLOCK_SIZE
 #undef CLIST_BLOCK_SIZE_BYTES
+#undef CLIST_INLINE_CAPACITY
+#undef CLIST_INLINE_BYTES
+#undef CLIST_ON_HEAP
 #undef CLIST_BLOCK_GROWTH_RATE
 #undef CLIST_REF
 #undef CLIST_REF_PTR
 #undef CLIST_REF_ADDROF
 #undef CLIST_SHOULD_CLASSIFY
 #undef CLIST_STACK
+#ifdef CLIST_RELOCATABLE
+#	undef CLIST_RELOCATABLE
+#endif
 #ifdef CLIST_NO_REF
 #	undef CLIST_NO_REF
 #endif
+#ifdef CLIST_NO_CLASS
+#	undef CLIST_NO_CLASS
+#endif
+#ifdef CLIST_SEGMENTED
+#	undef CLIST_SEGMENTED
+#endif
+#ifdef CLIST_CONCURRENT
+#	undef CLIST_CONCURRENT
+#endif
+#ifdef CLIST_SHARDED
+#	undef CLIST_SHARDED
+#endif
+#ifdef CLIST_RING
+#	undef CLIST_RING
+#endif
+#ifdef CLIST_SWMR
+#	undef CLIST_SWMR
+#endif
+#ifdef CLIST_PERSIST
+#	undef CLIST_PERSIST
+#endif
+#ifdef CLIST_SPILL
+#	undef CLIST_SPILL
+#endif
+#ifdef CLIST_SHM
+#	undef CLIST_SHM
+#endif
+#ifdef CLIST_FIELDS
+#	undef CLIST_FIELDS
+#endif
+#ifdef CLIST_KIND
+#	undef CLIST_KIND
+#endif
+#ifdef CLIST_PARALLEL
+#	undef CLIST_PARALLEL
+#endif
+#ifdef CLIST_CMP
+#	undef CLIST_CMP
+#endif
+#ifdef CLIST_RADIX_KEY
+#	undef CLIST_RADIX_KEY
+#endif
+#ifdef CLIST_ARENA
+#	undef CLIST_ARENA
+#endif
+#ifdef CLIST_GROWTH
+#	undef CLIST_GROWTH
+#endif
+#ifdef CLIST_STATS
+#	undef CLIST_STATS
+#endif
+#ifdef CLIST_ALIGNMENT
+#	undef CLIST_ALIGNMENT
+#endif
+#undef CLIST_STAT
+#undef CLIST__STAT_TO
+#undef CLIST__OWNER_ARENA
+#undef CLIST__OWNER_STATS
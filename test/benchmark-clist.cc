@@ -1,5 +1,9 @@
 // #pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
 
+#include <algorithm>
+#include <mutex>
+#include <numeric>
+#include <thread>
 #include <vector>
 
 #include <benchmark/benchmark.h>
@@ -7,9 +11,144 @@
 #define _CLIST_BLOCK_SIZE 512
 #define CLIST_BLOCK_SIZE _CLIST_BLOCK_SIZE
 #define CLIST_NO_REF /* act as though we're still in C */
+#define CLIST_SEGMENTED
 #include "clist.h"
 #define CLIST_BLOCK_SIZE _CLIST_BLOCK_SIZE
 
+#define CLIST_ARENA
+#define CLIST_NAME pooled
+#define CLIST_NO_REF
+#define CLIST_NO_CLASS
+#include "clist_type.h"
+
+#define CLIST_INLINE_CAPACITY 4
+#define CLIST_BLOCK_SIZE 16
+#define CLIST_NAME inline4
+#define CLIST_NO_REF
+#define CLIST_NO_CLASS
+#include "clist_type.h"
+
+#define CLIST_INLINE_CAPACITY 0
+#define CLIST_BLOCK_SIZE 16
+#define CLIST_NAME inline0
+#define CLIST_NO_REF
+#define CLIST_NO_CLASS
+#include "clist_type.h"
+#define CLIST_BLOCK_SIZE _CLIST_BLOCK_SIZE
+
+struct sample {
+	int foo;
+	int bar;
+};
+
+#define CLIST_TYPE int
+#define CLIST_NAME sint
+#define CLIST_CMP(a, b) (((a) > (b)) - ((a) < (b)))
+#define CLIST_KIND i32
+#define CLIST_PARALLEL
+#define CLIST_NO_REF
+#define CLIST_NO_CLASS
+#include "clist_type.h"
+#define CLIST_BLOCK_SIZE _CLIST_BLOCK_SIZE
+
+#define CLIST_TYPE struct sample
+#define CLIST_NAME ssample
+#define CLIST_CMP(a, b) ((a).foo != (b).foo ? ((a).foo > (b).foo) - ((a).foo < (b).foo) : ((a).bar > (b).bar) - ((a).bar < (b).bar))
+#define CLIST_RADIX_KEY(s) ((uint64_t) ((uint32_t) (s).foo ^ 0x80000000u) << 32 | ((uint32_t) (s).bar ^ 0x80000000u))
+#define CLIST_FIELDS(X) X(int, foo) X(int, bar)
+#define CLIST_NO_REF
+#define CLIST_NO_CLASS
+#include "clist_type.h"
+#define CLIST_BLOCK_SIZE _CLIST_BLOCK_SIZE
+
+#define CLIST_NAME sptr
+#define CLIST_CMP(a, b) (((a) > (b)) - ((a) < (b)))
+#define CLIST_NO_REF
+#define CLIST_NO_CLASS
+#include "clist_type.h"
+#define CLIST_BLOCK_SIZE _CLIST_BLOCK_SIZE
+
+#define CLIST_PARALLEL
+#define CLIST_SHARDED
+#define CLIST_NAME par
+#define CLIST_NO_REF
+#define CLIST_NO_CLASS
+#include "clist_type.h"
+#define CLIST_BLOCK_SIZE _CLIST_BLOCK_SIZE
+
+#define CLIST_SWMR
+#define CLIST_NAME swmr
+#define CLIST_NO_REF
+#define CLIST_NO_CLASS
+#include "clist_type.h"
+#define CLIST_BLOCK_SIZE _CLIST_BLOCK_SIZE
+
+#define CLIST_RING
+#define CLIST_NAME ring
+#define CLIST_NO_REF
+#define CLIST_NO_CLASS
+#include "clist_type.h"
+#define CLIST_BLOCK_SIZE _CLIST_BLOCK_SIZE
+
+#define CLIST_GROWTH
+#define CLIST_NAME policy
+#define CLIST_NO_REF
+#define CLIST_NO_CLASS
+#include "clist_type.h"
+#define CLIST_BLOCK_SIZE _CLIST_BLOCK_SIZE
+
+#define CLIST_CONCURRENT
+#define CLIST_NAME conc
+#define CLIST_NO_REF
+#define CLIST_NO_CLASS
+#include "clist_type.h"
+#define CLIST_BLOCK_SIZE _CLIST_BLOCK_SIZE
+
+#define CLIST_TYPE int32_t
+#define CLIST_KIND i32
+#define CLIST_PERSIST
+#define CLIST_SPILL
+#define CLIST_SHM
+#define CLIST_NAME i32
+#define CLIST_NO_REF
+#define CLIST_NO_CLASS
+#include "clist_type.h"
+#define CLIST_BLOCK_SIZE _CLIST_BLOCK_SIZE
+
+/* the same as i32, but cache line aligned */
+#define CLIST_TYPE int32_t
+#define CLIST_ALIGNMENT 64
+#define CLIST_NAME al64
+#define CLIST_NO_REF
+#define CLIST_NO_CLASS
+#include "clist_type.h"
+#define CLIST_BLOCK_SIZE _CLIST_BLOCK_SIZE
+
+/* the same as i32, but counting */
+#define CLIST_TYPE int32_t
+#define CLIST_STATS
+#define CLIST_NAME stat
+#define CLIST_NO_REF
+#define CLIST_NO_CLASS
+#include "clist_type.h"
+#define CLIST_BLOCK_SIZE _CLIST_BLOCK_SIZE
+
+#ifdef __linux__
+#	define CLIST_USE_MMAP
+#	define CLIST_NAME mmap
+#	define CLIST_NO_REF
+#	define CLIST_NO_CLASS
+#	include "clist_type.h"
+#	define CLIST_MMAP_HUGEPAGES
+#	define CLIST_NAME mmap_huge
+#	define CLIST_NO_REF
+#	define CLIST_NO_CLASS
+#	include "clist_type.h"
+#	undef CLIST_USE_MMAP
+#	undef CLIST_MMAP_HUGEPAGES
+#	define CLIST_BLOCK_SIZE _CLIST_BLOCK_SIZE
+#endif
+
 #define BM(name, body) static void BM_##name(benchmark::State& state) { \
 		clist L; \
 		(void) L; \
@@ -58,6 +197,22 @@ BM(Clist_Initialize, {
 	benchmark::ClobberMemory();
 });
 
+static void BM_ClistArena_Initialize(benchmark::State& state) {
+	clist_arena A;
+	clist_pooled L;
+	clist_arena_init(&A, 1024 * 1024);
+
+	for (auto _ : state) {
+		clist_pooled_init_arena(&L, &A);
+		clist_pooled_free(&L);
+		clist_arena_reset(&A);
+		benchmark::ClobberMemory();
+	}
+
+	clist_arena_free(&A);
+}
+BENCHMARK(BM_ClistArena_Initialize);
+
 BM(CPPVector_Initialize, {
 	foo.reserve(CLIST_BLOCK_SIZE);
 	benchmark::ClobberMemory();
@@ -89,6 +244,78 @@ BM(Clist_Add1024, {
 	clist_free(&L);
 });
 
+static void BM_ClistArena_Add1024(benchmark::State& state) {
+	clist_arena A;
+	clist_pooled L;
+	clist_arena_init(&A, 1024 * 1024);
+
+	for (auto _ : state) {
+		clist_pooled_init_arena(&L, &A);
+
+		for (size_t i = 0; i < 1024; i++) {
+			if (clist_pooled_add(&L, (void *) i) == CLIST_ERR) {
+				state.SkipWithError("list add failed (check errno)");
+			}
+			benchmark::ClobberMemory();
+		}
+		benchmark::ClobberMemory();
+		clist_arena_reset(&A);
+	}
+
+	clist_arena_free(&A);
+}
+BENCHMARK(BM_ClistArena_Add1024);
+
+static void BM_Clist_Add1024x100Lists(benchmark::State& state) {
+	static clist lists[100];
+
+	for (auto _ : state) {
+		for (size_t l = 0; l < 100; l++) {
+			clist_init(&lists[l]);
+		}
+
+		for (size_t i = 0; i < 1024; i++) {
+			for (size_t l = 0; l < 100; l++) {
+				if (clist_add(&lists[l], (void *) i) == CLIST_ERR) {
+					state.SkipWithError("list add failed (check errno)");
+				}
+			}
+		}
+		benchmark::ClobberMemory();
+
+		for (size_t l = 0; l < 100; l++) {
+			clist_free(&lists[l]);
+		}
+	}
+}
+BENCHMARK(BM_Clist_Add1024x100Lists)->Unit(benchmark::kMicrosecond);
+
+static void BM_ClistArena_Add1024x100Lists(benchmark::State& state) {
+	static clist_pooled lists[100];
+	clist_arena A;
+	clist_arena_init(&A, 1024 * 1024);
+
+	for (auto _ : state) {
+		for (size_t l = 0; l < 100; l++) {
+			clist_pooled_init_arena(&lists[l], &A);
+		}
+
+		for (size_t i = 0; i < 1024; i++) {
+			for (size_t l = 0; l < 100; l++) {
+				if (clist_pooled_add(&lists[l], (void *) i) == CLIST_ERR) {
+					state.SkipWithError("list add failed (check errno)");
+				}
+			}
+		}
+		benchmark::ClobberMemory();
+
+		clist_arena_reset(&A);
+	}
+
+	clist_arena_free(&A);
+}
+BENCHMARK(BM_ClistArena_Add1024x100Lists)->Unit(benchmark::kMicrosecond);
+
 BM(CPPVector_Add1024, {
 	foo.reserve(CLIST_BLOCK_SIZE);
 
@@ -142,6 +369,76 @@ BM(CPPVector_Add1mil, {
 	}
 })->Unit(benchmark::kMicrosecond);
 
+BM_Init(Clist_AddN65k, {
+	for (size_t i = 0; i < 65536; i++) {
+		foo.push_back((void *) i);
+	}
+}, {
+	clist_init(&L);
+
+	if (clist_add_n(&L, foo.data(), foo.size()) == CLIST_ERR) {
+		state.SkipWithError("list add failed (check errno)");
+	}
+	benchmark::ClobberMemory();
+
+	clist_free(&L);
+})->Unit(benchmark::kMicrosecond);
+
+BM_Init(CPPVector_AddN65k, {
+	for (size_t i = 0; i < 65536; i++) {
+		foo.push_back((void *) i);
+	}
+}, {
+	std::vector<void*> bar;
+	bar.reserve(CLIST_BLOCK_SIZE);
+	bar.insert(bar.end(), foo.begin(), foo.end());
+	benchmark::ClobberMemory();
+})->Unit(benchmark::kMicrosecond);
+
+BM_Init(Clist_AddN1mil, {
+	for (size_t i = 0; i < 1000000; i++) {
+		foo.push_back((void *) i);
+	}
+}, {
+	clist_init(&L);
+
+	if (clist_add_n(&L, foo.data(), foo.size()) == CLIST_ERR) {
+		state.SkipWithError("list add failed (check errno)");
+	}
+	benchmark::ClobberMemory();
+
+	clist_free(&L);
+})->Unit(benchmark::kMicrosecond);
+
+BM_Init(CPPVector_AddN1mil, {
+	for (size_t i = 0; i < 1000000; i++) {
+		foo.push_back((void *) i);
+	}
+}, {
+	std::vector<void*> bar;
+	bar.reserve(CLIST_BLOCK_SIZE);
+	bar.insert(bar.end(), foo.begin(), foo.end());
+	benchmark::ClobberMemory();
+})->Unit(benchmark::kMicrosecond);
+
+BM_Init(Clist_AddNBatched1mil, {
+	for (size_t i = 0; i < 4096; i++) {
+		foo.push_back((void *) i);
+	}
+}, {
+	clist_init(&L);
+
+	for (size_t i = 0; i < 1000000; i += 4096) {
+		size_t n = 1000000 - i < 4096 ? 1000000 - i : 4096;
+		if (clist_add_n(&L, foo.data(), n) == CLIST_ERR) {
+			state.SkipWithError("list add failed (check errno)");
+		}
+		benchmark::ClobberMemory();
+	}
+
+	clist_free(&L);
+})->Unit(benchmark::kMicrosecond);
+
 BM(Clist_Add100mil, {
 	clist_init(&L);
 
@@ -164,6 +461,150 @@ BM(CPPVector_Add100mil, {
 	benchmark::ClobberMemory();
 })->Unit(benchmark::kMicrosecond);
 
+#ifdef __linux__
+#define BM_Mmap(name, type, count) static void BM_##name(benchmark::State& state) { \
+		clist_##type L; \
+		for (auto _ : state) { \
+			clist_##type##_init(&L); \
+			for (size_t i = 0; i < (count); i++) { \
+				if (clist_##type##_add(&L, (void *) i) == CLIST_ERR) { \
+					state.SkipWithError("list add failed (check errno)"); \
+				} \
+			} \
+			benchmark::ClobberMemory(); \
+			clist_##type##_free(&L); \
+		} \
+	} \
+	BENCHMARK(BM_##name)->Unit(benchmark::kMicrosecond)
+
+BM_Mmap(ClistMmap_Add1mil, mmap, 1000000);
+BM_Mmap(ClistMmapHuge_Add1mil, mmap_huge, 1000000);
+BM_Mmap(ClistMmap_Add100mil, mmap, 100000000);
+BM_Mmap(ClistMmapHuge_Add100mil, mmap_huge, 100000000);
+#endif
+
+BM(ClistSeg_Add1mil, {
+	clist_seg S;
+	clist_seg_init(&S);
+
+	for (size_t i = 0; i < 1000000; i++) {
+		if (clist_seg_add(&S, (void *) i) == CLIST_ERR) {
+			state.SkipWithError("list add failed (check errno)");
+		}
+		benchmark::ClobberMemory();
+	}
+
+	clist_seg_free(&S);
+})->Unit(benchmark::kMicrosecond);
+
+BM(ClistSwmr_Add1mil, {
+	clist_epoch E;
+	clist_swmr_swmr S;
+	clist_epoch_init(&E);
+	clist_swmr_swmr_init(&S, &E);
+
+	for (size_t i = 0; i < 1000000; i++) {
+		if (clist_swmr_swmr_add(&S, (void *) i) == CLIST_ERR) {
+			state.SkipWithError("list add failed (check errno)");
+		}
+		benchmark::ClobberMemory();
+	}
+
+	clist_swmr_swmr_free(&S);
+})->Unit(benchmark::kMicrosecond);
+
+/* a reader scanning 1mil elements, entering once per 1024 of them,
+   while the writer thread keeps appending to the same list */
+static void BM_ClistSwmr_ReadWhileAdding1mil(benchmark::State& state) {
+	clist_epoch E;
+	clist_swmr_swmr S;
+	bool stop = false;
+	clist_epoch_init(&E);
+	clist_swmr_swmr_init(&S, &E);
+	for (size_t i = 0; i < 1000000; i++) {
+		clist_swmr_swmr_add(&S, (void *) i);
+	}
+	std::thread writer([&S, &stop]() {
+		size_t i = 1000000;
+		while (!__atomic_load_n(&stop, __ATOMIC_RELAXED)) {
+			clist_swmr_swmr_add(&S, (void *) i++);
+			if (i % 1024 == 0) {
+				std::this_thread::yield();
+			}
+		}
+	});
+	clist_epoch_reader *r = clist_epoch_register(&E);
+	for (auto _ : state) {
+		for (size_t i = 0; i < 1000000; i += 1024) {
+			clist_epoch_enter(r);
+			for (size_t j = i; j < i + 1024 && j < 1000000; j++) {
+				if (*clist_swmr_swmr_get(&S, j) != (void *) j) {
+					state.SkipWithError("invalid get");
+				}
+			}
+			clist_epoch_leave(r);
+		}
+	}
+	clist_epoch_unregister(r);
+	__atomic_store_n(&stop, true, __ATOMIC_RELAXED);
+	writer.join();
+	clist_swmr_swmr_free(&S);
+}
+BENCHMARK(BM_ClistSwmr_ReadWhileAdding1mil)->UseRealTime()->Unit(benchmark::kMicrosecond);
+
+/* many small lists side by side, e.g. embedded in other structures */
+#define BM_ManySmall(name, type, prefix) static void BM_##name(benchmark::State& state) { \
+		static type lists[8192]; \
+		for (size_t l = 0; l < 8192; l++) { \
+			prefix##_init(&lists[l]); \
+			for (size_t i = 0; i < 3; i++) { \
+				if (prefix##_add(&lists[l], (void *) (l + i)) == CLIST_ERR) { \
+					state.SkipWithError("list add failed (check errno)"); \
+				} \
+			} \
+		} \
+		for (auto _ : state) { \
+			size_t sum = 0; \
+			for (size_t l = 0; l < 8192; l++) { \
+				for (size_t i = 0; i < prefix##_count(&lists[l]); i++) { \
+					sum += (size_t) *prefix##_get(&lists[l], i); \
+				} \
+			} \
+			benchmark::DoNotOptimize(sum); \
+		} \
+		for (size_t l = 0; l < 8192; l++) { \
+			prefix##_free(&lists[l]); \
+		} \
+	} \
+	BENCHMARK(BM_##name)->Unit(benchmark::kMicrosecond)
+
+BM_ManySmall(Clist_ScanSmallLists8k, clist, clist);
+BM_ManySmall(ClistInline4_ScanSmallLists8k, clist_inline4, clist_inline4);
+BM_ManySmall(ClistInline0_ScanSmallLists8k, clist_inline0, clist_inline0);
+
+#define BM_ManySmallInit(name, type, prefix) static void BM_##name(benchmark::State& state) { \
+		static type lists[8192]; \
+		for (auto _ : state) { \
+			for (size_t l = 0; l < 8192; l++) { \
+				prefix##_init(&lists[l]); \
+				for (size_t i = 0; i < 3; i++) { \
+					if (prefix##_add(&lists[l], (void *) (l + i)) == CLIST_ERR) { \
+						state.SkipWithError("list add failed (check errno)"); \
+					} \
+				} \
+			} \
+			benchmark::ClobberMemory(); \
+			for (size_t l = 0; l < 8192; l++) { \
+				prefix##_free(&lists[l]); \
+			} \
+		} \
+	} \
+	BENCHMARK(BM_##name)->Unit(benchmark::kMicrosecond)
+
+BM_ManySmallInit(Clist_FillSmallLists8k, clist, clist);
+BM_ManySmallInit(ClistInline4_FillSmallLists8k, clist_inline4, clist_inline4);
+BM_ManySmallInit(ClistInline0_FillSmallLists8k, clist_inline0, clist_inline0);
+
 BM(CList_Count, {
 	clist_init(&L);
 	benchmark::DoNotOptimize(clist_count(&L) == 0);
@@ -287,34 +728,1153 @@ BM_Init(CPPVector_Get1mil, {
 	}
 })->Unit(benchmark::kMicrosecond);
 
-BM_InitD(CList_Get100mil, {
+static size_t sum_ptrs(size_t acc, void *p) {
+	return acc + (size_t) p;
+}
+
+BM_InitD(CList_GetSum1mil, {
 	clist_init(&L);
 
-	for (size_t i = 0; i < 100000000; i++) {
+	for (size_t i = 0; i < 1000000; i++) {
 		if (clist_add(&L, (void *) i) == CLIST_ERR) {
 			state.SkipWithError("list add failed (check errno)");
 		}
 	}
 }, {
-	for (size_t i = 0; i < 100000000; i++) {
-		if (*clist_get(&L, i) != (void *) i) {
-			state.SkipWithError("invalid get");
+	size_t sum = 0;
+	for (size_t i = 0; i < clist_count(&L); i++) {
+		sum = sum_ptrs(sum, *clist_get(&L, i));
+	}
+	benchmark::DoNotOptimize(sum);
+}, {
+	clist_free(&L);
+})->Unit(benchmark::kMicrosecond);
+
+BM_InitD(CList_Accumulate1mil, {
+	clist_init(&L);
+
+	for (size_t i = 0; i < 1000000; i++) {
+		if (clist_add(&L, (void *) i) == CLIST_ERR) {
+			state.SkipWithError("list add failed (check errno)");
 		}
 	}
+}, {
+	void **data = clist_data(&L);
+	size_t sum = std::accumulate(data, data + clist_count(&L), (size_t) 0, sum_ptrs);
+	benchmark::DoNotOptimize(sum);
 }, {
 	clist_free(&L);
 })->Unit(benchmark::kMicrosecond);
 
-BM_Init(CPPVector_Get100mil, {
-	for (size_t i = 0; i < 100000000; i++) {
+BM_InitD(CList_Find1mil, {
+	clist_init(&L);
+
+	for (size_t i = 0; i < 1000000; i++) {
+		if (clist_add(&L, (void *) i) == CLIST_ERR) {
+			state.SkipWithError("list add failed (check errno)");
+		}
+	}
+}, {
+	void **data = clist_data(&L);
+	void **found = std::find(data, data + clist_count(&L), (void *) 999999);
+	if (found == data + clist_count(&L)) {
+		state.SkipWithError("not found");
+	}
+	benchmark::DoNotOptimize(found);
+}, {
+	clist_free(&L);
+})->Unit(benchmark::kMicrosecond);
+
+BM_Init(CPPVector_Find1mil, {
+	for (size_t i = 0; i < 1000000; i++) {
 		foo.push_back((void *) i);
 	}
 }, {
-	for (size_t i = 0; i < 100000000; i++) {
-		if (foo[i] != (void *) i) {
-			state.SkipWithError("invalid get");
+	auto found = std::find(foo.begin(), foo.end(), (void *) 999999);
+	if (found == foo.end()) {
+		state.SkipWithError("not found");
+	}
+	benchmark::DoNotOptimize(found);
+})->Unit(benchmark::kMicrosecond);
+
+/* sorting the same shuffled elements with clist_sort(), clist_radix_sort(),
+   std::sort() and qsort(3); the copy back into the list is part of every
+   iteration */
+#define BM_Sort(name, list, type, count, make, sort) static void BM_##name(benchmark::State& state) { \
+		clist_##list S; \
+		std::vector<type> input(count); \
+		for (size_t i = 0; i < input.size(); i++) { \
+			input[i] = make(i); \
+		} \
+		clist_##list##_init(&S); \
+		if (clist_##list##_add_n(&S, input.data(), input.size()) == CLIST_ERR) { \
+			state.SkipWithError("list add failed (check errno)"); \
+		} \
+		for (auto _ : state) { \
+			type *block = clist_##list##_data(&S); \
+			size_t n = clist_##list##_count(&S); \
+			memcpy((void *) block, input.data(), n * sizeof(type)); \
+			sort; \
+			benchmark::ClobberMemory(); \
+		} \
+		clist_##list##_free(&S); \
+	} \
+	BENCHMARK(BM_##name)->Unit(benchmark::kMicrosecond)
+
+static size_t sort_key(size_t i) {
+	return (i * 2654435761u) % 1000003;
+}
+
+static int sort_make_int(size_t i) {
+	return (int) sort_key(i) - 500000;
+}
+
+static sample sort_make_sample(size_t i) {
+	sample s = { (int) (sort_key(i) % 100), (int) sort_key(i + 1) };
+	return s;
+}
+
+static void *sort_make_ptr(size_t i) {
+	return (void *) sort_key(i);
+}
+
+static bool sort_less_sample(const sample &a, const sample &b) {
+	return a.foo != b.foo ? a.foo < b.foo : a.bar < b.bar;
+}
+
+static int qsort_cmp_int(const void *a, const void *b) {
+	int x = *(const int *) a;
+	int y = *(const int *) b;
+	return (x > y) - (x < y);
+}
+
+static int qsort_cmp_sample(const void *a, const void *b) {
+	const sample *x = (const sample *) a;
+	const sample *y = (const sample *) b;
+	return sort_less_sample(*y, *x) - sort_less_sample(*x, *y);
+}
+
+static int qsort_cmp_ptr(const void *a, const void *b) {
+	void *x = *(void *const *) a;
+	void *y = *(void *const *) b;
+	return (x > y) - (x < y);
+}
+
+#define BM_SORT_RADIX(list) \
+	if (clist_##list##_radix_sort(&S) != 0) { \
+		state.SkipWithError("radix sort failed (check errno)"); \
+	}
+
+#define BM_SORT_PARALLEL_RADIX(list) \
+	if (clist_##list##_parallel_radix_sort(&S) != 0) { \
+		state.SkipWithError("radix sort failed (check errno)"); \
+	}
+
+BM_Sort(ClistInt_Sort65k, sint, int, 65536, sort_make_int, clist_sint_sort(&S));
+BM_Sort(ClistInt_RadixSort65k, sint, int, 65536, sort_make_int, BM_SORT_RADIX(sint));
+BM_Sort(CPPStdSortInt_65k, sint, int, 65536, sort_make_int, std::sort(block, block + n));
+BM_Sort(ClistInt_Sort1mil, sint, int, 1000000, sort_make_int, clist_sint_sort(&S));
+BM_Sort(ClistInt_RadixSort1mil, sint, int, 1000000, sort_make_int, BM_SORT_RADIX(sint));
+BM_Sort(ClistInt_ParallelRadixSort1mil, sint, int, 1000000, sort_make_int, BM_SORT_PARALLEL_RADIX(sint));
+BM_Sort(CPPStdSortInt_1mil, sint, int, 1000000, sort_make_int, std::sort(block, block + n));
+BM_Sort(CQsortInt_1mil, sint, int, 1000000, sort_make_int, qsort(block, n, sizeof(int), &qsort_cmp_int));
+BM_Sort(ClistSample_Sort1mil, ssample, sample, 1000000, sort_make_sample, clist_ssample_sort(&S));
+BM_Sort(ClistSample_RadixSort1mil, ssample, sample, 1000000, sort_make_sample, BM_SORT_RADIX(ssample));
+BM_Sort(CPPStdSortSample_1mil, ssample, sample, 1000000, sort_make_sample, std::sort(block, block + n, &sort_less_sample));
+BM_Sort(CQsortSample_1mil, ssample, sample, 1000000, sort_make_sample, qsort(block, n, sizeof(sample), &qsort_cmp_sample));
+BM_Sort(ClistPtr_Sort1mil, sptr, void *, 1000000, sort_make_ptr, clist_sptr_sort(&S));
+BM_Sort(ClistPtr_RadixSort1mil, sptr, void *, 1000000, sort_make_ptr, BM_SORT_RADIX(sptr));
+BM_Sort(CPPStdSortPtr_1mil, sptr, void *, 1000000, sort_make_ptr, std::sort(block, block + n));
+BM_Sort(CQsortPtr_1mil, sptr, void *, 1000000, sort_make_ptr, qsort(block, n, sizeof(void *), &qsort_cmp_ptr));
+
+/* the SIMD kernels at each level the CPU supports (0 = plain loops, 1 = SSE2, 2 = AVX2) */
+#if CLIST_SIMD_SSE2
+static const int max_simd_level = clist__simd_level(-1);
+#	define BM_SIMD_LEVEL(state) do { \
+			if (state.range(0) > max_simd_level) { \
+				state.SkipWithError("not supported by this CPU"); \
+				return; \
+			} \
+			clist__simd_level((int) state.range(0)); \
+		} while (0)
+#else
+#	define BM_SIMD_LEVEL(state) do { \
+			if (state.range(0) > 0) { \
+				state.SkipWithError("no SIMD kernels on this platform"); \
+				return; \
+			} \
+		} while (0)
+#endif
+
+#define BM_Simd(name, init, body, dtor) static void BM_##name(benchmark::State& state) { \
+		clist L; \
+		clist_i32 I; \
+		(void) L; \
+		(void) I; \
+		BM_SIMD_LEVEL(state); \
+		init \
+		for (auto _ : state) { \
+			body \
+		} \
+		dtor \
+	} \
+	BENCHMARK(BM_##name)->Arg(0)->Arg(1)->Arg(2)->Unit(benchmark::kMicrosecond)
+
+#define BM_SIMD_FILL_PTR \
+	clist_init(&L); \
+	for (size_t i = 0; i < 1000000; i++) { \
+		clist_add(&L, (void *) i); \
+	}
+
+#define BM_SIMD_FILL_I32 \
+	clist_i32_init(&I); \
+	for (size_t i = 0; i < 1000000; i++) { \
+		clist_i32_add(&I, (int32_t) (i % 1000) - 500); \
+	}
+
+BM_Simd(CList_Sum1mil, BM_SIMD_FILL_PTR, {
+	benchmark::DoNotOptimize(clist_sum(&L));
+}, {
+	clist_free(&L);
+});
+
+BM_Simd(CList_MinMax1mil, BM_SIMD_FILL_PTR, {
+	void *min;
+	void *max;
+	clist_minmax(&L, &min, &max);
+	benchmark::DoNotOptimize(min);
+	benchmark::DoNotOptimize(max);
+}, {
+	clist_free(&L);
+});
+
+BM_Simd(CList_SimdFind1mil, BM_SIMD_FILL_PTR, {
+	if (clist_find(&L, (void *) 999999) != 999999) {
+		state.SkipWithError("not found");
+	}
+}, {
+	clist_free(&L);
+});
+
+BM_Simd(CList_CountEq1mil, BM_SIMD_FILL_PTR, {
+	benchmark::DoNotOptimize(clist_count_eq(&L, (void *) 1234));
+}, {
+	clist_free(&L);
+});
+
+BM_Simd(ClistI32_Sum1mil, BM_SIMD_FILL_I32, {
+	benchmark::DoNotOptimize(clist_i32_sum(&I));
+}, {
+	clist_i32_free(&I);
+});
+
+BM_Simd(ClistI32_MinMax1mil, BM_SIMD_FILL_I32, {
+	int32_t min;
+	int32_t max;
+	clist_i32_minmax(&I, &min, &max);
+	benchmark::DoNotOptimize(min);
+	benchmark::DoNotOptimize(max);
+}, {
+	clist_i32_free(&I);
+});
+
+BM_Simd(ClistI32_CountEq1mil, BM_SIMD_FILL_I32, {
+	benchmark::DoNotOptimize(clist_i32_count_eq(&I, 42));
+}, {
+	clist_i32_free(&I);
+});
+
+/* cold starts of a 10mil element list from a checkpoint: rebuilding it
+   with clist_add(), reading the file back, and mapping it (summing it
+   afterwards, so that every page is actually touched). the file is
+   in the page cache, so this is the best case for all of them. */
+static const char *persist_path() {
+	static const char *const path = "/tmp/clist-benchmark-persist.bin";
+	static bool saved = false;
+	if (!saved) {
+		clist_i32 I;
+		clist_i32_init(&I);
+		for (size_t i = 0; i < 10000000; i++) {
+			clist_i32_add(&I, (int32_t) i);
+		}
+		saved = clist_i32_save(&I, path) == 0;
+		clist_i32_free(&I);
+	}
+	return path;
+}
+
+BM(ClistPersist_Rebuild10mil, {
+	clist_i32 I;
+	clist_i32_init(&I);
+	for (size_t i = 0; i < 10000000; i++) {
+		if (clist_i32_add(&I, (int32_t) i) == CLIST_ERR) {
+			state.SkipWithError("list add failed (check errno)");
 		}
 	}
+	benchmark::DoNotOptimize(clist_i32_sum(&I));
+	clist_i32_free(&I);
+})->Unit(benchmark::kMicrosecond);
+
+static void BM_ClistPersist_Load10mil(benchmark::State& state) {
+	const char *path = persist_path();
+	for (auto _ : state) {
+		clist_i32 I;
+		clist_i32_init(&I);
+		if (clist_i32_load(&I, path) != 0) {
+			state.SkipWithError("load failed (check errno)");
+		}
+		benchmark::DoNotOptimize(clist_i32_sum(&I));
+		clist_i32_free(&I);
+	}
+}
+BENCHMARK(BM_ClistPersist_Load10mil)->Unit(benchmark::kMicrosecond);
+
+/* range(0) is the CLIST_MAP_* flags */
+static void BM_ClistPersist_Map10mil(benchmark::State& state) {
+	const char *path = persist_path();
+	for (auto _ : state) {
+		clist_i32_mapped M;
+		if (clist_i32_map(&M, path, (int) state.range(0)) != 0) {
+			state.SkipWithError("map failed (check errno)");
+			break;
+		}
+		benchmark::DoNotOptimize(clist_i32_sum(&M.list));
+		clist_i32_unmap(&M);
+	}
+}
+BENCHMARK(BM_ClistPersist_Map10mil)->Arg(0)->Arg(CLIST_MAP_VERIFY)->Arg(CLIST_MAP_POPULATE)->Unit(benchmark::kMicrosecond);
+
+/* range(0) is 0 or CLIST_SPILL_DIRECT; bytes/s is the append rate */
+static void BM_ClistSpill_Add10mil(benchmark::State& state) {
+	for (auto _ : state) {
+		clist_i32_spill S;
+		if (clist_i32_spill_init(&S, NULL, (int) state.range(0)) != 0) {
+			state.SkipWithError("spill init failed (check errno)");
+			break;
+		}
+		for (size_t i = 0; i < 10000000; i++) {
+			if (clist_i32_spill_add(&S, (int32_t) i) == CLIST_ERR) {
+				state.SkipWithError("spill add failed (check errno)");
+				break;
+			}
+		}
+		clist_i32_spill_free(&S);
+	}
+	state.SetBytesProcessed(state.iterations() * 10000000 * sizeof(int32_t));
+}
+BENCHMARK(BM_ClistSpill_Add10mil)->Arg(0)->Arg(CLIST_SPILL_DIRECT)->UseRealTime()->Unit(benchmark::kMicrosecond);
+
+static void BM_ClistI32_Add10mil(benchmark::State& state) {
+	for (auto _ : state) {
+		clist_i32 I;
+		clist_i32_init(&I);
+		for (size_t i = 0; i < 10000000; i++) {
+			if (clist_i32_add(&I, (int32_t) i) == CLIST_ERR) {
+				state.SkipWithError("list add failed (check errno)");
+				break;
+			}
+		}
+		clist_i32_free(&I);
+	}
+	state.SetBytesProcessed(state.iterations() * 10000000 * sizeof(int32_t));
+}
+BENCHMARK(BM_ClistI32_Add10mil)->UseRealTime()->Unit(benchmark::kMicrosecond);
+
+/* fills lists of range(1) elements with small allocations going on in
+   between, like they would in a real program, and counts how many of
+   the blocks the lists ended up with aren't cache line aligned.
+   range(0) is 1 for CLIST_ALIGNMENT 64. */
+template <typename L, void (*init)(L *), size_t (*add)(L *, int32_t), void (*free_list)(L *)>
+static void clist_alignment_fill(benchmark::State& state, size_t n, size_t *lists, size_t *misaligned) {
+	std::vector<void *> noise;
+	L lst;
+
+	init(&lst);
+	for (size_t i = 0; i < n; i++) {
+		size_t before = lst.capacity;
+		if (add(&lst, (int32_t) i) == CLIST_ERR) {
+			state.SkipWithError("list add failed (check errno)");
+			break;
+		}
+		if (lst.capacity != before) {
+			noise.push_back(malloc(48));
+		}
+	}
+
+	*lists += 1;
+	*misaligned += (size_t) lst.block % 64 != 0;
+
+	free_list(&lst);
+	for (void *p : noise) {
+		free(p);
+	}
+}
+
+static void BM_ClistAlignment_Fill(benchmark::State& state) {
+	size_t n = (size_t) state.range(1);
+	size_t lists = 0;
+	size_t misaligned = 0;
+
+	for (auto _ : state) {
+		if (state.range(0)) {
+			clist_alignment_fill<clist_al64, clist_al64_init, clist_al64_add, clist_al64_free>(state, n, &lists, &misaligned);
+		} else {
+			clist_alignment_fill<clist_i32, clist_i32_init, clist_i32_add, clist_i32_free>(state, n, &lists, &misaligned);
+		}
+	}
+
+	state.counters["misaligned_pct"] = lists ? 100.0 * (double) misaligned / (double) lists : 0;
+	state.SetItemsProcessed(state.iterations() * n);
+	state.SetLabel(state.range(0) ? "aligned 64" : "default");
+}
+BENCHMARK(BM_ClistAlignment_Fill)->ArgsProduct({{0, 1}, {100, 1000, 100000, 10000000}})->UseRealTime()->Unit(benchmark::kMicrosecond);
+
+/* what CLIST_STATS costs when filling one big list... */
+static void BM_ClistStats_Add10mil(benchmark::State& state) {
+	for (auto _ : state) {
+		clist_stat I;
+		clist_stat_init(&I);
+		for (size_t i = 0; i < 10000000; i++) {
+			if (clist_stat_add(&I, (int32_t) i) == CLIST_ERR) {
+				state.SkipWithError("list add failed (check errno)");
+				break;
+			}
+		}
+		clist_stat_free(&I);
+	}
+	state.SetBytesProcessed(state.iterations() * 10000000 * sizeof(int32_t));
+}
+BENCHMARK(BM_ClistStats_Add10mil)->UseRealTime()->Unit(benchmark::kMicrosecond);
+
+/* ...and many short-lived small ones, each of which folds its counters
+   into the type's on free(). range(0) is 1 with CLIST_STATS. */
+static void BM_ClistStats_SmallLists(benchmark::State& state) {
+	for (auto _ : state) {
+		for (size_t n = 0; n < 100000; n++) {
+			if (state.range(0)) {
+				clist_stat I;
+				clist_stat_init(&I);
+				for (size_t i = 0; i < 40; i++) {
+					clist_stat_add(&I, (int32_t) i);
+				}
+				benchmark::DoNotOptimize(I.block);
+				clist_stat_free(&I);
+			} else {
+				clist_i32 I;
+				clist_i32_init(&I);
+				for (size_t i = 0; i < 40; i++) {
+					clist_i32_add(&I, (int32_t) i);
+				}
+				benchmark::DoNotOptimize(I.block);
+				clist_i32_free(&I);
+			}
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * 100000);
+	state.SetLabel(state.range(0) ? "stats" : "plain");
+}
+BENCHMARK(BM_ClistStats_SmallLists)->Arg(0)->Arg(1)->UseRealTime()->Unit(benchmark::kMicrosecond);
+
+static void BM_ClistSpill_Scan10mil(benchmark::State& state) {
+	clist_i32_spill S;
+	if (clist_i32_spill_init(&S, NULL, (int) state.range(0)) != 0) {
+		state.SkipWithError("spill init failed (check errno)");
+		return;
+	}
+	for (size_t i = 0; i < 10000000; i++) {
+		clist_i32_spill_add(&S, (int32_t) i);
+	}
+
+	for (auto _ : state) {
+		int64_t sum = 0;
+		int32_t *elems;
+		size_t n;
+		for (size_t i = 0; (n = clist_i32_spill_scan(&S, i, &elems)) != 0; i += n) {
+			if (n == CLIST_ERR) {
+				state.SkipWithError("spill scan failed (check errno)");
+				break;
+			}
+			for (size_t j = 0; j < n; j++) {
+				sum += elems[j];
+			}
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetBytesProcessed(state.iterations() * 10000000 * sizeof(int32_t));
+
+	clist_i32_spill_free(&S);
+}
+BENCHMARK(BM_ClistSpill_Scan10mil)->Arg(0)->Arg(CLIST_SPILL_DIRECT)->UseRealTime()->Unit(benchmark::kMicrosecond);
+
+static void BM_ClistI32_Scan10mil(benchmark::State& state) {
+	clist_i32 I;
+	clist_i32_init(&I);
+	for (size_t i = 0; i < 10000000; i++) {
+		clist_i32_add(&I, (int32_t) i);
+	}
+
+	for (auto _ : state) {
+		int64_t sum = 0;
+		for (size_t i = 0; i < 10000000; i++) {
+			sum += *clist_i32_get(&I, i);
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetBytesProcessed(state.iterations() * 10000000 * sizeof(int32_t));
+
+	clist_i32_free(&I);
+}
+BENCHMARK(BM_ClistI32_Scan10mil)->UseRealTime()->Unit(benchmark::kMicrosecond);
+
+/* random gets over a list 10x the size of what's kept in memory */
+static void BM_ClistSpill_RandomGet(benchmark::State& state) {
+	clist_i32_spill S;
+	if (clist_i32_spill_init(&S, NULL, 0) != 0) {
+		state.SkipWithError("spill init failed (check errno)");
+		return;
+	}
+	size_t n = S.block_elems * (CLIST_SPILL_HOT_BLOCKS + CLIST_SPILL_CACHE_BLOCKS) * 10;
+	for (size_t i = 0; i < n; i++) {
+		clist_i32_spill_add(&S, (int32_t) i);
+	}
+
+	size_t idx = 0;
+	for (auto _ : state) {
+		idx = (idx + 7919 * 131) % n;
+		benchmark::DoNotOptimize(clist_i32_spill_get(&S, idx));
+	}
+
+	clist_i32_spill_free(&S);
+}
+BENCHMARK(BM_ClistSpill_RandomGet);
+
+/* a reader picking up 10M elements another process has written: in
+   place from shared memory, or copied out of it the way a serialized
+   handoff would have to */
+static void shm_bench_unlink() {
+	shm_unlink("/clist-benchmark-shm");
+}
+
+static const char *shm_bench_name() {
+	static const char *const name = "/clist-benchmark-shm";
+	static bool created = false;
+	static clist_i32_shm W;
+	if (!created) {
+		shm_unlink(name);
+		atexit(&shm_bench_unlink);
+		created = clist_i32_shm_create(&W, name, 10000000) == 0;
+		for (size_t i = 0; created && i < 10000000; i++) {
+			clist_i32_shm_add(&W, (int32_t) i);
+		}
+	}
+	return name;
+}
+
+static void BM_ClistShm_AttachSum10mil(benchmark::State& state) {
+	const char *name = shm_bench_name();
+	for (auto _ : state) {
+		clist_i32_shm R;
+		clist_i32 V;
+		if (clist_i32_shm_attach(&R, name) != 0) {
+			state.SkipWithError("attach failed (check errno)");
+			break;
+		}
+		clist_i32_shm_view(&R, &V);
+		benchmark::DoNotOptimize(clist_i32_sum(&V));
+		clist_i32_shm_detach(&R);
+	}
+}
+BENCHMARK(BM_ClistShm_AttachSum10mil)->Unit(benchmark::kMicrosecond);
+
+static void BM_ClistShm_CopySum10mil(benchmark::State& state) {
+	const char *name = shm_bench_name();
+	for (auto _ : state) {
+		clist_i32_shm R;
+		clist_i32 I;
+		if (clist_i32_shm_attach(&R, name) != 0) {
+			state.SkipWithError("attach failed (check errno)");
+			break;
+		}
+		size_t n = clist_i32_shm_count(&R);
+		clist_i32_init(&I);
+		clist_i32_reserve(&I, n);
+		memcpy(I.block, clist_i32_shm_get(&R, 0), n * sizeof(int32_t));
+		I.count = n;
+		benchmark::DoNotOptimize(clist_i32_sum(&I));
+		clist_i32_free(&I);
+		clist_i32_shm_detach(&R);
+	}
+}
+BENCHMARK(BM_ClistShm_CopySum10mil)->Unit(benchmark::kMicrosecond);
+
+static void BM_ClistShm_Add10mil(benchmark::State& state) {
+	static const char *const name = "/clist-benchmark-shm-add";
+	for (auto _ : state) {
+		clist_i32_shm W;
+		shm_unlink(name);
+		if (clist_i32_shm_create(&W, name, 0) != 0) {
+			state.SkipWithError("create failed (check errno)");
+			break;
+		}
+		for (size_t i = 0; i < 10000000; i++) {
+			clist_i32_shm_add(&W, (int32_t) i);
+		}
+		clist_i32_shm_detach(&W);
+		shm_unlink(name);
+	}
+}
+BENCHMARK(BM_ClistShm_Add10mil)->Unit(benchmark::kMicrosecond);
+
+/* summing one field of struct sample, as structs side by side (AoS)
+   or with a column per field (SoA) */
+static void BM_ClistAos_SumFoo10mil(benchmark::State& state) {
+	clist_ssample L;
+	clist_ssample_init(&L);
+	for (size_t i = 0; i < 10000000; i++) {
+		clist_ssample_add(&L, sample{(int) i, (int) (i >> 3)});
+	}
+
+	for (auto _ : state) {
+		const sample *block = L.block;
+		int64_t sum = 0;
+		for (size_t i = 0; i < L.count; i++) {
+			sum += block[i].foo;
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetBytesProcessed(state.iterations() * 10000000 * sizeof(int));
+
+	clist_ssample_free(&L);
+}
+BENCHMARK(BM_ClistAos_SumFoo10mil)->Unit(benchmark::kMicrosecond);
+
+static void BM_ClistSoa_SumFoo10mil(benchmark::State& state) {
+	clist_ssample_soa S;
+	clist_ssample_soa_init(&S);
+	for (size_t i = 0; i < 10000000; i++) {
+		clist_ssample_soa_add(&S, sample{(int) i, (int) (i >> 3)});
+	}
+
+	for (auto _ : state) {
+		const int *foos = clist_ssample_soa_col_foo(&S);
+		size_t n = clist_ssample_soa_count(&S);
+		int64_t sum = 0;
+		for (size_t i = 0; i < n; i++) {
+			sum += foos[i];
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetBytesProcessed(state.iterations() * 10000000 * sizeof(int));
+
+	clist_ssample_soa_free(&S);
+}
+BENCHMARK(BM_ClistSoa_SumFoo10mil)->Unit(benchmark::kMicrosecond);
+
+/* the process' peak resident set since the last reset_peak_resident(),
+   less what was resident at the reset; 0 where we can't tell */
+static size_t peak_resident_base = 0;
+
+static size_t read_status_kb(const char *key) {
+	size_t kb = 0;
+#ifdef __linux__
+	char line[256];
+	size_t key_len = strlen(key);
+	FILE *f = fopen("/proc/self/status", "r");
+	if (f != NULL) {
+		while (fgets(line, sizeof(line), f) != NULL) {
+			if (strncmp(line, key, key_len) == 0) {
+				kb = (size_t) strtoul(line + key_len, NULL, 10);
+				break;
+			}
+		}
+		fclose(f);
+	}
+#else
+	(void) key;
+#endif
+	return kb;
+}
+
+static void reset_peak_resident() {
+#ifdef __linux__
+	/* "5" resets VmHWM to the current RSS (Linux 4.0+) */
+	FILE *f = fopen("/proc/self/clear_refs", "w");
+	if (f != NULL) {
+		fputs("5", f);
+		fclose(f);
+	}
+#endif
+	peak_resident_base = read_status_kb("VmRSS:");
+}
+
+static size_t peak_resident_bytes() {
+	size_t peak = read_status_kb("VmHWM:");
+	return peak > peak_resident_base ? (peak - peak_resident_base) * 1024 : 0;
+}
+
+static size_t grow_doubling(void *, size_t capacity, size_t n_elems) {
+	size_t next = capacity < 512 ? 512 : capacity * 2;
+	return next < n_elems ? n_elems : next;
+}
+
+/* range(0) picks the policy, range(1) is how many elements get added.
+   peak_rss_MB is how far the process' resident set went up while
+   filling the list (copies during reallocs included); capacity_MB is
+   what the list ended up reserving. */
+static void BM_ClistGrowth_Add(benchmark::State& state) {
+	static const clist_growth policies[] = {
+		CLIST_GROWTH_GEOMETRIC_INIT(4, 1), /* placeholder, 0 is the default */
+		CLIST_GROWTH_GEOMETRIC_INIT(2, 1),
+		CLIST_GROWTH_GEOMETRIC_INIT(3, 2),
+		CLIST_GROWTH_LINEAR_INIT(1 << 20),
+		CLIST_GROWTH_CAPPED_INIT(1 << 22),
+		CLIST_GROWTH_CALLBACK_INIT(&grow_doubling, NULL),
+	};
+	static const char *const names[] = { "default x4", "x2", "x1.5", "linear 1M", "capped 4M", "callback x2" };
+	size_t policy = (size_t) state.range(0);
+	size_t n = (size_t) state.range(1);
+	double rss = 0;
+	double capacity = 0;
+
+	for (auto _ : state) {
+		clist_policy G;
+		state.PauseTiming();
+		reset_peak_resident();
+		state.ResumeTiming();
+		clist_policy_init(&G);
+		if (policy != 0) {
+			clist_policy_set_growth(&G, &policies[policy]);
+		}
+		for (size_t i = 0; i < n; i++) {
+			if (clist_policy_add(&G, (void *) i) == CLIST_ERR) {
+				state.SkipWithError("list add failed (check errno)");
+				break;
+			}
+		}
+		state.PauseTiming();
+		rss += (double) peak_resident_bytes();
+		state.ResumeTiming();
+		capacity += (double) (G.capacity * sizeof(void *));
+		clist_policy_free(&G);
+	}
+
+	state.SetLabel(names[policy]);
+	state.counters["peak_rss_MB"] = benchmark::Counter(rss / (1 << 20), benchmark::Counter::kAvgIterations);
+	state.counters["capacity_MB"] = benchmark::Counter(capacity / (1 << 20), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_ClistGrowth_Add)->ArgsProduct({{0, 1, 2, 3, 4, 5}, {1024, 65536, 1000000, 100000000}})->Unit(benchmark::kMicrosecond);
+
+static void BM_ClistSeg_Get1mil(benchmark::State& state) {
+	clist_seg S;
+	clist_seg_init(&S);
+
+	for (size_t i = 0; i < 1000000; i++) {
+		if (clist_seg_add(&S, (void *) i) == CLIST_ERR) {
+			state.SkipWithError("list add failed (check errno)");
+		}
+	}
+
+	for (auto _ : state) {
+		for (size_t i = 0; i < 1000000; i++) {
+			if (*clist_seg_get(&S, i) != (void *) i) {
+				state.SkipWithError("invalid get");
+			}
+		}
+	}
+
+	clist_seg_free(&S);
+}
+BENCHMARK(BM_ClistSeg_Get1mil)->Unit(benchmark::kMicrosecond);
+
+BM_InitD(CList_Get100mil, {
+	clist_init(&L);
+
+	for (size_t i = 0; i < 100000000; i++) {
+		if (clist_add(&L, (void *) i) == CLIST_ERR) {
+			state.SkipWithError("list add failed (check errno)");
+		}
+	}
+}, {
+	for (size_t i = 0; i < 100000000; i++) {
+		if (*clist_get(&L, i) != (void *) i) {
+			state.SkipWithError("invalid get");
+		}
+	}
+}, {
+	clist_free(&L);
+})->Unit(benchmark::kMicrosecond);
+
+/* the same 100mil scans spread over 1-8 threads; wall time, since the
+   CPU time only counts the calling thread */
+#define BM_Par(name, body) static void BM_##name(benchmark::State& state) { \
+		clist_par P; \
+		clist_parallel_threads((size_t) state.range(0)); \
+		clist_par_init(&P); \
+		for (size_t i = 0; i < 100000000; i++) { \
+			if (clist_par_add(&P, (void *) i) == CLIST_ERR) { \
+				state.SkipWithError("list add failed (check errno)"); \
+			} \
+		} \
+		for (auto _ : state) { \
+			body \
+		} \
+		clist_par_free(&P); \
+	} \
+	BENCHMARK(BM_##name)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime()->Unit(benchmark::kMicrosecond)
+
+static void par_check(void **block, size_t begin, size_t end, void *ctx) {
+	for (; begin < end; begin++) {
+		if (block[begin] != (void *) begin) {
+			__atomic_store_n((int *) ctx, 1, __ATOMIC_RELAXED);
+		}
+	}
+}
+
+BM_Par(ClistPar_Get100mil, {
+	int invalid = 0;
+	clist_par_parallel_for(&P, &par_check, &invalid);
+	if (invalid) {
+		state.SkipWithError("invalid get");
+	}
+});
+
+BM_Par(ClistPar_Sum100mil, {
+	size_t sum = 0;
+	if (clist_par_parallel_reduce(&P, &sum,
+		[](size_t acc, void *val) { return acc + (size_t) val; },
+		[](size_t acc, size_t partial) { return acc + partial; }) != 0) {
+		state.SkipWithError("reduce failed (check errno)");
+	}
+	benchmark::DoNotOptimize(sum);
+});
+
+/* 1-8 threads adding to one shared list; thread 0 sets it up before
+   the others start and frees it after they're done. the iterations are
+   fixed since the list only ever grows. */
+static clist_conc_conc conc_shared;
+
+static void BM_ClistConc_Add1024(benchmark::State& state) {
+	if (state.thread_index() == 0) {
+		clist_conc_conc_init(&conc_shared);
+	}
+	for (auto _ : state) {
+		for (size_t i = 0; i < 1024; i++) {
+			if (clist_conc_conc_add(&conc_shared, (void *) i) == CLIST_ERR) {
+				state.SkipWithError("list add failed (check errno)");
+			}
+		}
+	}
+	if (state.thread_index() == 0) {
+		clist_conc_conc_free(&conc_shared);
+	}
+	state.SetItemsProcessed(state.iterations() * 1024);
+}
+BENCHMARK(BM_ClistConc_Add1024)->ThreadRange(1, 8)->Iterations(2048)->UseRealTime()->Unit(benchmark::kMicrosecond);
+
+static clist mutex_shared;
+static std::mutex mutex_shared_lock;
+
+static void BM_ClistMutex_Add1024(benchmark::State& state) {
+	if (state.thread_index() == 0) {
+		clist_init(&mutex_shared);
+	}
+	for (auto _ : state) {
+		for (size_t i = 0; i < 1024; i++) {
+			std::lock_guard<std::mutex> lock(mutex_shared_lock);
+			if (clist_add(&mutex_shared, (void *) i) == CLIST_ERR) {
+				state.SkipWithError("list add failed (check errno)");
+			}
+		}
+	}
+	if (state.thread_index() == 0) {
+		clist_free(&mutex_shared);
+	}
+	state.SetItemsProcessed(state.iterations() * 1024);
+}
+BENCHMARK(BM_ClistMutex_Add1024)->ThreadRange(1, 8)->Iterations(2048)->UseRealTime()->Unit(benchmark::kMicrosecond);
+
+/* a producer thread keeps a 1024 slot ring full while the benchmark
+   thread drains 64k elements per iteration, in batches of range(0) */
+static void BM_ClistRing_Handoff64k(benchmark::State& state) {
+	clist_ring_ring R;
+	size_t batch_size = (size_t) state.range(0);
+	bool stop = false;
+	if (clist_ring_ring_init(&R, 1024) != 0) {
+		state.SkipWithError("ring init failed (check errno)");
+		return;
+	}
+	std::thread producer([&R, &stop, batch_size]() {
+		std::vector<void *> batch(batch_size);
+		size_t next = 0;
+		while (!__atomic_load_n(&stop, __ATOMIC_RELAXED)) {
+			for (size_t i = 0; i < batch_size; i++) {
+				batch[i] = (void *) (next + i);
+			}
+			size_t n = clist_ring_ring_push_n(&R, batch.data(), batch_size);
+			if (n == 0) {
+				std::this_thread::yield();
+			}
+			next += n;
+		}
+	});
+	std::vector<void *> out(batch_size);
+	size_t expected = 0;
+	for (auto _ : state) {
+		for (size_t got = 0; got < 65536;) {
+			size_t n = clist_ring_ring_pop_n(&R, out.data(), batch_size);
+			if (n == 0) {
+				std::this_thread::yield();
+			}
+			for (size_t i = 0; i < n; i++) {
+				if (out[i] != (void *) expected++) {
+					state.SkipWithError("out of order");
+				}
+			}
+			got += n;
+		}
+	}
+	__atomic_store_n(&stop, true, __ATOMIC_RELAXED);
+	producer.join();
+	clist_ring_ring_free(&R);
+	state.SetItemsProcessed(state.iterations() * 65536);
+}
+BENCHMARK(BM_ClistRing_Handoff64k)->Arg(1)->Arg(16)->Arg(256)->UseRealTime()->Unit(benchmark::kMicrosecond);
+
+/* one element there and back again through a pair of rings */
+static void BM_ClistRing_RoundTrip(benchmark::State& state) {
+	clist_ring_ring ping;
+	clist_ring_ring pong;
+	if (clist_ring_ring_init(&ping, 16) != 0 || clist_ring_ring_init(&pong, 16) != 0) {
+		state.SkipWithError("ring init failed (check errno)");
+		return;
+	}
+	std::thread echo([&ping, &pong]() {
+		void *val;
+		for (;;) {
+			while (!clist_ring_ring_pop(&ping, &val)) {
+				std::this_thread::yield();
+			}
+			if (val == NULL) {
+				break;
+			}
+			while (!clist_ring_ring_push(&pong, val)) {
+				std::this_thread::yield();
+			}
+		}
+	});
+	void *val = (void *) 1;
+	for (auto _ : state) {
+		clist_ring_ring_push(&ping, val);
+		while (!clist_ring_ring_pop(&pong, &val)) {
+			std::this_thread::yield();
+		}
+	}
+	clist_ring_ring_push(&ping, NULL);
+	echo.join();
+	clist_ring_ring_free(&ping);
+	clist_ring_ring_free(&pong);
+}
+BENCHMARK(BM_ClistRing_RoundTrip)->UseRealTime();
+
+/* 8 shards of 1mil each, joined into one list; filling them isn't timed */
+static void BM_ClistPar_ShardedMerge8mil(benchmark::State& state) {
+	clist_par_sharded B;
+	clist_par P;
+	clist_parallel_threads((size_t) state.range(0));
+	if (clist_par_sharded_init(&B, 8) != 0) {
+		state.SkipWithError("sharded init failed (check errno)");
+		return;
+	}
+	for (auto _ : state) {
+		state.PauseTiming();
+		clist_par_init(&P);
+		for (size_t t = 0; t < 8; t++) {
+			for (size_t i = 0; i < 1000000; i++) {
+				clist_par_add(clist_par_sharded_shard(&B, t), (void *) i);
+			}
+		}
+		state.ResumeTiming();
+		if (clist_par_sharded_merge(&B, &P) != 0) {
+			state.SkipWithError("merge failed (check errno)");
+		}
+		benchmark::DoNotOptimize(P);
+		state.PauseTiming();
+		clist_par_free(&P);
+		state.ResumeTiming();
+	}
+	clist_par_sharded_free(&B);
+}
+BENCHMARK(BM_ClistPar_ShardedMerge8mil)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime()->Unit(benchmark::kMicrosecond);
+
+/* the same join done by hand, one clist_add() at a time */
+static void BM_ClistPar_ConcatAdd8mil(benchmark::State& state) {
+	clist_par shards[8];
+	clist_par P;
+	for (size_t t = 0; t < 8; t++) {
+		clist_par_init(&shards[t]);
+	}
+	for (auto _ : state) {
+		state.PauseTiming();
+		clist_par_init(&P);
+		for (size_t t = 0; t < 8; t++) {
+			clist_par_clear(&shards[t]);
+			for (size_t i = 0; i < 1000000; i++) {
+				clist_par_add(&shards[t], (void *) i);
+			}
+		}
+		state.ResumeTiming();
+		for (size_t t = 0; t < 8; t++) {
+			for (size_t i = 0; i < clist_par_count(&shards[t]); i++) {
+				if (clist_par_add(&P, *clist_par_get(&shards[t], i)) == CLIST_ERR) {
+					state.SkipWithError("list add failed (check errno)");
+				}
+			}
+		}
+		benchmark::DoNotOptimize(P);
+		state.PauseTiming();
+		clist_par_free(&P);
+		state.ResumeTiming();
+	}
+	for (size_t t = 0; t < 8; t++) {
+		clist_par_free(&shards[t]);
+	}
+}
+BENCHMARK(BM_ClistPar_ConcatAdd8mil)->Unit(benchmark::kMicrosecond);
+
+BM_Init(CPPVector_Get100mil, {
+	for (size_t i = 0; i < 100000000; i++) {
+		foo.push_back((void *) i);
+	}
+}, {
+	for (size_t i = 0; i < 100000000; i++) {
+		if (foo[i] != (void *) i) {
+			state.SkipWithError("invalid get");
+		}
+	}
+})->Unit(benchmark::kMicrosecond);
+
+BM_InitD(Clist_Pop1024, {
+	clist_init(&L);
+}, {
+	for (size_t i = 0; i < 1024; i++) {
+		if (clist_add(&L, (void *) i) == CLIST_ERR) {
+			state.SkipWithError("list add failed (check errno)");
+		}
+	}
+	for (size_t i = 0; i < 1024; i++) {
+		benchmark::DoNotOptimize(clist_pop(&L));
+	}
+	benchmark::ClobberMemory();
+}, {
+	clist_free(&L);
+});
+
+BM(CPPVector_Pop1024, {
+	for (size_t i = 0; i < 1024; i++) {
+		foo.push_back((void *) i);
+	}
+	for (size_t i = 0; i < 1024; i++) {
+		benchmark::DoNotOptimize(foo.back());
+		foo.pop_back();
+	}
+	benchmark::ClobberMemory();
+});
+
+BM_InitD(Clist_RemoveFront1024, {
+	clist_init(&L);
+}, {
+	for (size_t i = 0; i < 1024; i++) {
+		if (clist_add(&L, (void *) i) == CLIST_ERR) {
+			state.SkipWithError("list add failed (check errno)");
+		}
+	}
+	for (size_t i = 0; i < 1024; i++) {
+		clist_remove(&L, 0);
+	}
+	benchmark::ClobberMemory();
+}, {
+	clist_free(&L);
+});
+
+BM(CPPVector_EraseFront1024, {
+	for (size_t i = 0; i < 1024; i++) {
+		foo.push_back((void *) i);
+	}
+	for (size_t i = 0; i < 1024; i++) {
+		foo.erase(foo.begin());
+	}
+	benchmark::ClobberMemory();
+});
+
+BM_InitD(Clist_SwapRemoveFront65k, {
+	clist_init(&L);
+}, {
+	for (size_t i = 0; i < 65536; i++) {
+		if (clist_add(&L, (void *) i) == CLIST_ERR) {
+			state.SkipWithError("list add failed (check errno)");
+		}
+	}
+	for (size_t i = 0; i < 65536; i++) {
+		clist_swap_remove(&L, 0);
+	}
+	benchmark::ClobberMemory();
+}, {
+	clist_free(&L);
+})->Unit(benchmark::kMicrosecond);
+
+BM(CPPVector_SwapPopFront65k, {
+	for (size_t i = 0; i < 65536; i++) {
+		foo.push_back((void *) i);
+	}
+	for (size_t i = 0; i < 65536; i++) {
+		foo.front() = foo.back();
+		foo.pop_back();
+	}
+	benchmark::ClobberMemory();
+})->Unit(benchmark::kMicrosecond);
+
+BM_InitD(Clist_InsertFront1024, {
+	clist_init(&L);
+}, {
+	for (size_t i = 0; i < 1024; i++) {
+		if (clist_insert(&L, 0, (void *) i) == CLIST_ERR) {
+			state.SkipWithError("list insert failed (check errno)");
+		}
+	}
+	benchmark::ClobberMemory();
+	clist_clear(&L);
+}, {
+	clist_free(&L);
+});
+
+BM(CPPVector_InsertFront1024, {
+	for (size_t i = 0; i < 1024; i++) {
+		foo.insert(foo.begin(), (void *) i);
+	}
+	benchmark::ClobberMemory();
+	foo.clear();
+});
+
+BM_InitD(Clist_Clear65k, {
+	clist_init(&L);
+}, {
+	for (size_t i = 0; i < 65536; i++) {
+		if (clist_add(&L, (void *) i) == CLIST_ERR) {
+			state.SkipWithError("list add failed (check errno)");
+		}
+	}
+	clist_clear(&L);
+	benchmark::ClobberMemory();
+}, {
+	clist_free(&L);
+})->Unit(benchmark::kMicrosecond);
+
+BM(CPPVector_Clear65k, {
+	for (size_t i = 0; i < 65536; i++) {
+		foo.push_back((void *) i);
+	}
+	foo.clear();
+	benchmark::ClobberMemory();
 })->Unit(benchmark::kMicrosecond);
 
 BENCHMARK_MAIN();
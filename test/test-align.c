@@ -0,0 +1,311 @@
+#define _POSIX_C_SOURCE 200112L /* posix_memalign(3) */
+
+#ifdef NDEBUG
+	/* TODO better assert instead of std assert */
+#	undef NDEBUG
+#	define _CLIST_NDEBUG
+#endif
+
+#include <assert.h>
+#include <errno.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+#define CLIST_ALIGNMENT 64
+#define CLIST_NAME align
+#define CLIST_TYPE int
+#define CLIST_BLOCK_SIZE 4
+#define CLIST_BLOCK_GROWTH_RATE 2
+#include "clist_type.h"
+
+#define CLIST_ALIGNMENT 128
+#define CLIST_ARENA
+#define CLIST_NAME align_arena
+#define CLIST_TYPE double
+#define CLIST_BLOCK_SIZE 2
+#include "clist_type.h"
+
+#define CLIST_ALIGNMENT 32
+#define CLIST_SAFE_REALLOC
+#define CLIST_NAME align_safe
+#define CLIST_TYPE short
+#define CLIST_BLOCK_SIZE 8
+#define CLIST_BLOCK_GROWTH_RATE 2
+#include "clist_type.h"
+
+/* hooks that can be made to fail, and that count realloc()s */
+static int hook_fail = 0;
+static size_t hook_reallocs = 0;
+
+#define CLIST_ALLOC(_ptrptr, _size) do { \
+		if (hook_fail || posix_memalign((_ptrptr), 64, (_size)) != 0) { \
+			*(_ptrptr) = NULL; \
+			errno = ENOMEM; \
+		} \
+	} while (0)
+#define CLIST_REALLOC(_success_out, _ptrptr, _size) do { \
+		void *_p = realloc(*(_ptrptr), (_size)); \
+		hook_reallocs++; \
+		*(_success_out) = _p != NULL; \
+		if (_p != NULL) { *(_ptrptr) = _p; } \
+	} while (0)
+#define CLIST_FREE(_ptr) free((_ptr))
+#define CLIST_ALIGNMENT 64
+#define CLIST_NAME align_hook
+#define CLIST_TYPE int
+#define CLIST_BLOCK_SIZE 4
+#define CLIST_BLOCK_GROWTH_RATE 2
+#include "clist_type.h"
+
+/* every block gets at least EXPAND_SLAB bytes, so it can grow in place
+   up to there */
+#define EXPAND_SLAB 4096
+static size_t hook_allocs = 0;
+static size_t hook_expands = 0;
+
+#define CLIST_ALLOC(_ptrptr, _size) do { \
+		hook_allocs++; \
+		if (posix_memalign((_ptrptr), 64, (_size) < EXPAND_SLAB ? EXPAND_SLAB : (_size)) != 0) { \
+			*(_ptrptr) = NULL; \
+			errno = ENOMEM; \
+		} \
+	} while (0)
+#define CLIST_REALLOC(_success_out, _ptrptr, _size) do { \
+		hook_reallocs++; \
+		*(_success_out) = 0; \
+	} while (0)
+#define CLIST_EXPAND(_success_out, _ptr, _size) do { \
+		(void) (_ptr); \
+		hook_expands++; \
+		*(_success_out) = (_size) <= EXPAND_SLAB; \
+	} while (0)
+#define CLIST_FREE(_ptr) free((_ptr))
+#define CLIST_ALIGNMENT 64
+#define CLIST_NAME align_inplace
+#define CLIST_TYPE int
+#define CLIST_BLOCK_SIZE 4
+#define CLIST_BLOCK_GROWTH_RATE 2
+#include "clist_type.h"
+
+#ifdef _CLIST_NDEBUG
+#	define NDEBUG 1
+#	undef _CLIST_NDEBUG
+#endif
+
+#define IS_ALIGNED(ptr, n) ((size_t) (ptr) % (n) == 0)
+
+void TEST_align_grow(void) {
+	clist_align L;
+	void *noise[64];
+	size_t n_noise = 0;
+	size_t i;
+
+	clist_align_init(&L);
+	assert(IS_ALIGNED(L.block, 64));
+
+	for (i = 0; i < 200000; i++) {
+		size_t before = L.capacity;
+
+		assert(clist_align_add(&L, (int) i) == i);
+
+		if (L.capacity != before) {
+			assert(IS_ALIGNED(L.block, 64));
+			assert(IS_ALIGNED(clist_align_data(&L), 64));
+
+			/* small allocations right behind the block, so realloc()
+			   has to move it now and then */
+			if (n_noise < 64) {
+				noise[n_noise++] = malloc(24);
+			}
+		}
+	}
+
+	for (i = 0; i < 200000; i++) {
+		assert(*clist_align_get(&L, i) == (int) i);
+	}
+
+	/* back onto the stack block */
+	assert(clist_align_resize(&L, 2) == 0);
+	assert(clist_align_shrink(&L) == 0);
+	assert(L.capacity == 4);
+	assert(IS_ALIGNED(L.block, 64));
+	assert(*clist_align_get(&L, 1) == 1);
+
+	clist_align_free(&L);
+
+	while (n_noise > 0) {
+		free(noise[--n_noise]);
+	}
+}
+
+void TEST_align_resize(void) {
+	clist_align L;
+	size_t i;
+
+	/* resize() zeroes new blocks without going through calloc() */
+	clist_align_init(&L);
+	assert(clist_align_resize(&L, 1000) == 0);
+	assert(IS_ALIGNED(L.block, 64));
+	for (i = 0; i < 1000; i++) {
+		assert(*clist_align_get(&L, i) == 0);
+	}
+
+	assert(clist_align_reserve(&L, 5000) == 0);
+	assert(IS_ALIGNED(L.block, 64));
+
+	clist_align_free(&L);
+}
+
+void TEST_align_embedded(void) {
+	struct {
+		char c;
+		clist_align L;
+	} s;
+
+	/* the stack block lines up wherever the list goes */
+	clist_align_init(&s.L);
+	assert(IS_ALIGNED(s.L.block, 64));
+	clist_align_add(&s.L, 1);
+	assert(IS_ALIGNED(clist_align_get(&s.L, 0), 64));
+	clist_align_free(&s.L);
+	(void) s.c;
+}
+
+void TEST_align_arena(void) {
+	clist_arena A;
+	clist_align_arena lists[8];
+	size_t i;
+	size_t j;
+
+	/* small chunks, so that lists keep moving between them */
+	clist_arena_init(&A, 1000);
+
+	for (i = 0; i < 8; i++) {
+		clist_align_arena_init_arena(&lists[i], &A);
+	}
+
+	/* interleaved, so only the most recent one can grow in place */
+	for (j = 0; j < 500; j++) {
+		for (i = 0; i < 8; i++) {
+			assert(clist_align_arena_add(&lists[i], (double) (i * 1000 + j)) == j);
+			assert(IS_ALIGNED(lists[i].block, 128));
+		}
+	}
+
+	for (i = 0; i < 8; i++) {
+		for (j = 0; j < 500; j++) {
+			assert(*clist_align_arena_get(&lists[i], j) == (double) (i * 1000 + j));
+		}
+	}
+
+	/* plain arena allocations still get CLIST_ARENA_ALIGNMENT */
+	assert(IS_ALIGNED(clist_arena_alloc(&A, 3), CLIST_ARENA_ALIGNMENT));
+	assert(IS_ALIGNED(clist_arena_alloc_aligned(&A, 3, 4096), 4096));
+
+	clist_arena_free(&A);
+}
+
+void TEST_align_safe_realloc(void) {
+	clist_align_safe L;
+	size_t i;
+
+	clist_align_safe_init(&L);
+
+	for (i = 0; i < 50000; i++) {
+		size_t before = L.capacity;
+		assert(clist_align_safe_add(&L, (short) i) == i);
+		if (L.capacity != before) {
+			assert(IS_ALIGNED(L.block, 32));
+		}
+	}
+
+	for (i = 0; i < 50000; i++) {
+		assert(*clist_align_safe_get(&L, i) == (short) i);
+	}
+
+	clist_align_safe_free(&L);
+}
+
+void TEST_align_hook_fail(void) {
+	clist_align_hook L;
+	void *block;
+	size_t capacity;
+	size_t i;
+
+	clist_align_hook_init(&L);
+	for (i = 0; i < 100; i++) {
+		assert(clist_align_hook_add(&L, (int) i) == i);
+	}
+
+	/* the re-aligning allocation fails: the list has to keep its old
+	   block, as it was */
+	block = L.block;
+	capacity = L.capacity;
+	hook_fail = 1;
+
+	for (; i < capacity; i++) {
+		assert(clist_align_hook_add(&L, (int) i) == i);
+	}
+
+	errno = 0;
+	assert(clist_align_hook_add(&L, -1) == CLIST_ERR);
+	assert(errno == ENOMEM);
+	assert(L.block == block);
+	assert(L.capacity == capacity);
+	assert(L.count == capacity);
+	assert(IS_ALIGNED(clist_align_hook_data(&L), 64));
+
+	for (i = 0; i < capacity; i++) {
+		assert(*clist_align_hook_get(&L, i) == (int) i);
+	}
+
+	hook_fail = 0;
+	for (i = capacity; i < 10000; i++) {
+		assert(clist_align_hook_add(&L, (int) i) == i);
+		assert(IS_ALIGNED(L.block, 64));
+	}
+
+	/* 64 is over what realloc() keeps, so it was never used */
+	assert(hook_reallocs == 0);
+
+	clist_align_hook_free(&L);
+}
+
+void TEST_align_in_place(void) {
+	clist_align_inplace L;
+	void *block;
+	size_t allocs;
+	size_t i;
+
+	clist_align_inplace_init(&L);
+	assert(clist_align_inplace_add(&L, 0) == 0);
+	for (i = 1; i < 8; i++) {
+		assert(clist_align_inplace_add(&L, (int) i) == i);
+	}
+
+	/* on the heap now; it grows in place for as long as it can */
+	block = L.block;
+	allocs = hook_allocs;
+	assert(allocs == 1);
+
+	for (; i < EXPAND_SLAB / sizeof(int); i++) {
+		assert(clist_align_inplace_add(&L, (int) i) == i);
+	}
+	assert(L.block == block);
+	assert(hook_allocs == allocs);
+	assert(hook_expands > 0);
+
+	/* and is moved once it can't */
+	assert(clist_align_inplace_add(&L, (int) i) == i);
+	assert(L.block != block);
+	assert(hook_allocs == allocs + 1);
+	assert(IS_ALIGNED(L.block, 64));
+
+	for (i = 0; i <= EXPAND_SLAB / sizeof(int); i++) {
+		assert(*clist_align_inplace_get(&L, i) == (int) i);
+	}
+
+	assert(hook_reallocs == 0);
+
+	clist_align_inplace_free(&L);
+}
@@ -0,0 +1,115 @@
+#ifdef NDEBUG
+	/* TODO better assert instead of std assert */
+#	undef NDEBUG
+#	define _CLIST_NDEBUG
+#endif
+
+#include <assert.h>
+#include <stddef.h>
+
+#define CLIST_ARENA
+#define CLIST_BLOCK_SIZE 16
+#define CLIST_NAME pooled
+#define CLIST_TYPE size_t
+#include "clist_type.h"
+
+#ifdef _CLIST_NDEBUG
+#	define NDEBUG 1
+#	undef _CLIST_NDEBUG
+#endif
+
+void TEST_arena_grow_in_place(void) {
+	size_t i;
+	size_t *block;
+	clist_arena A;
+	clist_pooled L;
+
+	clist_arena_init(&A, 1024 * 1024);
+	clist_pooled_init_arena(&L, &A);
+
+	for (i = 0; i < 100; i++) {
+		assert(clist_pooled_add(&L, i) == i);
+	}
+
+	/* the list is the last allocation, so it keeps its address */
+	block = clist_pooled_get(&L, 0);
+	for (i = 100; i < 10000; i++) {
+		assert(clist_pooled_add(&L, i) == i);
+	}
+	assert(clist_pooled_get(&L, 0) == block);
+
+	for (i = 0; i < 10000; i++) {
+		assert(*clist_pooled_get(&L, i) == i);
+	}
+
+	clist_pooled_free(&L);
+	clist_arena_free(&A);
+}
+
+void TEST_arena_many_lists(void) {
+	size_t i;
+	size_t j;
+	size_t round;
+	clist_arena A;
+	clist_pooled lists[20];
+
+	/* small chunks so that new ones get chained in */
+	clist_arena_init(&A, 4096);
+
+	for (round = 0; round < 3; round++) {
+		for (i = 0; i < 20; i++) {
+			clist_pooled_init_arena(&lists[i], &A);
+		}
+
+		/* interleaved, so only some growth can happen in place */
+		for (j = 0; j < 500; j++) {
+			for (i = 0; i < 20; i++) {
+				assert(clist_pooled_add(&lists[i], i * 1000 + j + round) == j);
+			}
+		}
+
+		for (i = 0; i < 20; i++) {
+			assert(clist_pooled_count(&lists[i]) == 500);
+			for (j = 0; j < 500; j++) {
+				assert(*clist_pooled_get(&lists[i], j) == i * 1000 + j + round);
+			}
+		}
+
+		/* no need to free the lists */
+		clist_arena_reset(&A);
+	}
+
+	clist_arena_free(&A);
+}
+
+void TEST_arena_mixed(void) {
+	size_t i;
+	clist_arena A;
+	clist_pooled heap;
+	clist_pooled pooled;
+
+	clist_arena_init(&A, 4096);
+	clist_pooled_init(&heap);
+	clist_pooled_init_arena(&pooled, &A);
+
+	for (i = 0; i < 5000; i++) {
+		assert(clist_pooled_add(&heap, i) == i);
+		assert(clist_pooled_add(&pooled, i * 2) == i);
+	}
+
+	assert(clist_pooled_resize(&pooled, 20000) == 0);
+	assert(*clist_pooled_get(&pooled, 4999) == 9998);
+	assert(*clist_pooled_get(&pooled, 19999) == 0);
+
+	assert(clist_pooled_resize(&pooled, 10) == 0);
+	assert(clist_pooled_shrink(&pooled) == 0);
+	assert(*clist_pooled_get(&pooled, 9) == 18);
+
+	for (i = 0; i < 5000; i++) {
+		assert(*clist_pooled_get(&heap, i) == i);
+	}
+
+	clist_pooled_free(&heap);
+	clist_pooled_free(&pooled);
+	clist_arena_free(&A);
+}
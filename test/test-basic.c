@@ -84,3 +84,291 @@ void TEST_add_many(void) {
 
 	clist_free(&L);
 }
+
+void TEST_add_n(void) {
+	size_t i;
+	void *vals[2000];
+	clist L;
+
+	for (i = 0; i < 2000; i++) {
+		vals[i] = (void *) (i + 1);
+	}
+
+	clist_init(&L);
+
+	assert(clist_add_n(&L, vals, 0) == 0);
+	assert(clist_empty(&L));
+
+	assert(clist_add_n(&L, vals, 3) == 0);
+	assert(clist_count(&L) == 3);
+	assert(clist_add(&L, (void *) 42) == 3);
+
+	/* crosses the stack block and several growth steps at once */
+	assert(clist_add_n(&L, vals, 2000) == 4);
+	assert(clist_count(&L) == 2004);
+
+	assert(*clist_get(&L, 0) == (void *) 1);
+	assert(*clist_get(&L, 2) == (void *) 3);
+	assert(*clist_get(&L, 3) == (void *) 42);
+	for (i = 0; i < 2000; i++) {
+		assert(*clist_get(&L, i + 4) == (void *) (i + 1));
+	}
+
+	assert(clist_add(&L, (void *) 43) == 2004);
+	assert(*clist_get(&L, 2004) == (void *) 43);
+
+	clist_free(&L);
+}
+
+void TEST_reserve(void) {
+	size_t i;
+	clist L;
+
+	clist_init(&L);
+
+	assert(clist_reserve(&L, 10) == 0);
+	assert(clist_count(&L) == 0);
+	assert(clist_capacity(&L) >= 10);
+
+	assert(clist_reserve(&L, 5000) == 0);
+	assert(clist_count(&L) == 0);
+	assert(clist_capacity(&L) >= 5000);
+	assert(clist_capacity(&L) < 5000 + 1024);
+
+	for (i = 0; i < 5000; i++) {
+		assert(clist_add(&L, (void *) i) == i);
+	}
+	assert(clist_capacity(&L) < 5000 + 1024);
+
+	for (i = 0; i < 5000; i++) {
+		assert(*clist_get(&L, i) == (void *) i);
+	}
+
+	clist_free(&L);
+}
+
+void TEST_resize(void) {
+	size_t i;
+	clist L;
+
+	clist_init(&L);
+
+	assert(clist_resize(&L, 4) == 0);
+	assert(clist_count(&L) == 4);
+	for (i = 0; i < 4; i++) {
+		assert(*clist_get(&L, i) == NULL);
+	}
+
+	*clist_get(&L, 3) = (void *) 3;
+
+	/* off the stack block and onto a zeroed heap block */
+	assert(clist_resize(&L, 100000) == 0);
+	assert(clist_count(&L) == 100000);
+	assert(*clist_get(&L, 3) == (void *) 3);
+	for (i = 4; i < 100000; i++) {
+		assert(*clist_get(&L, i) == NULL);
+	}
+
+	assert(clist_resize(&L, 10) == 0);
+	assert(clist_count(&L) == 10);
+	assert(clist_add(&L, (void *) 42) == 10);
+
+	/* the stale elements must be zeroed again */
+	assert(clist_resize(&L, 200000) == 0);
+	assert(*clist_get(&L, 3) == (void *) 3);
+	assert(*clist_get(&L, 10) == (void *) 42);
+	for (i = 11; i < 200000; i++) {
+		assert(*clist_get(&L, i) == NULL);
+	}
+
+	clist_free(&L);
+}
+
+void TEST_shrink(void) {
+	size_t i;
+	clist L;
+
+	clist_init(&L);
+
+	for (i = 0; i < 100000; i++) {
+		assert(clist_add(&L, (void *) i) == i);
+	}
+
+	assert(clist_capacity(&L) > 100000 + 1024);
+	assert(clist_shrink(&L) == 0);
+	assert(clist_capacity(&L) >= 100000);
+	assert(clist_capacity(&L) < 100000 + 1024);
+
+	for (i = 0; i < 100000; i++) {
+		assert(*clist_get(&L, i) == (void *) i);
+	}
+
+	/* back onto the stack */
+	assert(clist_resize(&L, 3) == 0);
+	assert(clist_shrink(&L) == 0);
+	assert(clist_count(&L) == 3);
+	assert(*clist_get(&L, 0) == (void *) 0);
+	assert(*clist_get(&L, 2) == (void *) 2);
+
+	/* and off it again */
+	for (i = 3; i < 2000; i++) {
+		assert(clist_add(&L, (void *) i) == i);
+	}
+	for (i = 0; i < 2000; i++) {
+		assert(*clist_get(&L, i) == (void *) i);
+	}
+
+	clist_free(&L);
+}
+
+void TEST_insert(void) {
+	size_t i;
+	clist L;
+
+	clist_init(&L);
+
+	assert(clist_insert(&L, 0, (void *) 2) == 0);
+	assert(clist_insert(&L, 0, (void *) 0) == 0);
+	assert(clist_insert(&L, 1, (void *) 1) == 1);
+	assert(clist_insert(&L, 3, (void *) 3) == 3);
+
+	assert(clist_count(&L) == 4);
+	for (i = 0; i < 4; i++) {
+		assert(*clist_get(&L, i) == (void *) i);
+	}
+
+	/* grow through insertions at the front */
+	for (i = 0; i < 2000; i++) {
+		assert(clist_insert(&L, 0, (void *) 42) == 0);
+	}
+
+	assert(clist_count(&L) == 2004);
+	assert(*clist_get(&L, 0) == (void *) 42);
+	assert(*clist_get(&L, 1999) == (void *) 42);
+	for (i = 0; i < 4; i++) {
+		assert(*clist_get(&L, 2000 + i) == (void *) i);
+	}
+
+	clist_free(&L);
+}
+
+void TEST_pop(void) {
+	size_t i;
+	clist L;
+
+	clist_init(&L);
+
+	for (i = 0; i < 1000; i++) {
+		assert(clist_add(&L, (void *) i) == i);
+	}
+
+	for (i = 1000; i > 0; i--) {
+		assert(clist_pop(&L) == (void *) (i - 1));
+		assert(clist_count(&L) == i - 1);
+	}
+
+	assert(clist_empty(&L));
+	assert(clist_add(&L, (void *) 42) == 0);
+
+	clist_free(&L);
+}
+
+#ifndef NDEBUG
+void TEST_FAIL_pop_on_empty_list(void) {
+	clist L;
+	clist_init(&L);
+	clist_pop(&L);
+}
+#endif
+
+void TEST_remove(void) {
+	size_t i;
+	clist L;
+
+	clist_init(&L);
+
+	for (i = 0; i < 10; i++) {
+		assert(clist_add(&L, (void *) i) == i);
+	}
+
+	clist_remove(&L, 9);
+	clist_remove(&L, 0);
+	clist_remove(&L, 4);
+
+	assert(clist_count(&L) == 7);
+	assert(*clist_get(&L, 0) == (void *) 1);
+	assert(*clist_get(&L, 1) == (void *) 2);
+	assert(*clist_get(&L, 2) == (void *) 3);
+	assert(*clist_get(&L, 3) == (void *) 4);
+	assert(*clist_get(&L, 4) == (void *) 6);
+	assert(*clist_get(&L, 5) == (void *) 7);
+	assert(*clist_get(&L, 6) == (void *) 8);
+
+	clist_free(&L);
+}
+
+void TEST_swap_remove(void) {
+	size_t i;
+	clist L;
+
+	clist_init(&L);
+
+	for (i = 0; i < 5; i++) {
+		assert(clist_add(&L, (void *) i) == i);
+	}
+
+	clist_swap_remove(&L, 1);
+	assert(clist_count(&L) == 4);
+	assert(*clist_get(&L, 0) == (void *) 0);
+	assert(*clist_get(&L, 1) == (void *) 4);
+	assert(*clist_get(&L, 2) == (void *) 2);
+	assert(*clist_get(&L, 3) == (void *) 3);
+
+	clist_swap_remove(&L, 3);
+	assert(clist_count(&L) == 3);
+	assert(*clist_get(&L, 2) == (void *) 2);
+
+	clist_free(&L);
+}
+
+void TEST_clear(void) {
+	size_t i;
+	size_t capacity;
+	clist L;
+
+	clist_init(&L);
+
+	for (i = 0; i < 5000; i++) {
+		assert(clist_add(&L, (void *) i) == i);
+	}
+
+	capacity = clist_capacity(&L);
+	clist_clear(&L);
+	assert(clist_empty(&L));
+	assert(clist_capacity(&L) == capacity);
+
+	assert(clist_add(&L, (void *) 42) == 0);
+	assert(*clist_get(&L, 0) == (void *) 42);
+
+	clist_free(&L);
+}
+
+void TEST_data(void) {
+	clist L;
+	size_t i;
+	void **data;
+
+	clist_init(&L);
+
+	for (i = 0; i < 1000; i++) {
+		clist_add(&L, (void *) i);
+	}
+
+	data = clist_data(&L);
+	for (i = 0; i < 1000; i++) {
+		assert(data[i] == (void *) i);
+		assert(&data[i] == clist_get(&L, i));
+	}
+
+	clist_free(&L);
+}
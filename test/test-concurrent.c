@@ -0,0 +1,166 @@
+#ifdef NDEBUG
+	/* TODO better assert instead of std assert */
+#	undef NDEBUG
+#	define _CLIST_NDEBUG
+#endif
+
+#include <assert.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+#define CLIST_CONCURRENT
+#define CLIST_NAME conc
+#define CLIST_TYPE size_t
+#define CLIST_BLOCK_SIZE 4
+#include "clist_type.h"
+
+#ifdef _CLIST_NDEBUG
+#	define NDEBUG 1
+#	undef _CLIST_NDEBUG
+#endif
+
+#define N_PRODUCERS 4
+#define N_PER_PRODUCER 50000
+#define N_TOTAL (N_PRODUCERS * N_PER_PRODUCER)
+
+/* values are producer * N_PER_PRODUCER + sequence */
+struct producer {
+	clist_conc_conc *list;
+	size_t id;
+};
+
+static void *produce(void *arg) {
+	struct producer *p = (struct producer *) arg;
+	size_t i;
+
+	for (i = 0; i < N_PER_PRODUCER; i++) {
+		assert(clist_conc_conc_add(p->list, p->id * N_PER_PRODUCER + i) != CLIST_ERR);
+	}
+
+	return NULL;
+}
+
+static void *consume(void *arg) {
+	clist_conc_conc *list = (clist_conc_conc *) arg;
+	size_t seen = 0;
+
+	while (seen < N_TOTAL) {
+		size_t count = clist_conc_conc_count(list);
+
+		/* never goes backwards */
+		assert(count >= seen);
+
+		/* everything below the count can be read */
+		for (; seen < count; seen++) {
+			size_t *val = clist_conc_conc_get(list, seen);
+			assert(val != NULL);
+			assert(*val < N_TOTAL);
+		}
+	}
+
+	return NULL;
+}
+
+void TEST_concurrent_single(void) {
+	clist_conc_conc L;
+	size_t i;
+
+	clist_conc_conc_init(&L);
+	assert(clist_conc_conc_count(&L) == 0);
+	assert(clist_conc_conc_get(&L, 0) == NULL);
+
+	/* 4, 8, 16, ... - crosses a bucket boundary every so often */
+	for (i = 0; i < 1000; i++) {
+		assert(clist_conc_conc_add(&L, i * 3) == i);
+		assert(clist_conc_conc_count(&L) == i + 1);
+		assert(clist_conc_conc_get(&L, i + 1) == NULL);
+	}
+
+	for (i = 0; i < 1000; i++) {
+		assert(*clist_conc_conc_get(&L, i) == i * 3);
+	}
+
+	/* elements never move */
+	{
+		size_t *first = clist_conc_conc_get(&L, 0);
+		size_t *last = clist_conc_conc_get(&L, 999);
+
+		for (i = 0; i < 10000; i++) {
+			clist_conc_conc_add(&L, i);
+		}
+
+		assert(first == clist_conc_conc_get(&L, 0));
+		assert(last == clist_conc_conc_get(&L, 999));
+	}
+
+	clist_conc_conc_free(&L);
+}
+
+void TEST_concurrent_locate(void) {
+	size_t i;
+	size_t bucket = 0;
+	size_t offset = 0;
+
+	/* walks the buckets one index at a time */
+	for (i = 0; i < 4000; i++) {
+		size_t b;
+		size_t o;
+
+		b = clist__conc_locate(i, 4, &o);
+		assert(b == bucket && o == offset);
+
+		if (++offset == ((size_t) 4 << bucket)) {
+			++bucket;
+			offset = 0;
+		}
+	}
+}
+
+void TEST_concurrent_producers(void) {
+	clist_conc_conc L;
+	pthread_t producers[N_PRODUCERS];
+	pthread_t consumer;
+	struct producer args[N_PRODUCERS];
+	size_t next[N_PRODUCERS];
+	unsigned char *seen;
+	size_t i;
+
+	clist_conc_conc_init(&L);
+
+	assert(pthread_create(&consumer, NULL, &consume, &L) == 0);
+	for (i = 0; i < N_PRODUCERS; i++) {
+		args[i].list = &L;
+		args[i].id = i;
+		assert(pthread_create(&producers[i], NULL, &produce, &args[i]) == 0);
+	}
+
+	for (i = 0; i < N_PRODUCERS; i++) {
+		assert(pthread_join(producers[i], NULL) == 0);
+	}
+	assert(pthread_join(consumer, NULL) == 0);
+
+	assert(clist_conc_conc_count(&L) == N_TOTAL);
+	assert(clist_conc_conc_get(&L, N_TOTAL) == NULL);
+
+	/* every value exactly once, and each producer's in the order it added them */
+	seen = (unsigned char *) calloc(N_TOTAL, 1);
+	assert(seen != NULL);
+	for (i = 0; i < N_PRODUCERS; i++) {
+		next[i] = 0;
+	}
+
+	for (i = 0; i < N_TOTAL; i++) {
+		size_t val = *clist_conc_conc_get(&L, i);
+		size_t producer = val / N_PER_PRODUCER;
+
+		assert(!seen[val]);
+		seen[val] = 1;
+
+		assert(val % N_PER_PRODUCER == next[producer]);
+		++next[producer];
+	}
+
+	free(seen);
+	clist_conc_conc_free(&L);
+}
@@ -1,9 +1,13 @@
+#include <algorithm>
 #include <cassert>
+#include <cstdio>
+#include <string>
 
 #include <memswap.h>
 
 struct foo {
 	static int allocated;
+	static int moved;
 
 	bool armed = false;
 
@@ -11,13 +15,25 @@ struct foo {
 		++allocated;
 	}
 
+	explicit foo(bool armed_) : armed(armed_) {
+		if (armed) ++foo::allocated;
+	}
+
 	foo(const foo &other) : armed(other.armed) {
 		if (armed) ++foo::allocated;
 	}
 
 	foo(foo &&other) : armed(other.armed) {
-		// nothing should be moved
-		assert(false && "move constructor called");
+		other.armed = false;
+		++foo::moved;
+	}
+
+	foo &operator=(foo &&other) {
+		if (armed) --foo::allocated;
+		armed = other.armed;
+		other.armed = false;
+		++foo::moved;
+		return *this;
 	}
 
 	~foo() {
@@ -28,14 +44,470 @@ struct foo {
 };
 
 int foo::allocated = 0;
+int foo::moved = 0;
 
 #define CLIST_TYPE foo
 #define CLIST_NAME foo
 #define CLIST_MEMSWAP memswap
 #define CLIST_BLOCK_SIZE 2
 #define CLIST_BLOCK_GROWTH_RATE 2
+#define CLIST_CONCURRENT
+#define CLIST_SEGMENTED
+#include "../include/clist_type.h"
+
+#define CLIST_TYPE double
+#define CLIST_NAME dbl
+#define CLIST_PARALLEL
+#define CLIST_SWMR
+#define CLIST_PERSIST
+#define CLIST_SPILL
+#define CLIST_SHM
+#define CLIST_ALIGNMENT 64
+#define CLIST_BLOCK_SIZE 16
+#include "../include/clist_type.h"
+
+struct vec3 {
+	float x;
+	float y;
+	float z;
+};
+
+#define CLIST_TYPE vec3
+#define CLIST_NAME vec3
+#define CLIST_FIELDS(X) X(float, x) X(float, y) X(float, z)
 #include "../include/clist_type.h"
 
+#define CLIST_TYPE std::string
+#define CLIST_NAME str
+#define CLIST_MEMSWAP memswap
+#define CLIST_INLINE_CAPACITY 2
+#define CLIST_BLOCK_SIZE 4
+#define CLIST_CMP(a, b) (a).compare(b)
+#define CLIST_SHARDED
+#define CLIST_RING
+#define CLIST_STATS
+#include "../include/clist_type.h"
+
+static void test_strings() {
+	static const char *const long_str = "long enough to not fit in any small string buffer";
+	clist::str a;
+	clist::str b;
+
+	a.emplace("a");
+	a.emplace(long_str);
+	assert(a.capacity() == 2);
+
+	// std::string is not trivially copyable - the short one keeps
+	// a pointer into itself, so it has to be moved properly
+	a.add(std::string("c"));
+	a.insert(0, a[2]);
+	assert(a.count() == 4);
+	assert(a[0] == "c" && a[1] == "a" && a[2] == long_str && a[3] == "c");
+
+	a.remove(1);
+	a.swap_remove(0);
+	assert(a.count() == 2);
+	assert(a[0] == "c" && a[1] == long_str);
+
+	a.shrink();
+	assert(a.capacity() == 2);
+	assert(a[0] == "c" && a[1] == long_str);
+
+	b.emplace(3, 'x');
+	a.swap(b);
+	assert(a.count() == 1 && a[0] == "xxx");
+	assert(b.count() == 2 && b[0] == "c" && b[1] == long_str);
+
+	for (int i = 0; i < 10; i++) {
+		a.emplace(a[0]);
+	}
+	b.swap(a);
+	assert(b.count() == 11 && b[10] == "xxx");
+	assert(a.count() == 2 && a[0] == "c" && a[1] == long_str);
+
+	{
+		clist::str c(std::move(a));
+		assert(a.empty());
+		assert(c.count() == 2 && c[0] == "c" && c[1] == long_str);
+
+		a = std::move(b);
+		assert(b.empty());
+		assert(a.count() == 11 && a[0] == "xxx");
+
+		b = std::move(c);
+		assert(c.empty());
+		assert(b.count() == 2 && b[0] == "c" && b[1] == long_str);
+
+		std::string popped = b.pop();
+		assert(popped == long_str);
+		assert(b.count() == 1);
+	}
+
+	{
+		clist::str c;
+		c.emplace("b");
+		c.emplace("d");
+		c.emplace("a");
+		c.emplace("c");
+
+		std::sort(c.begin(), c.end());
+		assert(std::is_sorted(c.cbegin(), c.cend()));
+		assert(std::find(c.begin(), c.end(), "c") - c.begin() == 2);
+		assert(c.data() == &c[0]);
+
+		std::string joined;
+		for (const std::string &s : c) {
+			joined += s;
+		}
+		assert(joined == "abcd");
+
+		clist::str::const_iterator first = c.cbegin();
+		assert(c.cend() - first == 4);
+		(void) first;
+	}
+
+	{
+		clist::str c;
+		for (int i = 0; i < 100; i++) {
+			// half of them long enough to live on the heap
+			c.add(std::to_string(i * 7919 % 100) + (i % 2 ? "" : long_str));
+		}
+
+		c.sort();
+		assert(std::is_sorted(c.cbegin(), c.cend()));
+		assert(c.count() == 100);
+
+		size_t idx = c.bsearch(std::string("42") + long_str);
+		assert(idx != CLIST_ERR && c[idx] == std::string("42") + long_str);
+		assert(c.bsearch("42") == CLIST_ERR);
+		assert(c.lower_bound("") == 0);
+		(void) idx;
+	}
+}
+
+static void test_parallel() {
+	clist::dbl a;
+
+	for (int i = 0; i < 10000; i++) {
+		a.add(i);
+	}
+
+	for (size_t n_threads = 1; n_threads <= 4; n_threads++) {
+		clist_parallel_threads(n_threads);
+
+		double factor = 0.5;
+		a.parallel_for([factor](double &val) { val *= factor; });
+		a.parallel_for([](double &val) { val *= 2; });
+
+		double sum = a.parallel_reduce(0.0,
+			[](double acc, double val) { return acc + val; },
+			[](double acc, double partial) { return acc + partial; });
+		assert(sum == 10000.0 * 9999 / 2);
+		(void) sum;
+
+		size_t largest = a.parallel_reduce(size_t(0),
+			[](size_t acc, double val) { return std::max(acc, size_t(val)); },
+			[](size_t acc, size_t partial) { return std::max(acc, partial); });
+		assert(largest == 9999);
+		(void) largest;
+	}
+
+	for (size_t i = 0; i < a.count(); i++) {
+		assert(a[i] == double(i));
+	}
+}
+
+static void test_sharded() {
+	static const char *const long_str = "long enough to not fit in any small string buffer";
+	clist_str_sharded builder;
+	clist_str all;
+
+	clist_str_init(&all);
+	clist_str_add(&all, "first");
+
+	int res = clist_str_sharded_init(&builder, 3);
+	assert(res == 0);
+	clist_str_add(clist_str_sharded_shard(&builder, 0), "a");
+	clist_str_add(clist_str_sharded_shard(&builder, 2), "b");
+	clist_str_add(clist_str_sharded_shard(&builder, 2), long_str);
+
+	// moved over one by one, since std::string isn't relocatable
+	res = clist_str_sharded_merge(&builder, &all);
+	assert(res == 0);
+	(void) res;
+	assert(clist_str_count(&all) == 4);
+	assert(clist_str_get(&all, 0) == "first");
+	assert(clist_str_get(&all, 1) == "a");
+	assert(clist_str_get(&all, 2) == "b");
+	assert(clist_str_get(&all, 3) == long_str);
+	assert(clist_str_sharded_count(&builder) == 0);
+
+	// whatever is left in the shards is destroyed with them
+	clist_str_add(clist_str_sharded_shard(&builder, 1), long_str);
+	clist_str_sharded_free(&builder);
+
+	clist_str_clear(&all);
+	clist_str_free(&all);
+}
+
+static void test_ring() {
+	static const char *const long_str = "long enough to not fit in any small string buffer";
+	clist_str_ring ring;
+	std::string in[3] = { "a", long_str, "c" };
+	std::string out[3];
+
+	int res = clist_str_ring_init(&ring, 2);
+	assert(res == 0);
+	(void) res;
+
+	// copied in, moved out
+	for (int round = 0; round < 3; round++) {
+		size_t n = clist_str_ring_push_n(&ring, in, 3);
+		assert(n == 2);
+		n = clist_str_ring_pop_n(&ring, out, 3);
+		assert(n == 2);
+		(void) n;
+		assert(out[0] == "a");
+		assert(out[1] == long_str);
+		assert(in[1] == long_str);
+	}
+
+	// left over elements are destroyed with the ring
+	bool pushed = clist_str_ring_push(&ring, in[1]);
+	assert(pushed);
+	(void) pushed;
+	clist_str_ring_free(&ring);
+}
+
+static void test_swmr() {
+	clist_epoch epoch;
+	clist_dbl_swmr list;
+
+	clist_epoch_init(&epoch);
+	clist_dbl_swmr_init(&list, &epoch);
+
+	for (int i = 0; i < 100; i++) {
+		size_t idx = clist_dbl_swmr_add(&list, i * 0.5);
+		assert(idx == size_t(i));
+		(void) idx;
+	}
+
+	clist_epoch_reader *reader = clist_epoch_register(&epoch);
+	assert(reader != nullptr);
+	clist_epoch_enter(reader);
+	assert(clist_dbl_swmr_count(&list) == 100);
+	assert(*clist_dbl_swmr_get(&list, 99) == 49.5);
+	clist_epoch_leave(reader);
+	clist_epoch_unregister(reader);
+
+	clist_dbl_swmr_free(&list);
+}
+
+static void test_persist() {
+	static const char *const path = "/tmp/clist-test-persist-cpp.bin";
+	clist::dbl a;
+	clist::dbl b;
+
+	for (int i = 0; i < 1000; i++) {
+		a.add(i / 8.0);
+	}
+
+	int res = a.save(path);
+	assert(res == 0);
+	res = b.load(path);
+	assert(res == 0);
+	(void) res;
+
+	assert(b.count() == 1000);
+	for (size_t i = 0; i < 1000; i++) {
+		assert(a[i] == b[i]);
+	}
+
+	clist_dbl_mapped mapped;
+	res = clist_dbl_map(&mapped, path, CLIST_MAP_VERIFY);
+	assert(res == 0);
+	assert(clist_dbl_count(&mapped.list) == 1000);
+	assert(clist_dbl_get(&mapped.list, 999) == 999 / 8.0);
+	clist_dbl_unmap(&mapped);
+
+	std::remove(path);
+}
+
+static void test_spill() {
+	clist_dbl_spill s;
+	int res = clist_dbl_spill_init(&s, NULL, 0);
+	assert(res == 0);
+	(void) res;
+
+	/* enough to put most of it on disk */
+	size_t n = s.block_elems * (CLIST_SPILL_HOT_BLOCKS + CLIST_SPILL_CACHE_BLOCKS) * 2;
+	for (size_t i = 0; i < n; i++) {
+		size_t idx = clist_dbl_spill_add(&s, i / 4.0);
+		assert(idx == i);
+		(void) idx;
+	}
+
+	double *elems;
+	size_t seen = 0;
+	for (size_t got; (got = clist_dbl_spill_scan(&s, seen, &elems)) != 0; seen += got) {
+		assert(got != CLIST_ERR);
+		assert(elems[0] == seen / 4.0);
+	}
+	assert(seen == n);
+
+	assert(*clist_dbl_spill_get(&s, 3) == 3 / 4.0);
+	assert(*clist_dbl_spill_get(&s, n - 1) == (n - 1) / 4.0);
+
+	clist_dbl_spill_free(&s);
+}
+
+static void test_shm() {
+	static const char *const name = "/clist-test-shm-cpp";
+	clist_dbl_shm w;
+	clist_dbl_shm r;
+
+	shm_unlink(name);
+	int res = clist_dbl_shm_create(&w, name, 0);
+	assert(res == 0);
+	res = clist_dbl_shm_attach(&r, name);
+	assert(res == 0);
+	(void) res;
+
+	for (size_t i = 0; i < 10000; i++) {
+		size_t idx = clist_dbl_shm_add(&w, i / 2.0);
+		assert(idx == i);
+		(void) idx;
+	}
+
+	assert(clist_dbl_shm_count(&r) == 10000);
+	assert(*clist_dbl_shm_get(&r, 9999) == 9999 / 2.0);
+
+	clist_dbl view;
+	clist_dbl_shm_view(&r, &view);
+	assert(clist_dbl_count(&view) == 10000);
+	assert(clist_dbl_get(&view, 10) == 5.0);
+
+	clist_dbl_shm_detach(&r);
+	clist_dbl_shm_detach(&w);
+	shm_unlink(name);
+}
+
+static void test_soa() {
+	clist_vec3_soa s;
+	clist_vec3_soa_init(&s);
+
+	for (int i = 0; i < 1000; i++) {
+		size_t idx = clist_vec3_soa_add(&s, vec3{(float) i, (float) i * 2, (float) i * 3});
+		assert(idx == (size_t) i);
+		(void) idx;
+	}
+
+	const float *ys = clist_vec3_soa_col_y(&s);
+	float sum = 0;
+	for (size_t i = 0; i < clist_vec3_soa_count(&s); i++) {
+		sum += ys[i];
+	}
+	assert(sum == 999.0f * 1000.0f);
+
+	vec3 v = clist_vec3_soa_get(&s, 10);
+	assert(v.x == 10 && v.y == 20 && v.z == 30);
+	(void) v;
+	(void) sum;
+
+	clist_vec3_soa_free(&s);
+}
+
+static void test_stats() {
+	clist_stats before;
+	clist_str_stats_type(&before);
+
+	{
+		clist::str a;
+		for (int i = 0; i < 100; i++) {
+			a.add(std::to_string(i));
+		}
+
+		clist_stats st;
+		a.stats(&st);
+		assert(st.adds == 100);
+		assert(st.promotions == 1);
+		assert(st.expansions > 1);
+
+		/* strings are moved one by one, never realloc()'d */
+		assert(st.bytes_copied >= (st.expansions - 1) * 2 * sizeof(std::string));
+		(void) st;
+	}
+
+	clist_stats st;
+	clist_str_stats_type(&st);
+	assert(st.lists == before.lists + 1);
+	assert(st.adds == before.adds + 100);
+	(void) st;
+}
+
+static void test_alignment() {
+	static_assert(alignof(clist_dbl) == 64, "the stack block is aligned");
+
+	clist::dbl d;
+	assert((size_t) d.data() % 64 == 0);
+
+	for (int i = 0; i < 100000; i++) {
+		size_t before = d.capacity();
+		d.add((double) i);
+		if (d.capacity() != before) {
+			assert((size_t) d.data() % 64 == 0);
+		}
+	}
+
+	assert(d.get(99999) == 99999.0);
+}
+
+static void test_concurrent() {
+	clist_foo_conc c;
+	clist_foo_conc_init(&c);
+
+	{
+		foo f;
+		for (size_t i = 0; i < 20; i++) {
+			size_t idx = clist_foo_conc_add(&c, f);
+			assert(idx == i);
+			(void) idx;
+		}
+	}
+
+	/* copied in place */
+	assert(foo::allocated == 20);
+	assert(clist_foo_conc_count(&c) == 20);
+	assert(clist_foo_conc_get(&c, 19)->armed);
+
+	clist_foo_conc_free(&c);
+	assert(foo::allocated == 0);
+}
+
+static void test_segmented() {
+	clist_foo_seg S;
+	clist_foo_seg_init(&S);
+
+	for (size_t i = 0; i < 5; i++) {
+		clist_foo_seg_add(&S, foo());
+	}
+	assert(foo::allocated == 5);
+
+	/* moved out, not copied */
+	foo::moved = 0;
+	{
+		foo f = clist_foo_seg_pop(&S);
+		assert(f.armed);
+		assert(foo::moved >= 1);
+		assert(foo::allocated == 5);
+	}
+	assert(foo::allocated == 4);
+
+	/* what's left is destroyed along with the list */
+	clist_foo_seg_free(&S);
+	assert(foo::allocated == 0);
+}
+
 int main() {
 	assert(foo::allocated == 0);
 
@@ -74,6 +546,63 @@ int main() {
 			assert(foo::allocated == 9);
 			foo_c.add(foo());
 			assert(foo::allocated == 10);
+
+			foo_c.resize(2);
+			assert(foo_c.count() == 2);
+			assert(foo::allocated == 6);
+
+			foo_c.resize(7);
+			assert(foo_c.count() == 7);
+			assert(foo::allocated == 11);
+
+			foo_c.shrink();
+			assert(foo_c.count() == 7);
+			assert(foo::allocated == 11);
+
+			foo_c.remove(0);
+			assert(foo_c.count() == 6);
+			assert(foo::allocated == 10);
+
+			foo_c.swap_remove(0);
+			assert(foo_c.count() == 5);
+			assert(foo::allocated == 9);
+
+			foo_c.insert(2, foo_c[0]);
+			assert(foo_c.count() == 6);
+			assert(foo::allocated == 10);
+
+			foo_c.pop();
+			assert(foo_c.count() == 5);
+			assert(foo::allocated == 9);
+
+			foo_c.clear();
+			assert(foo_c.empty());
+			assert(foo::allocated == 4);
+
+			// constructed in place - nothing is moved while there's room
+			foo_c.reserve(4);
+			foo::moved = 0;
+			foo_c.emplace(true);
+			foo_c.emplace(false);
+			assert(foo::moved == 0);
+			assert(foo::allocated == 5);
+
+			foo_c.add(foo());
+			assert(foo::moved == 1);
+			assert(foo::allocated == 6);
+
+			{
+				clist::foo foo_d(std::move(foo_c));
+				assert(foo_c.empty());
+				assert(foo_d.count() == 3);
+				assert(foo::allocated == 6);
+
+				foo_c = std::move(foo_d);
+				assert(foo_d.empty());
+				assert(foo_c.count() == 3);
+			}
+
+			assert(foo::allocated == 6);
 		}
 
 		assert(foo::allocated == 4);
@@ -81,5 +610,19 @@ int main() {
 
 	assert(foo::allocated == 0);
 
+	test_strings();
+	test_parallel();
+	test_concurrent();
+	test_segmented();
+	test_sharded();
+	test_ring();
+	test_swmr();
+	test_persist();
+	test_spill();
+	test_shm();
+	test_soa();
+	test_stats();
+	test_alignment();
+
 	return 0;
 }
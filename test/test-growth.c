@@ -0,0 +1,157 @@
+#ifdef NDEBUG
+	/* TODO better assert instead of std assert */
+#	undef NDEBUG
+#	define _CLIST_NDEBUG
+#endif
+
+#include <assert.h>
+#include <errno.h>
+#include <stddef.h>
+
+#define CLIST_GROWTH
+#define CLIST_NAME policy
+#define CLIST_TYPE int
+#define CLIST_BLOCK_SIZE 16
+#define CLIST_INLINE_CAPACITY 0
+#include "clist_type.h"
+
+#ifdef _CLIST_NDEBUG
+#	define NDEBUG 1
+#	undef _CLIST_NDEBUG
+#endif
+
+/* adds elements one by one, recording every capacity the list goes through */
+static size_t fill(clist_policy *L, size_t n, size_t *capacities, size_t max_capacities) {
+	size_t n_capacities = 0;
+	size_t i;
+
+	for (i = 0; i < n; i++) {
+		size_t before = L->capacity;
+		assert(clist_policy_add(L, (int) i) == i);
+		if (L->capacity != before && n_capacities < max_capacities) {
+			capacities[n_capacities++] = L->capacity;
+		}
+	}
+
+	return n_capacities;
+}
+
+void TEST_growth_default(void) {
+	clist_policy L;
+	size_t caps[16];
+
+	clist_policy_init(&L);
+	assert(L.growth == NULL);
+
+	/* CLIST_BLOCK_GROWTH_RATE */
+	assert(fill(&L, 1000, caps, 16) == 4);
+	assert(caps[0] == 16 && caps[1] == 64 && caps[2] == 256 && caps[3] == 1024);
+
+	clist_policy_free(&L);
+}
+
+void TEST_growth_geometric(void) {
+	static const clist_growth twice = CLIST_GROWTH_GEOMETRIC_INIT(2, 1);
+	clist_growth half = clist_growth_geometric(3, 2);
+	clist_policy L;
+	size_t caps[32];
+	size_t n;
+	size_t i;
+
+	clist_policy_init(&L);
+	clist_policy_set_growth(&L, &twice);
+	assert(fill(&L, 1000, caps, 32) == 7);
+	assert(caps[0] == 16 && caps[1] == 32 && caps[6] == 1024);
+	clist_policy_free(&L);
+
+	clist_policy_init(&L);
+	clist_policy_set_growth(&L, &half);
+	n = fill(&L, 1000, caps, 32);
+	assert(caps[0] == 16 && caps[1] == 32 && caps[2] == 48);
+	for (i = 1; i < n; i++) {
+		/* about 1.5x, rounded up to whole blocks */
+		assert(caps[i] % 16 == 0);
+		assert(caps[i] >= caps[i - 1] * 3 / 2 && caps[i] < caps[i - 1] * 3 / 2 + 16);
+	}
+	for (i = 0; i < 1000; i++) {
+		assert(*clist_policy_get(&L, i) == (int) i);
+	}
+	clist_policy_free(&L);
+}
+
+void TEST_growth_linear(void) {
+	static const clist_growth steps = CLIST_GROWTH_LINEAR_INIT(100);
+	clist_policy L;
+	size_t caps[32];
+	size_t i;
+
+	clist_policy_init(&L);
+	clist_policy_set_growth(&L, &steps);
+	assert(fill(&L, 1000, caps, 32) == 9);
+	for (i = 0; i < 9; i++) {
+		/* steps of 100, each rounded up to whole blocks of 16 */
+		assert(caps[i] == (i + 1) * 112);
+	}
+
+	/* one big jump still only allocates once */
+	assert(clist_policy_grow(&L, 5000) == 0);
+	assert(L.capacity >= 5000 && L.capacity < 5100 + 16);
+
+	clist_policy_free(&L);
+}
+
+void TEST_growth_capped(void) {
+	clist_growth capped = clist_growth_capped(256);
+	clist_policy L;
+	size_t caps[32];
+	size_t n;
+
+	clist_policy_init(&L);
+	clist_policy_set_growth(&L, &capped);
+	n = fill(&L, 2000, caps, 32);
+	assert(caps[0] == 16 && caps[1] == 32 && caps[4] == 256);
+	assert(caps[5] == 512 && caps[6] == 768);
+	assert(caps[n - 1] == 2048);
+
+	clist_policy_free(&L);
+}
+
+static size_t exactly(void *ctx, size_t capacity, size_t n_elems) {
+	(void) capacity;
+	++*(size_t *) ctx;
+	return n_elems;
+}
+
+static size_t refuse(void *ctx, size_t capacity, size_t n_elems) {
+	(void) ctx;
+	(void) capacity;
+	(void) n_elems;
+	errno = ENOSPC;
+	return 0;
+}
+
+void TEST_growth_callback(void) {
+	size_t calls = 0;
+	clist_growth cb = clist_growth_callback(&exactly, &calls);
+	clist_growth no = clist_growth_callback(&refuse, NULL);
+	clist_policy L;
+	size_t caps[64];
+
+	clist_policy_init(&L);
+	clist_policy_set_growth(&L, &cb);
+	assert(fill(&L, 100, caps, 64) == 7);
+	assert(calls == 7);
+	assert(caps[6] == 112);
+
+	/* back to the default */
+	clist_policy_set_growth(&L, NULL);
+	assert(clist_policy_grow(&L, 113) == 0);
+	assert(L.capacity == 448);
+
+	clist_policy_set_growth(&L, &no);
+	assert(clist_policy_grow(&L, 1000) == 1);
+	assert(errno == ENOSPC);
+	assert(L.capacity == 448);
+
+	clist_policy_free(&L);
+}
@@ -0,0 +1,186 @@
+#ifdef NDEBUG
+	/* the checks below have side effects */
+#	undef NDEBUG
+#	define _CLIST_NDEBUG
+#endif
+
+#include <algorithm>
+#include <cassert>
+#include <string>
+
+#include "../include/clist.hpp"
+
+#ifdef _CLIST_NDEBUG
+#	define NDEBUG 1
+#	undef _CLIST_NDEBUG
+#endif
+
+struct foo {
+	static int allocated;
+
+	bool armed;
+
+	foo() : armed(true) {
+		++allocated;
+	}
+
+	foo(const foo &other) : armed(other.armed) {
+		if (armed) ++foo::allocated;
+	}
+
+	foo(foo &&other) : armed(other.armed) {
+		other.armed = false;
+	}
+
+	~foo() {
+		if (armed) {
+			--allocated;
+		}
+	}
+};
+
+int foo::allocated = 0;
+
+static void test_trivial() {
+	clist::list<int, 16, 2, 4> L;
+	int vals[100];
+
+	assert(L.empty());
+	assert(L.capacity() == 4);
+
+	for (int i = 0; i < 100; i++) {
+		vals[i] = i;
+		assert(L.add(i) == (size_t) i);
+	}
+
+	assert(L.count() == 100);
+	assert(L.capacity() % 16 == 0);
+	for (int i = 0; i < 100; i++) {
+		assert(L[i] == i);
+	}
+
+	assert(L.add_n(vals, 100) == 100);
+	assert(L.count() == 200);
+	assert(L[150] == 50);
+
+	L.resize(3);
+	assert(L.shrink() == 0);
+	assert(L.capacity() == 4);
+	assert(L[0] == 0 && L[1] == 1 && L[2] == 2);
+
+	L.insert(0, 42);
+	L.remove(1);
+	L.swap_remove(0);
+	assert(L.count() == 2 && L[0] == 2 && L[1] == 1);
+	assert(L.pop() == 1);
+
+	assert(L.reserve(17) == 0);
+	assert(L.capacity() == 32);
+
+	clist::list<int, 16, 2, 0> bare;
+	assert(bare.capacity() == 0);
+	bare.add(7);
+	assert(bare.capacity() == 16 && bare.back() == 7);
+}
+
+static void test_objects() {
+	{
+		clist::list<foo, 2, 2, 1> a;
+		clist::list<foo, 2, 2, 1> b(3);
+
+		assert(foo::allocated == 3);
+
+		a.emplace();
+		a.add(foo());
+		a.emplace(a[0]);
+		assert(a.count() == 3);
+		assert(foo::allocated == 6);
+
+		a.remove(0);
+		a.swap_remove(0);
+		assert(foo::allocated == 4);
+
+		a.swap(b);
+		assert(a.count() == 3 && b.count() == 1);
+
+		b = std::move(a);
+		assert(a.empty() && b.count() == 3);
+		assert(foo::allocated == 3);
+
+		b.resize(1);
+		b.shrink();
+		assert(b.capacity() == 1);
+		assert(foo::allocated == 1);
+
+		clist::list<foo, 2, 2, 1> c(std::move(b));
+		assert(b.empty() && c.count() == 1);
+		assert(foo::allocated == 1);
+	}
+
+	assert(foo::allocated == 0);
+}
+
+static void test_strings() {
+	static const char *const long_str = "long enough to not fit in any small string buffer";
+	clist::list<std::string, 4, 2, 2> a;
+
+	a.emplace("d");
+	a.emplace(long_str);
+	a.emplace(3, 'b');
+	a.insert(0, a[1]);
+	a.add(std::string("a"));
+
+	assert(a.count() == 5);
+	assert(a[0] == long_str && a[1] == "d" && a[2] == long_str && a[3] == "bbb");
+
+	std::sort(a.begin(), a.end());
+	assert(std::is_sorted(a.cbegin(), a.cend()));
+	assert(a[0] == "a" && a.back() == long_str);
+
+	clist::list<std::string, 4, 2, 2> b(std::move(a));
+	assert(a.empty());
+	assert(b.count() == 5 && b[1] == "bbb");
+
+	size_t total = 0;
+	for (const std::string &s : b) {
+		total += s.size();
+	}
+	assert(total == 1 + 3 + 1 + 2 * std::string(long_str).size());
+}
+
+struct alignas(64) wide {
+	int v;
+};
+
+static void test_over_aligned() {
+	clist::list<wide, 4, 2, 2> L;
+
+	assert((size_t) L.data() % 64 == 0);
+
+	/* every new heap block has to keep the alignment, not just the first */
+	for (int i = 0; i < 5000; i++) {
+		size_t before = L.capacity();
+		assert(L.add(wide{i}) == (size_t) i);
+		if (L.capacity() != before) {
+			assert((size_t) L.data() % 64 == 0);
+		}
+	}
+
+	for (int i = 0; i < 5000; i++) {
+		assert(L[i].v == i);
+	}
+
+	assert(L.reserve(20000) == 0);
+	assert((size_t) L.data() % 64 == 0);
+	assert(L.shrink() == 0);
+	assert((size_t) L.data() % 64 == 0);
+	assert(L.back().v == 4999);
+}
+
+int main() {
+	test_trivial();
+	test_objects();
+	test_strings();
+	test_over_aligned();
+	return 0;
+}
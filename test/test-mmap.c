@@ -0,0 +1,76 @@
+#define _GNU_SOURCE /* mremap(2) */
+
+#ifdef NDEBUG
+	/* TODO better assert instead of std assert */
+#	undef NDEBUG
+#	define _CLIST_NDEBUG
+#endif
+
+#include <assert.h>
+
+#define CLIST_USE_MMAP
+#define CLIST_MMAP_HUGEPAGES
+#define CLIST_NAME mmap
+#define CLIST_TYPE size_t
+#include "clist_type.h"
+
+#ifdef _CLIST_NDEBUG
+#	define NDEBUG 1
+#	undef _CLIST_NDEBUG
+#endif
+
+void TEST_mmap_add_many(void) {
+	size_t i;
+	clist_mmap L;
+
+	clist_mmap_init(&L);
+
+	for (i = 0; i < 1000000; i++) {
+		assert(clist_mmap_add(&L, i) == i);
+	}
+
+	assert(clist_mmap_count(&L) == 1000000);
+	for (i = 0; i < 1000000; i++) {
+		assert(*clist_mmap_get(&L, i) == i);
+	}
+
+	clist_mmap_free(&L);
+}
+
+void TEST_mmap_resize_shrink_trim(void) {
+	size_t i;
+	clist_mmap L;
+
+	clist_mmap_init(&L);
+
+	assert(clist_mmap_resize(&L, 300000) == 0);
+	for (i = 0; i < 300000; i++) {
+		assert(*clist_mmap_get(&L, i) == 0);
+		*clist_mmap_get(&L, i) = i;
+	}
+
+	assert(clist_mmap_resize(&L, 1000) == 0);
+	clist_mmap_trim(&L);
+
+	/* the discarded tail must come back zeroed */
+	assert(clist_mmap_resize(&L, 300000) == 0);
+	for (i = 0; i < 1000; i++) {
+		assert(*clist_mmap_get(&L, i) == i);
+	}
+	for (i = 1000; i < 300000; i++) {
+		assert(*clist_mmap_get(&L, i) == 0);
+	}
+
+	assert(clist_mmap_resize(&L, 5000) == 0);
+	assert(clist_mmap_shrink(&L) == 0);
+	assert(clist_mmap_capacity(&L) < 5000 + 512);
+	for (i = 0; i < 1000; i++) {
+		assert(*clist_mmap_get(&L, i) == i);
+	}
+
+	assert(clist_mmap_resize(&L, 10) == 0);
+	assert(clist_mmap_shrink(&L) == 0);
+	assert(*clist_mmap_get(&L, 9) == 9);
+
+	clist_mmap_free(&L);
+}
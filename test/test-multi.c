@@ -18,6 +18,19 @@ typedef struct sample {
 #define CLIST_TYPE struct sample
 #include "clist_type.h"
 
+#define CLIST_NAME tiny
+#define CLIST_TYPE int
+#define CLIST_INLINE_CAPACITY 4
+#define CLIST_BLOCK_SIZE 16
+#include "clist_type.h"
+
+/* never called without a stack block, but clist_bare_swap() needs it */
+#define CLIST_MEMSWAP(p1, p2, n) ((void) (p1), (void) (p2), (void) (n), 1)
+#define CLIST_NAME bare
+#define CLIST_TYPE int
+#define CLIST_INLINE_CAPACITY 0
+#include "clist_type.h"
+
 #ifdef _CLIST_NDEBUG
 #	define NDEBUG 1
 #	undef _CLIST_NDEBUG
@@ -40,3 +53,78 @@ void TEST_multi_init(void) {
 		clist_sample_free(&L);
 	}
 }
+
+void TEST_multi_inline_capacity(void) {
+	int i;
+	clist_tiny L;
+
+	assert(sizeof(clist_tiny) < sizeof(clist_int));
+
+	clist_tiny_init(&L);
+	assert(clist_tiny_capacity(&L) == 4);
+
+	for (i = 0; i < 4; i++) {
+		assert(clist_tiny_add(&L, i) == (size_t) i);
+	}
+	assert(clist_tiny_capacity(&L) == 4);
+
+	/* onto the heap in whole blocks */
+	assert(clist_tiny_add(&L, 4) == 4);
+	assert(clist_tiny_capacity(&L) == 16);
+
+	for (i = 5; i < 1000; i++) {
+		assert(clist_tiny_add(&L, i) == (size_t) i);
+	}
+	for (i = 0; i < 1000; i++) {
+		assert(*clist_tiny_get(&L, i) == i);
+	}
+
+	/* and back */
+	assert(clist_tiny_resize(&L, 3) == 0);
+	assert(clist_tiny_shrink(&L) == 0);
+	assert(clist_tiny_capacity(&L) == 4);
+	assert(*clist_tiny_get(&L, 2) == 2);
+
+	clist_tiny_free(&L);
+}
+
+void TEST_multi_no_inline_capacity(void) {
+	int i;
+	clist_bare L;
+	clist_bare E;
+
+	clist_bare_init(&L);
+	assert(clist_bare_capacity(&L) == 0);
+	assert(clist_bare_empty(&L));
+
+	/* never allocates */
+	clist_bare_free(&L);
+
+	clist_bare_init(&L);
+	for (i = 0; i < 5000; i++) {
+		assert(clist_bare_add(&L, i) == (size_t) i);
+	}
+	for (i = 0; i < 5000; i++) {
+		assert(*clist_bare_get(&L, i) == i);
+	}
+
+	assert(clist_bare_resize(&L, 0) == 0);
+	assert(clist_bare_shrink(&L) == 0);
+	assert(clist_bare_capacity(&L) == 0);
+
+	assert(clist_bare_resize(&L, 10) == 0);
+	assert(*clist_bare_get(&L, 9) == 0);
+
+	/* swapping with an empty list hands over the heap block */
+	clist_bare_init(&E);
+	assert(clist_bare_swap(&L, &E) == 0);
+	assert(clist_bare_empty(&L) && clist_bare_capacity(&L) == 0);
+	assert(clist_bare_count(&E) == 10 && *clist_bare_get(&E, 9) == 0);
+
+	assert(clist_bare_swap(&E, &L) == 0);
+	assert(clist_bare_empty(&E));
+	assert(clist_bare_count(&L) == 10 && *clist_bare_get(&L, 9) == 0);
+	clist_bare_free(&E);
+
+	clist_bare_free(&L);
+}
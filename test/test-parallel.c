@@ -0,0 +1,222 @@
+#ifdef NDEBUG
+	/* TODO better assert instead of std assert */
+#	undef NDEBUG
+#	define _CLIST_NDEBUG
+#endif
+
+#include <assert.h>
+#include <stddef.h>
+
+#define CLIST_PARALLEL
+#define CLIST_NAME par
+#define CLIST_TYPE size_t
+#define CLIST_BLOCK_SIZE 16
+#include "clist_type.h"
+
+#ifdef _CLIST_NDEBUG
+#	define NDEBUG 1
+#	undef _CLIST_NDEBUG
+#endif
+
+/* enough blocks that the chunks span several of them */
+#define N_ELEMS 100000
+
+static const size_t thread_counts[] = { 1, 2, 3, 8 };
+#define N_THREAD_COUNTS (sizeof(thread_counts) / sizeof(thread_counts[0]))
+
+static void fill(clist_par *L, size_t n_elems) {
+	size_t i;
+
+	clist_par_init(L);
+	for (i = 0; i < n_elems; i++) {
+		assert(clist_par_add(L, i) == i);
+	}
+}
+
+static void times_three(size_t *block, size_t begin, size_t end, void *ctx) {
+	assert(ctx == NULL);
+	assert(begin < end);
+	assert(begin % 16 == 0);
+
+	for (; begin < end; begin++) {
+		block[begin] *= 3;
+	}
+}
+
+/* the later ranges take much longer, so the threads have to steal */
+static void uneven(size_t *block, size_t begin, size_t end, void *ctx) {
+	volatile size_t spin = 0;
+	size_t i;
+
+	(void) ctx;
+
+	for (i = begin; i < end; i++) {
+		size_t j;
+		for (j = 0; j < i / 1024; j++) {
+			spin += j;
+		}
+		block[i] += 1;
+	}
+}
+
+static void sum_range(const size_t *block, size_t begin, size_t end, void *partial, void *ctx) {
+	size_t sum = *(size_t *) partial;
+
+	(void) ctx;
+
+	for (; begin < end; begin++) {
+		sum += block[begin];
+	}
+
+	*(size_t *) partial = sum;
+}
+
+static void sum_combine(void *result, const void *partial, void *ctx) {
+	(void) ctx;
+	*(size_t *) result += *(const size_t *) partial;
+}
+
+struct span {
+	size_t begin;
+	size_t end;
+};
+
+static void span_range(const size_t *block, size_t begin, size_t end, void *partial, void *ctx) {
+	struct span *span = (struct span *) partial;
+
+	(void) block;
+	(void) ctx;
+
+	/* every range starts from its own copy of the identity */
+	assert(span->begin == 0 && span->end == 0);
+	span->begin = begin;
+	span->end = end;
+}
+
+static void span_combine(void *result, const void *partial, void *ctx) {
+	struct span *span = (struct span *) result;
+	const struct span *next = (const struct span *) partial;
+
+	(void) ctx;
+
+	/* in order, with no gaps */
+	assert(span->end == next->begin);
+	span->end = next->end;
+}
+
+void TEST_parallel_for(void) {
+	size_t t;
+
+	for (t = 0; t < N_THREAD_COUNTS; t++) {
+		clist_par L;
+		size_t i;
+
+		assert(clist_parallel_threads(thread_counts[t]) == thread_counts[t]);
+
+		fill(&L, N_ELEMS);
+		clist_par_parallel_for(&L, &times_three, NULL);
+
+		for (i = 0; i < N_ELEMS; i++) {
+			assert(*clist_par_get(&L, i) == i * 3);
+		}
+
+		clist_par_free(&L);
+	}
+}
+
+void TEST_parallel_for_uneven(void) {
+	size_t t;
+
+	for (t = 0; t < N_THREAD_COUNTS; t++) {
+		clist_par L;
+		size_t i;
+
+		clist_parallel_threads(thread_counts[t]);
+
+		fill(&L, N_ELEMS);
+		clist_par_parallel_for(&L, &uneven, NULL);
+
+		/* every element exactly once */
+		for (i = 0; i < N_ELEMS; i++) {
+			assert(*clist_par_get(&L, i) == i + 1);
+		}
+
+		clist_par_free(&L);
+	}
+}
+
+void TEST_parallel_reduce(void) {
+	size_t t;
+
+	for (t = 0; t < N_THREAD_COUNTS; t++) {
+		clist_par L;
+		size_t sum = 0;
+		struct span span = { 0, 0 };
+
+		clist_parallel_threads(thread_counts[t]);
+
+		fill(&L, N_ELEMS);
+		assert(clist_par_parallel_reduce(&L, &sum, sizeof(sum), &sum_range, &sum_combine, NULL) == 0);
+		assert(sum == (size_t) N_ELEMS * (N_ELEMS - 1) / 2);
+
+		assert(clist_par_parallel_reduce(&L, &span, sizeof(span), &span_range, &span_combine, NULL) == 0);
+		assert(span.begin == 0);
+		assert(span.end == N_ELEMS);
+
+		clist_par_free(&L);
+	}
+}
+
+void TEST_parallel_small(void) {
+	clist_par L;
+	size_t sum = 7;
+
+	clist_parallel_threads(4);
+
+	/* nothing to do */
+	clist_par_init(&L);
+	clist_par_parallel_for(&L, &times_three, NULL);
+	assert(clist_par_parallel_reduce(&L, &sum, sizeof(sum), &sum_range, &sum_combine, NULL) == 0);
+	assert(sum == 7);
+	clist_par_free(&L);
+
+	/* less than a block */
+	fill(&L, 5);
+	clist_par_parallel_for(&L, &times_three, NULL);
+	assert(*clist_par_get(&L, 4) == 12);
+	sum = 0;
+	assert(clist_par_parallel_reduce(&L, &sum, sizeof(sum), &sum_range, &sum_combine, NULL) == 0);
+	assert(sum == 30);
+	clist_par_free(&L);
+}
+
+static void nested(size_t *block, size_t begin, size_t end, void *ctx) {
+	clist_par *inner = (clist_par *) ctx;
+	size_t sum = 0;
+
+	/* the pool is busy, so this runs on the calling thread */
+	assert(clist_par_parallel_reduce(inner, &sum, sizeof(sum), &sum_range, &sum_combine, NULL) == 0);
+
+	for (; begin < end; begin++) {
+		block[begin] = sum;
+	}
+}
+
+void TEST_parallel_nested(void) {
+	clist_par outer;
+	clist_par inner;
+	size_t i;
+
+	clist_parallel_threads(4);
+
+	fill(&outer, 1000);
+	fill(&inner, 100);
+	clist_par_parallel_for(&outer, &nested, &inner);
+
+	for (i = 0; i < 1000; i++) {
+		assert(*clist_par_get(&outer, i) == 4950);
+	}
+
+	clist_par_free(&outer);
+	clist_par_free(&inner);
+}
@@ -0,0 +1,251 @@
+#ifdef NDEBUG
+	/* TODO better assert instead of std assert */
+#	undef NDEBUG
+#	define _CLIST_NDEBUG
+#endif
+
+#include <assert.h>
+#include <errno.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdint.h>
+
+typedef struct point {
+	int32_t x;
+	int32_t y;
+	double weight;
+} point;
+
+#define CLIST_PERSIST
+#define CLIST_NAME pint
+#define CLIST_TYPE int32_t
+#define CLIST_BLOCK_SIZE 16
+#include "clist_type.h"
+
+#define CLIST_PERSIST
+#define CLIST_NAME pu8
+#define CLIST_TYPE unsigned char
+#define CLIST_BLOCK_SIZE 16
+#include "clist_type.h"
+
+#define CLIST_PERSIST
+#define CLIST_NAME ppoint
+#define CLIST_TYPE struct point
+#define CLIST_BLOCK_SIZE 16
+#include "clist_type.h"
+
+#ifdef _CLIST_NDEBUG
+#	define NDEBUG 1
+#	undef _CLIST_NDEBUG
+#endif
+
+static const char *test_path(void) {
+	static char path[64];
+	sprintf(path, "/tmp/clist-test-persist-%ld.bin", (long) getpid());
+	return path;
+}
+
+static void fill_ints(clist_pint *L, size_t n) {
+	size_t i;
+
+	clist_pint_init(L);
+	for (i = 0; i < n; i++) {
+		clist_pint_add(L, (int32_t) (i * 7) - 1000);
+	}
+}
+
+/* flips one byte somewhere in the file */
+static void corrupt(const char *path, long offset) {
+	FILE *f = fopen(path, "r+b");
+	int c;
+
+	assert(f != NULL);
+	assert(fseek(f, offset, SEEK_SET) == 0);
+	c = fgetc(f);
+	assert(fseek(f, offset, SEEK_SET) == 0);
+	fputc(c ^ 0xFF, f);
+	fclose(f);
+}
+
+void TEST_persist_map(void) {
+	clist_pint L;
+	clist_pint_mapped M;
+	size_t i;
+
+	fill_ints(&L, 100000);
+	assert(clist_pint_save(&L, test_path()) == 0);
+
+	assert(clist_pint_map(&M, test_path(), CLIST_MAP_VERIFY) == 0);
+	assert(clist_pint_count(&M.list) == 100000);
+	for (i = 0; i < 100000; i++) {
+		assert(*clist_pint_get(&M.list, i) == *clist_pint_get(&L, i));
+	}
+	clist_pint_unmap(&M);
+
+	/* copy-on-write - the file stays as it was */
+	assert(clist_pint_map(&M, test_path(), CLIST_MAP_PRIVATE | CLIST_MAP_POPULATE) == 0);
+	*clist_pint_get(&M.list, 5) = 12345;
+	assert(*clist_pint_get(&M.list, 5) == 12345);
+	clist_pint_unmap(&M);
+
+	assert(clist_pint_map(&M, test_path(), CLIST_MAP_VERIFY) == 0);
+	assert(*clist_pint_get(&M.list, 5) == *clist_pint_get(&L, 5));
+	clist_pint_unmap(&M);
+
+	clist_pint_free(&L);
+	remove(test_path());
+}
+
+void TEST_persist_load(void) {
+	clist_pint L;
+	clist_pint loaded;
+	size_t i;
+
+	fill_ints(&L, 5000);
+	assert(clist_pint_save(&L, test_path()) == 0);
+
+	/* onto the end of what's already there */
+	clist_pint_init(&loaded);
+	clist_pint_add(&loaded, 42);
+	assert(clist_pint_load(&loaded, test_path()) == 0);
+	assert(clist_pint_count(&loaded) == 5001);
+	assert(*clist_pint_get(&loaded, 0) == 42);
+	for (i = 0; i < 5000; i++) {
+		assert(*clist_pint_get(&loaded, i + 1) == *clist_pint_get(&L, i));
+	}
+
+	/* and it's an ordinary list that can grow */
+	assert(clist_pint_add(&loaded, 7) == 5001);
+
+	clist_pint_free(&loaded);
+	clist_pint_free(&L);
+	remove(test_path());
+}
+
+void TEST_persist_empty(void) {
+	clist_pint L;
+	clist_pint_mapped M;
+
+	clist_pint_init(&L);
+	assert(clist_pint_save(&L, test_path()) == 0);
+
+	assert(clist_pint_map(&M, test_path(), CLIST_MAP_VERIFY) == 0);
+	assert(clist_pint_count(&M.list) == 0);
+	clist_pint_unmap(&M);
+
+	assert(clist_pint_load(&L, test_path()) == 0);
+	assert(clist_pint_count(&L) == 0);
+
+	clist_pint_free(&L);
+	remove(test_path());
+}
+
+void TEST_persist_struct(void) {
+	clist_ppoint L;
+	clist_ppoint_mapped M;
+	size_t i;
+
+	clist_ppoint_init(&L);
+	for (i = 0; i < 1000; i++) {
+		point p;
+		p.x = (int32_t) i;
+		p.y = -(int32_t) i;
+		p.weight = (double) i / 4;
+		clist_ppoint_add(&L, p);
+	}
+
+	assert(clist_ppoint_save(&L, test_path()) == 0);
+	assert(clist_ppoint_map(&M, test_path(), CLIST_MAP_VERIFY) == 0);
+	assert(clist_ppoint_count(&M.list) == 1000);
+	for (i = 0; i < 1000; i++) {
+		point *p = clist_ppoint_get(&M.list, i);
+		assert(p->x == (int32_t) i && p->y == -(int32_t) i && p->weight == (double) i / 4);
+	}
+	clist_ppoint_unmap(&M);
+
+	clist_ppoint_free(&L);
+	remove(test_path());
+}
+
+void TEST_persist_errors(void) {
+	clist_pint L;
+	clist_pint_mapped M;
+	clist_pu8 bytes;
+	clist_pu8_mapped bytes_mapped;
+
+	assert(clist_pint_map(&M, "/nonexistent/clist.bin", 0) == 1);
+	assert(errno == ENOENT);
+
+	fill_ints(&L, 1000);
+	assert(clist_pint_save(&L, test_path()) == 0);
+
+	/* a different element type */
+	clist_pu8_init(&bytes);
+	assert(clist_pu8_map(&bytes_mapped, test_path(), 0) == 1);
+	assert(errno == EINVAL);
+	assert(clist_pu8_load(&bytes, test_path()) == 1);
+	assert(errno == EINVAL);
+	assert(clist_pu8_count(&bytes) == 0);
+	clist_pu8_free(&bytes);
+
+	/* a flipped bit in the data is only caught when verifying */
+	corrupt(test_path(), 64 + 100);
+	assert(clist_pint_map(&M, test_path(), 0) == 0);
+	clist_pint_unmap(&M);
+	assert(clist_pint_map(&M, test_path(), CLIST_MAP_VERIFY) == 1);
+	assert(errno == EIO);
+	clist_pint_clear(&L);
+	assert(clist_pint_load(&L, test_path()) == 1);
+	assert(errno == EIO);
+	assert(clist_pint_count(&L) == 0);
+
+	/* a broken header */
+	assert(clist_pint_save(&L, test_path()) == 0);
+	corrupt(test_path(), 0);
+	assert(clist_pint_map(&M, test_path(), 0) == 1);
+	assert(errno == EINVAL);
+
+	/* not a list at all */
+	{
+		FILE *f = fopen(test_path(), "wb");
+		assert(f != NULL);
+		fputs("short", f);
+		fclose(f);
+	}
+	assert(clist_pint_map(&M, test_path(), 0) == 1);
+	assert(errno == EINVAL);
+	assert(clist_pint_load(&L, test_path()) == 1);
+	assert(errno == EINVAL);
+
+	clist_pint_free(&L);
+	remove(test_path());
+}
+
+void TEST_persist_truncated(void) {
+	clist_pint L;
+	clist_pint_mapped M;
+	FILE *f;
+	char buf[64 + 40];
+
+	fill_ints(&L, 100);
+	assert(clist_pint_save(&L, test_path()) == 0);
+
+	/* the header and the first 10 elements of 100 */
+	f = fopen(test_path(), "rb");
+	assert(f != NULL);
+	assert(fread(buf, 1, sizeof(buf), f) == sizeof(buf));
+	fclose(f);
+	f = fopen(test_path(), "wb");
+	assert(f != NULL);
+	assert(fwrite(buf, 1, sizeof(buf), f) == sizeof(buf));
+	fclose(f);
+
+	assert(clist_pint_map(&M, test_path(), 0) == 1);
+	assert(errno == EINVAL);
+	clist_pint_clear(&L);
+	assert(clist_pint_load(&L, test_path()) == 1);
+	assert(errno == EINVAL);
+
+	clist_pint_free(&L);
+	remove(test_path());
+}
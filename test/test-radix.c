@@ -0,0 +1,208 @@
+#ifdef NDEBUG
+	/* TODO better assert instead of std assert */
+#	undef NDEBUG
+#	define _CLIST_NDEBUG
+#endif
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "clist.h"
+
+typedef struct record {
+	int32_t key;
+	size_t order;
+} record;
+
+#define CLIST_NAME ri32
+#define CLIST_TYPE int32_t
+#define CLIST_KIND i32
+#define CLIST_PARALLEL
+#define CLIST_BLOCK_SIZE 16
+#include "clist_type.h"
+
+#define CLIST_NAME ru64
+#define CLIST_TYPE uint64_t
+#define CLIST_KIND u64
+#define CLIST_BLOCK_SIZE 16
+#include "clist_type.h"
+
+#define CLIST_NAME rf64
+#define CLIST_TYPE double
+#define CLIST_KIND f64
+#define CLIST_BLOCK_SIZE 16
+#include "clist_type.h"
+
+#define CLIST_NAME rrec
+#define CLIST_TYPE struct record
+#define CLIST_RADIX_KEY(r) ((uint32_t) (r).key ^ 0x80000000u)
+#define CLIST_PARALLEL
+#define CLIST_BLOCK_SIZE 16
+#include "clist_type.h"
+
+#ifdef _CLIST_NDEBUG
+#	define NDEBUG 1
+#	undef _CLIST_NDEBUG
+#endif
+
+static uint64_t rng_state = 1;
+
+static uint64_t rng(void) {
+	rng_state ^= rng_state << 13;
+	rng_state ^= rng_state >> 7;
+	rng_state ^= rng_state << 17;
+	return rng_state;
+}
+
+void TEST_radix_i32(void) {
+	size_t n;
+
+	for (n = 0; n < 300; n += 7) {
+		clist_ri32 L;
+		int64_t sum = 0;
+		int64_t sorted_sum = 0;
+		size_t i;
+
+		clist_ri32_init(&L);
+		for (i = 0; i < n; i++) {
+			/* small values too, so that some passes are skipped */
+			int32_t val = (int32_t) (n % 2 ? rng() : rng() % 100) ;
+			sum += val;
+			clist_ri32_add(&L, val);
+		}
+
+		assert(clist_ri32_radix_sort(&L) == 0);
+
+		for (i = 0; i < n; i++) {
+			sorted_sum += *clist_ri32_get(&L, i);
+			if (i > 0) {
+				assert(*clist_ri32_get(&L, i - 1) <= *clist_ri32_get(&L, i));
+			}
+		}
+		assert(sum == sorted_sum);
+
+		clist_ri32_free(&L);
+	}
+}
+
+void TEST_radix_u64(void) {
+	clist_ru64 L;
+	size_t i;
+
+	clist_ru64_init(&L);
+	for (i = 0; i < 10000; i++) {
+		/* only some of the bytes vary */
+		clist_ru64_add(&L, rng() & (i % 2 ? 0xFF00FF00FF00FF00u : 0xFFFFFFFFFFFFFFFFu));
+	}
+
+	assert(clist_ru64_radix_sort(&L) == 0);
+
+	for (i = 1; i < 10000; i++) {
+		assert(*clist_ru64_get(&L, i - 1) <= *clist_ru64_get(&L, i));
+	}
+
+	clist_ru64_free(&L);
+}
+
+void TEST_radix_f64(void) {
+	clist_rf64 L;
+	size_t i;
+
+	clist_rf64_init(&L);
+	for (i = 0; i < 10000; i++) {
+		clist_rf64_add(&L, ((double) (rng() % 2000000) - 1000000.0) / 7.0);
+	}
+	clist_rf64_add(&L, 0.0);
+	clist_rf64_add(&L, -0.0);
+
+	assert(clist_rf64_radix_sort(&L) == 0);
+
+	for (i = 1; i < clist_rf64_count(&L); i++) {
+		assert(*clist_rf64_get(&L, i - 1) <= *clist_rf64_get(&L, i));
+	}
+
+	clist_rf64_free(&L);
+}
+
+void TEST_radix_ptr(void) {
+	clist L;
+	size_t i;
+
+	clist_init(&L);
+	for (i = 0; i < 10000; i++) {
+		clist_add(&L, (void *) (uintptr_t) rng());
+	}
+
+	assert(clist_radix_sort(&L) == 0);
+
+	for (i = 1; i < 10000; i++) {
+		assert((uintptr_t) *clist_get(&L, i - 1) <= (uintptr_t) *clist_get(&L, i));
+	}
+
+	clist_free(&L);
+}
+
+static void check_records(clist_rrec *L) {
+	size_t i;
+
+	for (i = 1; i < clist_rrec_count(L); i++) {
+		record *a = clist_rrec_get(L, i - 1);
+		record *b = clist_rrec_get(L, i);
+
+		/* stable - equal keys stay in the order they were added */
+		assert(a->key < b->key || (a->key == b->key && a->order < b->order));
+	}
+}
+
+void TEST_radix_key(void) {
+	size_t threads;
+
+	for (threads = 1; threads <= 4; threads++) {
+		clist_rrec L;
+		size_t i;
+
+		clist_parallel_threads(threads);
+
+		clist_rrec_init(&L);
+		for (i = 0; i < 200000; i++) {
+			record r;
+			r.key = (int32_t) (rng() % 1000) - 500;
+			r.order = i;
+			clist_rrec_add(&L, r);
+		}
+
+		assert(clist_rrec_parallel_radix_sort(&L) == 0);
+		check_records(&L);
+
+		/* and once more, on already sorted input */
+		assert(clist_rrec_radix_sort(&L) == 0);
+		check_records(&L);
+
+		clist_rrec_free(&L);
+	}
+}
+
+void TEST_radix_parallel(void) {
+	size_t threads;
+
+	for (threads = 1; threads <= 8; threads *= 2) {
+		clist_ri32 L;
+		size_t i;
+
+		clist_parallel_threads(threads);
+
+		clist_ri32_init(&L);
+		for (i = 0; i < 300000; i++) {
+			clist_ri32_add(&L, (int32_t) rng());
+		}
+
+		assert(clist_ri32_parallel_radix_sort(&L) == 0);
+
+		for (i = 1; i < 300000; i++) {
+			assert(*clist_ri32_get(&L, i - 1) <= *clist_ri32_get(&L, i));
+		}
+
+		clist_ri32_free(&L);
+	}
+}
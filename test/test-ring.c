@@ -0,0 +1,164 @@
+#ifdef NDEBUG
+	/* TODO better assert instead of std assert */
+#	undef NDEBUG
+#	define _CLIST_NDEBUG
+#endif
+
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stddef.h>
+
+#define CLIST_RING
+#define CLIST_NAME ring
+#define CLIST_TYPE size_t
+#define CLIST_INLINE_CAPACITY 8
+#define CLIST_BLOCK_SIZE 16
+#include "clist_type.h"
+
+#ifdef _CLIST_NDEBUG
+#	define NDEBUG 1
+#	undef _CLIST_NDEBUG
+#endif
+
+#define N_TRANSFER 1000000
+
+void TEST_ring_basic(void) {
+	clist_ring_ring R;
+	size_t out[8];
+	size_t i;
+
+	/* rounded up, and small enough to stay inline */
+	assert(clist_ring_ring_init(&R, 5) == 0);
+	assert(clist_ring_ring_capacity(&R) == 8);
+	assert(R.list.block == (size_t *) (void *) R.list.stack_block);
+
+	/* each side's indices get a cache line of their own */
+	assert((size_t) &R.head % 64 == 0 && (size_t) &R.tail % 64 == 0);
+	assert((size_t) &R.tail - (size_t) &R.head >= 64);
+	assert((size_t) &R.head >= (size_t) (&R.list + 1));
+
+	assert(!clist_ring_ring_pop(&R, &out[0]));
+
+	for (i = 0; i < 8; i++) {
+		assert(clist_ring_ring_push(&R, i));
+	}
+	assert(!clist_ring_ring_push(&R, 8));
+	assert(clist_ring_ring_count(&R) == 8);
+
+	/* go around a few times, one at a time */
+	for (i = 0; i < 100; i++) {
+		assert(clist_ring_ring_pop(&R, &out[0]));
+		assert(out[0] == i);
+		assert(clist_ring_ring_push(&R, i + 8));
+	}
+
+	for (i = 0; i < 8; i++) {
+		assert(clist_ring_ring_pop(&R, &out[0]));
+		assert(out[0] == 100 + i);
+	}
+	assert(clist_ring_ring_count(&R) == 0);
+
+	clist_ring_ring_free(&R);
+}
+
+void TEST_ring_batch(void) {
+	clist_ring_ring R;
+	size_t in[100];
+	size_t out[100];
+	size_t next_in = 0;
+	size_t next_out = 0;
+	size_t i;
+
+	/* too big for the inline block */
+	assert(clist_ring_ring_init(&R, 33) == 0);
+	assert(clist_ring_ring_capacity(&R) == 64);
+	assert(R.list.block != (size_t *) (void *) R.list.stack_block);
+
+	/* only as much as fits */
+	for (i = 0; i < 100; i++) {
+		in[i] = next_in++;
+	}
+	assert(clist_ring_ring_push_n(&R, in, 100) == 64);
+	next_in = 64;
+	assert(clist_ring_ring_push_n(&R, in, 1) == 0);
+
+	/* batches of different sizes, wrapping around the end of the block */
+	for (i = 1; i < 200; i++) {
+		size_t n_out = clist_ring_ring_pop_n(&R, out, i % 50);
+		size_t n_in;
+		size_t j;
+
+		for (j = 0; j < n_out; j++) {
+			assert(out[j] == next_out++);
+		}
+
+		for (j = 0; j < i % 37; j++) {
+			in[j] = next_in + j;
+		}
+		n_in = clist_ring_ring_push_n(&R, in, i % 37);
+		next_in += n_in;
+
+		assert(clist_ring_ring_count(&R) == next_in - next_out);
+	}
+
+	clist_ring_ring_free(&R);
+}
+
+static void *producer(void *arg) {
+	clist_ring_ring *R = (clist_ring_ring *) arg;
+	size_t batch[13];
+	size_t next = 0;
+
+	while (next < N_TRANSFER) {
+		size_t n = N_TRANSFER - next < 13 ? N_TRANSFER - next : 13;
+		size_t i;
+
+		for (i = 0; i < n; i++) {
+			batch[i] = next + i;
+		}
+
+		/* some go in one at a time */
+		if (next % 2) {
+			n = clist_ring_ring_push(R, next) ? 1 : 0;
+		} else {
+			n = clist_ring_ring_push_n(R, batch, n);
+		}
+
+		if (n == 0) {
+			sched_yield();
+		}
+		next += n;
+	}
+
+	return NULL;
+}
+
+void TEST_ring_threads(void) {
+	clist_ring_ring R;
+	pthread_t thread;
+	size_t out[7];
+	size_t next = 0;
+
+	assert(clist_ring_ring_init(&R, 64) == 0);
+	assert(pthread_create(&thread, NULL, &producer, &R) == 0);
+
+	/* everything arrives, once and in order */
+	while (next < N_TRANSFER) {
+		size_t n = clist_ring_ring_pop_n(&R, out, 7);
+		size_t i;
+
+		if (n == 0) {
+			sched_yield();
+		}
+
+		for (i = 0; i < n; i++) {
+			assert(out[i] == next++);
+		}
+	}
+
+	assert(pthread_join(thread, NULL) == 0);
+	assert(clist_ring_ring_count(&R) == 0);
+
+	clist_ring_ring_free(&R);
+}
@@ -0,0 +1,153 @@
+#define _POSIX_C_SOURCE 200112L /* posix_memalign(3) */
+
+#ifdef NDEBUG
+	/* TODO better assert instead of std assert */
+#	undef NDEBUG
+#	define _CLIST_NDEBUG
+#endif
+
+#include <assert.h>
+#include <stddef.h>
+
+typedef struct entry {
+	size_t id;
+	int payload[3];
+} entry;
+
+#define CLIST_SEGMENTED
+#define CLIST_BLOCK_SIZE 64
+#define CLIST_NAME entry
+#define CLIST_TYPE struct entry
+#include "clist_type.h"
+
+#define CLIST_SEGMENTED
+#define CLIST_ARENA
+#define CLIST_STATS
+#define CLIST_ALIGNMENT 64
+#define CLIST_BLOCK_SIZE 16
+#define CLIST_NAME seg_owned
+#define CLIST_TYPE int
+#include "clist_type.h"
+
+#ifdef _CLIST_NDEBUG
+#	define NDEBUG 1
+#	undef _CLIST_NDEBUG
+#endif
+
+void TEST_segmented_init(void) {
+	clist_entry_seg L;
+
+	clist_entry_seg_init(&L);
+	assert(clist_entry_seg_count(&L) == 0);
+	assert(clist_entry_seg_empty(&L));
+	clist_entry_seg_free(&L);
+}
+
+void TEST_segmented_stable_addresses(void) {
+	size_t i;
+	entry e;
+	entry *first;
+	entry *hundredth;
+	clist_entry_seg L;
+
+	clist_entry_seg_init(&L);
+
+	e.payload[0] = e.payload[1] = e.payload[2] = 0;
+
+	for (i = 0; i < 100; i++) {
+		e.id = i;
+		assert(clist_entry_seg_add(&L, e) == i);
+	}
+
+	first = clist_entry_seg_get(&L, 0);
+	hundredth = clist_entry_seg_get(&L, 99);
+
+	/* plenty of block and table growth */
+	for (i = 100; i < 100000; i++) {
+		e.id = i;
+		assert(clist_entry_seg_add(&L, e) == i);
+	}
+
+	assert(clist_entry_seg_count(&L) == 100000);
+	assert(clist_entry_seg_get(&L, 0) == first);
+	assert(clist_entry_seg_get(&L, 99) == hundredth);
+	assert(first->id == 0);
+	assert(hundredth->id == 99);
+
+	for (i = 0; i < 100000; i++) {
+		assert(clist_entry_seg_get(&L, i)->id == i);
+	}
+
+	clist_entry_seg_free(&L);
+}
+
+void TEST_segmented_pop_clear(void) {
+	size_t i;
+	entry e;
+	entry *kept;
+	clist_entry_seg L;
+
+	clist_entry_seg_init(&L);
+
+	e.payload[0] = e.payload[1] = e.payload[2] = 0;
+
+	for (i = 0; i < 1000; i++) {
+		e.id = i;
+		assert(clist_entry_seg_add(&L, e) == i);
+	}
+
+	for (i = 1000; i > 500; i--) {
+		assert(clist_entry_seg_pop(&L).id == i - 1);
+	}
+	assert(clist_entry_seg_count(&L) == 500);
+
+	kept = clist_entry_seg_get(&L, 499);
+
+	e.id = 42;
+	assert(clist_entry_seg_add(&L, e) == 500);
+	assert(clist_entry_seg_get(&L, 499) == kept);
+	assert(clist_entry_seg_get(&L, 500)->id == 42);
+
+	clist_entry_seg_clear(&L);
+	assert(clist_entry_seg_empty(&L));
+
+	/* the blocks are reused */
+	e.id = 7;
+	assert(clist_entry_seg_add(&L, e) == 0);
+	assert(clist_entry_seg_get(&L, 0)->id == 7);
+
+	clist_entry_seg_free(&L);
+}
+
+void TEST_segmented_owned_memory(void) {
+	clist_arena A;
+	clist_seg_owned_seg L;
+	clist_stats st;
+	size_t i;
+
+	/* blocks come from the list's arena, aligned, and are counted */
+	clist_arena_init(&A, 4096);
+	clist_seg_owned_seg_init_arena(&L, &A);
+
+	for (i = 0; i < 100; i++) {
+		assert(clist_seg_owned_seg_add(&L, (int) i) == i);
+		assert((char *) L.table[L.blocks - 1] == A.last);
+		assert((size_t) L.table[L.blocks - 1] % 64 == 0);
+	}
+
+	clist_seg_owned_seg_stats(&L, &st);
+	assert(st.adds == 100);
+	assert(st.expansions == 7);
+	assert(st.peak_capacity == 7 * 16);
+	assert(st.bytes_allocated >= 7 * 16 * sizeof(int));
+
+	for (i = 0; i < 100; i++) {
+		assert(*clist_seg_owned_seg_get(&L, i) == (int) i);
+	}
+
+	clist_seg_owned_seg_free(&L);
+	clist_seg_owned_stats_type(&st);
+	assert(st.lists == 1 && st.adds == 100);
+
+	clist_arena_free(&A);
+}
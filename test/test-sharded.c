@@ -0,0 +1,148 @@
+#define _POSIX_C_SOURCE 200112L /* posix_memalign(3) */
+
+#ifdef NDEBUG
+	/* TODO better assert instead of std assert */
+#	undef NDEBUG
+#	define _CLIST_NDEBUG
+#endif
+
+#include <assert.h>
+#include <pthread.h>
+#include <stddef.h>
+
+#define CLIST_SHARDED
+#define CLIST_PARALLEL
+#define CLIST_NAME shd
+#define CLIST_TYPE size_t
+#define CLIST_BLOCK_SIZE 16
+#include "clist_type.h"
+
+#define CLIST_SHARDED
+#define CLIST_NAME shdser
+#define CLIST_TYPE size_t
+#define CLIST_INLINE_CAPACITY 4
+#define CLIST_BLOCK_SIZE 16
+#include "clist_type.h"
+
+#ifdef _CLIST_NDEBUG
+#	define NDEBUG 1
+#	undef _CLIST_NDEBUG
+#endif
+
+#define N_SHARDS 4
+
+struct filler {
+	clist_shd *shard;
+	size_t first;
+	size_t n_elems;
+};
+
+static void *fill(void *arg) {
+	struct filler *f = (struct filler *) arg;
+	size_t i;
+
+	for (i = 0; i < f->n_elems; i++) {
+		assert(clist_shd_add(f->shard, f->first + i) != CLIST_ERR);
+	}
+
+	return NULL;
+}
+
+/* shard `t` gets t * 10000 + 1 elements, counting up from where shard t - 1 left off */
+static size_t fill_shards(clist_shd_sharded *B) {
+	pthread_t threads[N_SHARDS];
+	struct filler args[N_SHARDS];
+	size_t total = 0;
+	size_t t;
+
+	for (t = 0; t < N_SHARDS; t++) {
+		args[t].shard = clist_shd_sharded_shard(B, t);
+		args[t].first = total;
+		args[t].n_elems = t * 10000 + 1;
+		total += args[t].n_elems;
+		assert(pthread_create(&threads[t], NULL, &fill, &args[t]) == 0);
+	}
+
+	for (t = 0; t < N_SHARDS; t++) {
+		assert(pthread_join(threads[t], NULL) == 0);
+	}
+
+	return total;
+}
+
+void TEST_sharded_merge(void) {
+	size_t n_threads;
+
+	for (n_threads = 1; n_threads <= 4; n_threads++) {
+		clist_shd_sharded B;
+		clist_shd L;
+		size_t total;
+		size_t round;
+		size_t i;
+
+		clist_parallel_threads(n_threads);
+
+		assert(clist_shd_sharded_init(&B, N_SHARDS) == 0);
+		clist_shd_init(&L);
+
+		for (round = 0; round < 2; round++) {
+			size_t before = clist_shd_count(&L);
+
+			total = fill_shards(&B);
+			assert(clist_shd_sharded_count(&B) == total);
+
+			/* readable in place */
+			assert(*clist_shd_get(clist_shd_sharded_shard(&B, 1), 0) == 1);
+
+			assert(clist_shd_sharded_merge(&B, &L) == 0);
+			assert(clist_shd_sharded_count(&B) == 0);
+			assert(clist_shd_count(&L) == before + total);
+
+			/* appended after whatever was already there, in shard order */
+			for (i = 0; i < total; i++) {
+				assert(*clist_shd_get(&L, before + i) == i);
+			}
+		}
+
+		/* the shards keep their capacity for the next round */
+		assert(clist_shd_capacity(clist_shd_sharded_shard(&B, 3)) >= 30001);
+
+		clist_shd_sharded_free(&B);
+		clist_shd_free(&L);
+	}
+}
+
+void TEST_sharded_serial(void) {
+	clist_shdser_sharded B;
+	clist_shdser L;
+	size_t i;
+
+	assert(clist_shdser_sharded_init(&B, 3) == 0);
+	clist_shdser_init(&L);
+
+	/* every shard starts a cache line of its own */
+	for (i = 0; i < 3; i++) {
+		assert((size_t) clist_shdser_sharded_shard(&B, i) % CLIST_SHARD_CACHE_LINE == 0);
+	}
+	assert(sizeof(clist_shdser_shard) % CLIST_SHARD_CACHE_LINE == 0);
+
+	/* nothing to merge */
+	assert(clist_shdser_sharded_merge(&B, &L) == 0);
+	assert(clist_shdser_count(&L) == 0);
+
+	/* shard 0 stays on its stack block, shard 1 is empty */
+	clist_shdser_add(clist_shdser_sharded_shard(&B, 0), 0);
+	clist_shdser_add(clist_shdser_sharded_shard(&B, 0), 1);
+	for (i = 2; i < 100; i++) {
+		clist_shdser_add(clist_shdser_sharded_shard(&B, 2), i);
+	}
+
+	assert(clist_shdser_sharded_merge(&B, &L) == 0);
+	assert(clist_shdser_count(&L) == 100);
+	for (i = 0; i < 100; i++) {
+		assert(*clist_shdser_get(&L, i) == i);
+	}
+
+	clist_shdser_sharded_free(&B);
+	clist_shdser_free(&L);
+}
@@ -0,0 +1,149 @@
+#define _POSIX_C_SOURCE 200112L /* ftruncate(2) */
+
+#ifdef NDEBUG
+	/* TODO better assert instead of std assert */
+#	undef NDEBUG
+#	define _CLIST_NDEBUG
+#endif
+
+#include <assert.h>
+#include <errno.h>
+#include <sched.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#define CLIST_SHM
+#define CLIST_NAME shm
+#define CLIST_TYPE uint64_t
+#define CLIST_BLOCK_SIZE 16
+#define CLIST_BLOCK_GROWTH_RATE 2
+#include "clist_type.h"
+
+#define CLIST_SHM
+#define CLIST_NAME shm8
+#define CLIST_TYPE unsigned char
+#define CLIST_BLOCK_SIZE 16
+#include "clist_type.h"
+
+#ifdef _CLIST_NDEBUG
+#	define NDEBUG 1
+#	undef _CLIST_NDEBUG
+#endif
+
+#define N_WRITES 200000
+
+static const char *shm_name(void) {
+	static char name[64];
+	sprintf(name, "/clist-test-shm-%ld", (long) getpid());
+	return name;
+}
+
+void TEST_shm_single(void) {
+	clist_shm_shm W;
+	clist_shm_shm R;
+	clist_shm V;
+	size_t i;
+
+	assert(clist_shm_shm_create(&W, shm_name(), 0) == 0);
+	assert(clist_shm_shm_count(&W) == 0);
+
+	assert(clist_shm_shm_attach(&R, shm_name()) == 0);
+	assert(clist_shm_shm_count(&R) == 0);
+
+	for (i = 0; i < 100000; i++) {
+		assert(clist_shm_shm_add(&W, i * 3) == i);
+	}
+
+	/* the reader's mapping is still the small one until it counts */
+	assert(R.map_size < W.map_size);
+	assert(clist_shm_shm_count(&R) == 100000);
+	assert(R.map_size == W.map_size);
+
+	for (i = 0; i < 100000; i++) {
+		assert(*clist_shm_shm_get(&R, i) == i * 3);
+	}
+
+	clist_shm_shm_view(&R, &V);
+	assert(clist_shm_count(&V) == 100000);
+	assert(*clist_shm_get(&V, 99999) == 99999 * 3);
+
+	clist_shm_shm_detach(&R);
+	clist_shm_shm_detach(&W);
+	assert(shm_unlink(shm_name()) == 0);
+}
+
+void TEST_shm_processes(void) {
+	clist_shm_shm W;
+	const char *name = shm_name(); /* the child's pid is a different one */
+	pid_t child;
+	int status;
+	size_t i;
+
+	assert(clist_shm_shm_create(&W, name, 16) == 0);
+
+	child = fork();
+	assert(child >= 0);
+
+	if (child == 0) {
+		clist_shm_shm R;
+		size_t count = 0;
+
+		assert(clist_shm_shm_attach(&R, name) == 0);
+
+		while (count < N_WRITES) {
+			size_t n = clist_shm_shm_count(&R);
+
+			/* everything it counts is there, without any copying */
+			for (i = count; i < n; i++) {
+				assert(*clist_shm_shm_get(&R, i) == i);
+			}
+
+			if (n == count) {
+				sched_yield();
+			}
+
+			count = n;
+		}
+
+		clist_shm_shm_detach(&R);
+		_exit(0);
+	}
+
+	for (i = 0; i < N_WRITES; i++) {
+		assert(clist_shm_shm_add(&W, i) == i);
+		if (i % 4096 == 0) {
+			sched_yield();
+		}
+	}
+
+	assert(waitpid(child, &status, 0) == child);
+	assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+	clist_shm_shm_detach(&W);
+	assert(shm_unlink(name) == 0);
+}
+
+void TEST_shm_errors(void) {
+	clist_shm_shm W;
+	clist_shm_shm R;
+	clist_shm8_shm R8;
+
+	assert(clist_shm_shm_attach(&R, "/clist-test-shm-nonexistent") == 1);
+	assert(errno == ENOENT);
+
+	assert(clist_shm_shm_create(&W, shm_name(), 0) == 0);
+
+	/* only one writer */
+	assert(clist_shm_shm_create(&R, shm_name(), 0) == 1);
+	assert(errno == EEXIST);
+
+	/* a different element type */
+	assert(clist_shm8_shm_attach(&R8, shm_name()) == 1);
+	assert(errno == EINVAL);
+
+	clist_shm_shm_detach(&W);
+	assert(shm_unlink(shm_name()) == 0);
+}
@@ -0,0 +1,226 @@
+#ifdef NDEBUG
+	/* TODO better assert instead of std assert */
+#	undef NDEBUG
+#	define _CLIST_NDEBUG
+#endif
+
+#include <assert.h>
+#include <stdint.h>
+
+#include "clist.h"
+
+#define CLIST_NAME i32
+#define CLIST_TYPE int32_t
+#define CLIST_KIND i32
+#define CLIST_BLOCK_SIZE 16
+#include "clist_type.h"
+
+#define CLIST_NAME u64
+#define CLIST_TYPE uint64_t
+#define CLIST_KIND u64
+#define CLIST_BLOCK_SIZE 16
+#include "clist_type.h"
+
+#define CLIST_NAME i64
+#define CLIST_TYPE int64_t
+#define CLIST_KIND i64
+#define CLIST_BLOCK_SIZE 16
+#include "clist_type.h"
+
+#define CLIST_NAME f32
+#define CLIST_TYPE float
+#define CLIST_KIND f32
+#define CLIST_BLOCK_SIZE 16
+#include "clist_type.h"
+
+#define CLIST_NAME f64
+#define CLIST_TYPE double
+#define CLIST_KIND f64
+#define CLIST_BLOCK_SIZE 16
+#include "clist_type.h"
+
+#ifdef _CLIST_NDEBUG
+#	define NDEBUG 1
+#	undef _CLIST_NDEBUG
+#endif
+
+/* every list length up to this is checked so that all of the
+   vector/remainder splits are hit */
+#define MAX_LEN 70
+
+#if CLIST_SIMD_SSE2
+#	define MAX_LEVEL clist__simd_level(-1)
+#	define SET_LEVEL(level) ((void) clist__simd_level((level)))
+#else
+#	define MAX_LEVEL 0
+#	define SET_LEVEL(level) ((void) (level))
+#endif
+
+static int32_t i32_at(size_t i) {
+	return (int32_t) ((i * 2654435761u) % 2001) - 1000;
+}
+
+static void check_i32(void) {
+	clist_i32 L;
+	size_t n;
+	size_t i;
+
+	clist_i32_init(&L);
+
+	for (n = 1; n <= MAX_LEN; n++) {
+		int64_t sum = 0;
+		int32_t min = INT32_MAX;
+		int32_t max = INT32_MIN;
+		int32_t got_min;
+		int32_t got_max;
+		size_t count = 0;
+
+		clist_i32_clear(&L);
+		for (i = 0; i < n; i++) {
+			clist_i32_add(&L, i32_at(i));
+			sum += i32_at(i);
+			if (i32_at(i) < min) min = i32_at(i);
+			if (i32_at(i) > max) max = i32_at(i);
+			count += i32_at(i) == i32_at(n / 2);
+		}
+
+		assert(clist_i32_sum(&L) == sum);
+		clist_i32_minmax(&L, &got_min, &got_max);
+		assert(got_min == min && got_max == max);
+		assert(clist_i32_find(&L, i32_at(n - 1)) <= n - 1);
+		assert(*clist_i32_get(&L, clist_i32_find(&L, i32_at(n - 1))) == i32_at(n - 1));
+		assert(clist_i32_find(&L, 5000) == CLIST_ERR);
+		assert(clist_i32_count_eq(&L, i32_at(n / 2)) == count);
+		assert(clist_i32_count_eq(&L, 5000) == 0);
+	}
+
+	clist_i32_free(&L);
+}
+
+static void check_64(void) {
+	clist_u64 U;
+	clist_i64 I;
+	size_t n;
+	size_t i;
+
+	clist_u64_init(&U);
+	clist_i64_init(&I);
+
+	for (n = 1; n <= MAX_LEN; n++) {
+		uint64_t min;
+		uint64_t max;
+		int64_t imin;
+		int64_t imax;
+
+		clist_u64_clear(&U);
+		clist_i64_clear(&I);
+		for (i = 0; i < n; i++) {
+			/* the top bit trips up signed comparisons */
+			clist_u64_add(&U, ((uint64_t) 1 << 63) + i);
+			clist_i64_add(&I, (int64_t) i - 3);
+		}
+		clist_u64_add(&U, 7);
+
+		assert(clist_u64_sum(&U) == ((uint64_t) 1 << 63) * n + n * (n - 1) / 2 + 7);
+		clist_u64_minmax(&U, &min, &max);
+		assert(min == 7 && max == ((uint64_t) 1 << 63) + n - 1);
+		assert(clist_u64_find(&U, 7) == n);
+		assert(clist_u64_find(&U, ((uint64_t) 1 << 63) + n / 2) == n / 2);
+		assert(clist_u64_find(&U, (uint64_t) 1 << 62) == CLIST_ERR);
+		assert(clist_u64_count_eq(&U, ((uint64_t) 1 << 63)) == 1);
+
+		assert(clist_i64_sum(&I) == (int64_t) (n * (n - 1) / 2) - 3 * (int64_t) n);
+		clist_i64_minmax(&I, &imin, &imax);
+		assert(imin == -3 && imax == (int64_t) n - 4);
+		assert(clist_i64_find(&I, -2) == (n > 1 ? 1 : CLIST_ERR));
+		assert(clist_i64_count_eq(&I, -3) == 1);
+	}
+
+	clist_u64_free(&U);
+	clist_i64_free(&I);
+}
+
+static void check_float(void) {
+	clist_f32 F;
+	clist_f64 D;
+	size_t n;
+	size_t i;
+
+	clist_f32_init(&F);
+	clist_f64_init(&D);
+
+	for (n = 1; n <= MAX_LEN; n++) {
+		float fmin;
+		float fmax;
+		double dmin;
+		double dmax;
+
+		clist_f32_clear(&F);
+		clist_f64_clear(&D);
+		for (i = 0; i < n; i++) {
+			/* small integers add up exactly in any order */
+			clist_f32_add(&F, (float) i - 10.0f);
+			clist_f64_add(&D, 10.0 - (double) i);
+		}
+
+		assert(clist_f32_sum(&F) == (float) (n * (n - 1) / 2) - 10.0f * (float) n);
+		assert(clist_f64_sum(&D) == 10.0 * (double) n - (double) (n * (n - 1) / 2));
+
+		clist_f32_minmax(&F, &fmin, &fmax);
+		assert(fmin == -10.0f && fmax == (float) n - 11.0f);
+		clist_f64_minmax(&D, &dmin, &dmax);
+		assert(dmin == 11.0 - (double) n && dmax == 10.0);
+
+		assert(clist_f32_find(&F, (float) n - 11.0f) == n - 1);
+		assert(clist_f32_find(&F, 0.5f) == CLIST_ERR);
+		assert(clist_f64_count_eq(&D, 10.0) == 1);
+		assert(clist_f64_find(&D, 10.0 - (double) (n / 2)) == n / 2);
+	}
+
+	clist_f32_free(&F);
+	clist_f64_free(&D);
+}
+
+static void check_ptr(void) {
+	clist L;
+	size_t n;
+	size_t i;
+	void *min;
+	void *max;
+
+	clist_init(&L);
+	assert(clist_sum(&L) == 0);
+	assert(clist_find(&L, NULL) == CLIST_ERR);
+
+	for (n = 1; n <= MAX_LEN; n++) {
+		clist_clear(&L);
+		for (i = 0; i < n; i++) {
+			clist_add(&L, (void *) (n - i));
+		}
+
+		assert(clist_sum(&L) == n * (n + 1) / 2);
+		clist_minmax(&L, &min, &max);
+		assert(min == (void *) 1 && max == (void *) n);
+		assert(clist_find(&L, (void *) 1) == n - 1);
+		assert(clist_find(&L, NULL) == CLIST_ERR);
+		assert(clist_count_eq(&L, (void *) n) == 1);
+	}
+
+	clist_free(&L);
+}
+
+void TEST_simd_kernels(void) {
+	int level;
+	int max_level = MAX_LEVEL;
+
+	/* every kernel the CPU can run, down to the plain loops */
+	for (level = max_level; level >= 0; level--) {
+		SET_LEVEL(level);
+		check_i32();
+		check_64();
+		check_float();
+		check_ptr();
+	}
+
+	SET_LEVEL(max_level);
+}
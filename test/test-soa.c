@@ -0,0 +1,218 @@
+#define _POSIX_C_SOURCE 200112L /* posix_memalign(3) */
+
+#ifdef NDEBUG
+	/* TODO better assert instead of std assert */
+#	undef NDEBUG
+#	define _CLIST_NDEBUG
+#endif
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+typedef struct sample {
+	int foo;
+	int bar;
+} sample;
+
+typedef struct reading {
+	double value;
+	char sensor;
+	int64_t at;
+	int scratch; /* not a column */
+} reading;
+
+#define CLIST_NAME soa
+#define CLIST_TYPE struct sample
+#define CLIST_FIELDS(X) X(int, foo) X(int, bar)
+#define CLIST_BLOCK_SIZE 16
+#include "clist_type.h"
+
+#define CLIST_NAME reading
+#define CLIST_TYPE struct reading
+#define CLIST_FIELDS(X) X(double, value) X(char, sensor) X(int64_t, at)
+#define CLIST_BLOCK_SIZE 16
+#define CLIST_BLOCK_GROWTH_RATE 2
+#include "clist_type.h"
+
+#define CLIST_ALIGNMENT 64
+#define CLIST_NAME aligned
+#define CLIST_TYPE struct sample
+#define CLIST_FIELDS(X) X(int, foo) X(int, bar)
+#define CLIST_BLOCK_SIZE 4
+#define CLIST_BLOCK_GROWTH_RATE 2
+#include "clist_type.h"
+
+#ifdef _CLIST_NDEBUG
+#	define NDEBUG 1
+#	undef _CLIST_NDEBUG
+#endif
+
+void TEST_soa_add(void) {
+	clist_soa_soa S;
+	int *foos;
+	int *bars;
+	size_t i;
+
+	clist_soa_soa_init(&S);
+	assert(clist_soa_soa_count(&S) == 0);
+
+	for (i = 0; i < 10000; i++) {
+		sample s;
+		s.foo = (int) i;
+		s.bar = -(int) i * 2;
+		assert(clist_soa_soa_add(&S, s) == i);
+	}
+
+	assert(clist_soa_soa_count(&S) == 10000);
+	assert(S.capacity >= 10000);
+
+	/* each field is an array of its own */
+	foos = clist_soa_soa_col_foo(&S);
+	bars = clist_soa_soa_col_bar(&S);
+	assert(foos == S.cols.foo && bars == S.cols.bar);
+	for (i = 0; i < 10000; i++) {
+		assert(foos[i] == (int) i);
+		assert(bars[i] == -(int) i * 2);
+	}
+
+	for (i = 0; i < 10000; i += 7) {
+		sample s = clist_soa_soa_get(&S, i);
+		assert(s.foo == (int) i && s.bar == -(int) i * 2);
+		assert(clist_soa_soa_get_foo(&S, i) == (int) i);
+	}
+
+	clist_soa_soa_free(&S);
+	assert(S.cols.foo == NULL && S.count == 0);
+}
+
+void TEST_soa_set(void) {
+	clist_soa_soa S;
+	sample s;
+
+	clist_soa_soa_init(&S);
+
+	s.foo = 1;
+	s.bar = 2;
+	clist_soa_soa_add(&S, s);
+	clist_soa_soa_add(&S, s);
+
+	clist_soa_soa_set_bar(&S, 1, 20);
+	assert(clist_soa_soa_get_foo(&S, 1) == 1);
+	assert(clist_soa_soa_get_bar(&S, 1) == 20);
+	assert(clist_soa_soa_get_bar(&S, 0) == 2);
+
+	s.foo = 10;
+	s.bar = 30;
+	clist_soa_soa_set(&S, 0, s);
+	s = clist_soa_soa_get(&S, 0);
+	assert(s.foo == 10 && s.bar == 30);
+
+	clist_soa_soa_clear(&S);
+	assert(clist_soa_soa_count(&S) == 0);
+	assert(S.capacity > 0);
+
+	clist_soa_soa_free(&S);
+}
+
+void TEST_soa_add_list(void) {
+	clist_soa L;
+	clist_soa_soa S;
+	size_t i;
+
+	clist_soa_init(&L);
+	for (i = 0; i < 1000; i++) {
+		sample s;
+		s.foo = (int) i;
+		s.bar = (int) i + 1;
+		clist_soa_add(&L, s);
+	}
+
+	clist_soa_soa_init(&S);
+	assert(clist_soa_soa_reserve(&S, 100) == 0);
+	assert(S.capacity >= 100);
+
+	assert(clist_soa_soa_add_list(&S, &L) == 0);
+	assert(clist_soa_soa_add_list(&S, &L) == 0);
+	assert(clist_soa_soa_count(&S) == 2000);
+
+	for (i = 0; i < 2000; i++) {
+		assert(S.cols.foo[i] == (int) (i % 1000));
+		assert(S.cols.bar[i] == (int) (i % 1000) + 1);
+	}
+
+	clist_soa_soa_free(&S);
+	clist_soa_free(&L);
+}
+
+void TEST_soa_mixed_fields(void) {
+	clist_reading_soa S;
+	size_t i;
+
+	clist_reading_soa_init(&S);
+
+	for (i = 0; i < 5000; i++) {
+		reading r;
+		r.value = (double) i / 2;
+		r.sensor = (char) ('a' + i % 26);
+		r.at = (int64_t) i * 1000000;
+		r.scratch = 99;
+		assert(clist_reading_soa_add(&S, r) == i);
+	}
+
+	for (i = 0; i < 5000; i++) {
+		reading r = clist_reading_soa_get(&S, i);
+		assert(r.value == (double) i / 2);
+		assert(r.sensor == (char) ('a' + i % 26));
+		assert(r.at == (int64_t) i * 1000000);
+
+		/* only the columns are kept */
+		assert(r.scratch == 0);
+	}
+
+	assert(clist_reading_soa_col_sensor(&S)[27] == 'b');
+
+	clist_reading_soa_free(&S);
+}
+
+void TEST_soa_aligned(void) {
+	clist_aligned_soa S;
+	void *noise[64];
+	size_t n_noise = 0;
+	size_t i;
+
+	clist_aligned_soa_init(&S);
+
+	for (i = 0; i < 200000; i++) {
+		size_t before = S.capacity;
+		sample s;
+		s.foo = (int) i;
+		s.bar = (int) i + 1;
+		assert(clist_aligned_soa_add(&S, s) == i);
+
+		/* every column stays aligned as it grows, not just the first
+		   block of each */
+		if (S.capacity != before) {
+			assert((size_t) S.cols.foo % 64 == 0);
+			assert((size_t) S.cols.bar % 64 == 0);
+
+			/* small allocations right behind the columns, so they
+			   can't always grow where they are */
+			if (n_noise < 64) {
+				noise[n_noise++] = malloc(24);
+			}
+		}
+	}
+
+	for (i = 0; i < 200000; i++) {
+		assert(clist_aligned_soa_get_foo(&S, i) == (int) i);
+		assert(clist_aligned_soa_get_bar(&S, i) == (int) i + 1);
+	}
+
+	clist_aligned_soa_free(&S);
+
+	while (n_noise > 0) {
+		free(noise[--n_noise]);
+	}
+}
@@ -0,0 +1,186 @@
+#ifdef NDEBUG
+	/* TODO better assert instead of std assert */
+#	undef NDEBUG
+#	define _CLIST_NDEBUG
+#endif
+
+#include <assert.h>
+#include <stddef.h>
+
+typedef struct sample {
+	int foo;
+	int bar;
+} sample;
+
+#define CLIST_NAME sint
+#define CLIST_TYPE int
+#define CLIST_BLOCK_SIZE 16
+#define CLIST_CMP(a, b) (((a) > (b)) - ((a) < (b)))
+#include "clist_type.h"
+
+#define CLIST_NAME ssample
+#define CLIST_TYPE struct sample
+#define CLIST_BLOCK_SIZE 16
+#define CLIST_CMP(a, b) ((a).foo != (b).foo ? ((a).foo > (b).foo) - ((a).foo < (b).foo) : ((a).bar > (b).bar) - ((a).bar < (b).bar))
+#include "clist_type.h"
+
+#define CLIST_NAME sptr
+#define CLIST_BLOCK_SIZE 16
+#define CLIST_CMP(a, b) (((a) > (b)) - ((a) < (b)))
+#include "clist_type.h"
+
+#ifdef _CLIST_NDEBUG
+#	define NDEBUG 1
+#	undef _CLIST_NDEBUG
+#endif
+
+static unsigned long rng_state = 1;
+
+static int rng(int range) {
+	rng_state = rng_state * 1103515245ul + 12345ul;
+	return (int) ((rng_state >> 16) % (unsigned long) range);
+}
+
+enum { RANDOM, FEW_VALUES, SORTED, REVERSED, ORGAN_PIPE, N_SHAPES };
+
+static int shape_at(int shape, size_t i, size_t n) {
+	switch (shape) {
+	case RANDOM: return rng(1000000) - 500000;
+	case FEW_VALUES: return rng(3);
+	case SORTED: return (int) i;
+	case REVERSED: return (int) (n - i);
+	default: return (int) (i < n / 2 ? i : n - i);
+	}
+}
+
+static void check_ints(size_t n, int shape) {
+	clist_sint L;
+	long sum = 0;
+	long sorted_sum = 0;
+	size_t i;
+
+	clist_sint_init(&L);
+	for (i = 0; i < n; i++) {
+		int val = shape_at(shape, i, n);
+		sum += val;
+		assert(clist_sint_add(&L, val) == i);
+	}
+
+	clist_sint_sort(&L);
+
+	for (i = 0; i < n; i++) {
+		sorted_sum += *clist_sint_get(&L, i);
+		if (i > 0) {
+			assert(*clist_sint_get(&L, i - 1) <= *clist_sint_get(&L, i));
+		}
+	}
+	assert(sum == sorted_sum);
+
+	clist_sint_free(&L);
+}
+
+void TEST_sort_int(void) {
+	size_t n;
+	int shape;
+
+	for (shape = 0; shape < N_SHAPES; shape++) {
+		for (n = 0; n < 100; n++) {
+			check_ints(n, shape);
+		}
+
+		check_ints(100000, shape);
+	}
+}
+
+void TEST_sort_heap_fallback(void) {
+	clist_sint L;
+	size_t i;
+
+	clist_sint_init(&L);
+	for (i = 0; i < 1000; i++) {
+		clist_sint_add(&L, rng(100));
+	}
+
+	/* no depth left at all - straight to heapsort */
+	clist_sint_sort_intro(clist_sint_data(&L), clist_sint_data(&L) + clist_sint_count(&L), 0, 1);
+
+	for (i = 1; i < 1000; i++) {
+		assert(*clist_sint_get(&L, i - 1) <= *clist_sint_get(&L, i));
+	}
+
+	clist_sint_free(&L);
+}
+
+void TEST_sort_struct(void) {
+	clist_ssample L;
+	size_t i;
+
+	clist_ssample_init(&L);
+	for (i = 0; i < 10000; i++) {
+		sample s;
+		s.foo = rng(10);
+		s.bar = rng(10000);
+		clist_ssample_add(&L, s);
+	}
+
+	clist_ssample_sort(&L);
+
+	for (i = 1; i < 10000; i++) {
+		sample *a = clist_ssample_get(&L, i - 1);
+		sample *b = clist_ssample_get(&L, i);
+		assert(a->foo < b->foo || (a->foo == b->foo && a->bar <= b->bar));
+	}
+
+	clist_ssample_free(&L);
+}
+
+void TEST_sort_ptr(void) {
+	clist_sptr L;
+	size_t i;
+
+	clist_sptr_init(&L);
+	for (i = 0; i < 10000; i++) {
+		clist_sptr_add(&L, (void *) (size_t) rng(100000));
+	}
+
+	clist_sptr_sort(&L);
+
+	for (i = 1; i < 10000; i++) {
+		assert(*clist_sptr_get(&L, i - 1) <= *clist_sptr_get(&L, i));
+	}
+
+	clist_sptr_free(&L);
+}
+
+void TEST_sort_bsearch(void) {
+	clist_sint L;
+	size_t i;
+	int val;
+
+	clist_sint_init(&L);
+	assert(clist_sint_lower_bound(&L, 5) == 0);
+	assert(clist_sint_bsearch(&L, 5) == CLIST_ERR);
+
+	/* 0, 0, 2, 2, 4, 4, ... 198, 198 */
+	for (i = 0; i < 200; i++) {
+		clist_sint_add(&L, (int) (i / 2 * 2));
+	}
+
+	for (val = -1; val <= 200; val++) {
+		size_t expected = 0;
+
+		while (expected < 200 && *clist_sint_get(&L, expected) < val) {
+			++expected;
+		}
+
+		assert(clist_sint_lower_bound(&L, val) == expected);
+
+		if (val >= 0 && val < 200 && val % 2 == 0) {
+			assert(*clist_sint_get(&L, clist_sint_bsearch(&L, val)) == val);
+		} else {
+			assert(clist_sint_bsearch(&L, val) == CLIST_ERR);
+		}
+	}
+
+	clist_sint_free(&L);
+}
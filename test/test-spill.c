@@ -0,0 +1,155 @@
+#define _GNU_SOURCE /* O_DIRECT */
+
+#ifdef NDEBUG
+	/* TODO better assert instead of std assert */
+#	undef NDEBUG
+#	define _CLIST_NDEBUG
+#endif
+
+#include <assert.h>
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* small blocks so that a few thousand elements already spill */
+#define CLIST_SPILL_BLOCK_BYTES 4096
+
+typedef struct triple {
+	int32_t a;
+	int32_t b;
+	int32_t c;
+} triple;
+
+#define CLIST_SPILL
+#define CLIST_NAME spill
+#define CLIST_TYPE size_t
+#define CLIST_BLOCK_SIZE 16
+#include "clist_type.h"
+
+#define CLIST_SPILL
+#define CLIST_NAME triple
+#define CLIST_TYPE struct triple
+#define CLIST_BLOCK_SIZE 16
+#include "clist_type.h"
+
+#ifdef _CLIST_NDEBUG
+#	define NDEBUG 1
+#	undef _CLIST_NDEBUG
+#endif
+
+#define N_ELEMS 100000
+
+static void check_list(clist_spill_spill *S) {
+	size_t *elems;
+	size_t i;
+	size_t n;
+
+	assert(clist_spill_spill_count(S) == N_ELEMS);
+
+	/* front to back */
+	for (i = 0; (n = clist_spill_spill_scan(S, i, &elems)) != 0; i += n) {
+		size_t j;
+
+		assert(n != CLIST_ERR);
+		assert(n <= S->block_elems);
+		for (j = 0; j < n; j++) {
+			assert(elems[j] == i + j);
+		}
+	}
+	assert(i == N_ELEMS);
+
+	/* jumping all over the place, on disk and in memory */
+	for (i = 0; i < N_ELEMS; i++) {
+		size_t idx = (i * 7919) % N_ELEMS;
+		assert(*clist_spill_spill_get(S, idx) == idx);
+	}
+}
+
+void TEST_spill_add(void) {
+	clist_spill_spill S;
+	size_t i;
+
+	assert(clist_spill_spill_init(&S, NULL, 0) == 0);
+	assert(clist_spill_spill_count(&S) == 0);
+	assert(S.block_elems == 4096 / sizeof(size_t));
+
+	for (i = 0; i < N_ELEMS; i++) {
+		assert(clist_spill_spill_add(&S, i) == i);
+	}
+
+	/* only the last few blocks are still around */
+	assert(S.hot_first > 0);
+	assert(N_ELEMS - S.hot_first * S.block_elems <= CLIST_SPILL_HOT_BLOCKS * S.block_elems);
+
+	check_list(&S);
+
+	/* and more can be added after reading */
+	assert(clist_spill_spill_add(&S, 1234) == N_ELEMS);
+	assert(*clist_spill_spill_get(&S, N_ELEMS) == 1234);
+	assert(*clist_spill_spill_get(&S, 0) == 0);
+
+	clist_spill_spill_free(&S);
+}
+
+void TEST_spill_empty(void) {
+	clist_spill_spill S;
+	size_t *elems;
+
+	assert(clist_spill_spill_init(&S, NULL, 0) == 0);
+	assert(clist_spill_spill_scan(&S, 0, &elems) == 0);
+
+	/* the hot blocks only */
+	assert(clist_spill_spill_add(&S, 5) == 0);
+	assert(clist_spill_spill_scan(&S, 0, &elems) == 1);
+	assert(elems[0] == 5);
+	assert(clist_spill_spill_scan(&S, 1, &elems) == 0);
+
+	clist_spill_spill_free(&S);
+}
+
+void TEST_spill_direct(void) {
+	clist_spill_spill S;
+	size_t i;
+
+	/* falls back to buffered I/O where O_DIRECT isn't supported */
+	assert(clist_spill_spill_init(&S, NULL, CLIST_SPILL_DIRECT) == 0);
+
+	for (i = 0; i < N_ELEMS; i++) {
+		assert(clist_spill_spill_add(&S, i) == i);
+	}
+
+	check_list(&S);
+	clist_spill_spill_free(&S);
+}
+
+void TEST_spill_odd_size(void) {
+	clist_triple_spill S;
+	size_t i;
+
+	assert(clist_triple_spill_init(&S, NULL, 0) == 0);
+
+	/* blocks are still whole pages on disk */
+	assert(S.block_bytes % 4096 == 0);
+
+	for (i = 0; i < N_ELEMS; i++) {
+		triple t;
+		t.a = (int32_t) i;
+		t.b = -(int32_t) i;
+		t.c = (int32_t) i * 3;
+		assert(clist_triple_spill_add(&S, t) == i);
+	}
+
+	for (i = 0; i < N_ELEMS; i += 17) {
+		triple *t = clist_triple_spill_get(&S, i);
+		assert(t->a == (int32_t) i && t->b == -(int32_t) i && t->c == (int32_t) i * 3);
+	}
+
+	clist_triple_spill_free(&S);
+}
+
+void TEST_spill_bad_dir(void) {
+	clist_spill_spill S;
+
+	assert(clist_spill_spill_init(&S, "/nonexistent/clist", 0) == 1);
+	assert(errno == ENOENT);
+}
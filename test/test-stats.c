@@ -0,0 +1,182 @@
+#ifdef NDEBUG
+	/* TODO better assert instead of std assert */
+#	undef NDEBUG
+#	define _CLIST_NDEBUG
+#endif
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#define CLIST_STATS
+#define CLIST_NAME stat
+#define CLIST_TYPE int
+#define CLIST_BLOCK_SIZE 4
+#define CLIST_BLOCK_GROWTH_RATE 2
+#include "clist_type.h"
+
+#define CLIST_STATS
+#define CLIST_NAME stat_heap
+#define CLIST_TYPE double
+#define CLIST_BLOCK_SIZE 16
+#define CLIST_INLINE_CAPACITY 0
+#include "clist_type.h"
+
+#ifdef _CLIST_NDEBUG
+#	define NDEBUG 1
+#	undef _CLIST_NDEBUG
+#endif
+
+void TEST_stats_list(void) {
+	clist_stat L;
+	clist_stats st;
+	size_t expansions = 0;
+	size_t i;
+	int vals[10] = {0};
+
+	clist_stat_init(&L);
+	clist_stat_stats(&L, &st);
+	assert(st.adds == 0 && st.expansions == 0 && st.bytes_allocated == 0);
+	assert(st.peak_capacity == 4 && st.capacity == 4);
+
+	for (i = 0; i < 1000; i++) {
+		size_t before = L.capacity;
+		clist_stat_add(&L, (int) i);
+		expansions += L.capacity != before;
+	}
+
+	assert(clist_stat_add_n(&L, vals, 10) == 1000);
+	assert(clist_stat_insert(&L, 0, -1) == 0);
+
+	clist_stat_stats(&L, &st);
+	assert(st.adds == 1011);
+	assert(st.expansions == expansions);
+	assert(st.promotions == 1);
+	assert(st.peak_capacity == L.capacity);
+	assert(st.count == 1011 && st.capacity == L.capacity);
+	assert(st.bytes_allocated >= L.capacity * sizeof(int));
+
+	/* at least the stack block was copied onto the heap */
+	assert(st.bytes_copied >= 4 * sizeof(int));
+
+	/* shrinking doesn't lower the peak */
+	clist_stat_resize(&L, 3);
+	assert(clist_stat_shrink(&L) == 0);
+	assert(L.capacity == 4);
+	clist_stat_stats(&L, &st);
+	assert(st.peak_capacity > 4);
+	assert(st.expansions == expansions);
+
+	clist_stat_free(&L);
+}
+
+void TEST_stats_heap_only(void) {
+	clist_stat_heap L;
+	clist_stats st;
+
+	clist_stat_heap_init(&L);
+	assert(clist_stat_heap_resize(&L, 100) == 0);
+	assert(clist_stat_heap_reserve(&L, 1000) == 0);
+
+	clist_stat_heap_stats(&L, &st);
+	assert(st.expansions == 2);
+	assert(st.promotions == 0); /* there's no stack block */
+	assert(st.peak_capacity == 1008);
+	assert(st.bytes_allocated == (112 + 1008) * sizeof(double));
+
+	clist_stat_heap_free(&L);
+}
+
+void TEST_stats_move(void) {
+	clist_stat A;
+	clist_stat B;
+	clist_stats st;
+	size_t i;
+
+	clist_stat_init(&A);
+	for (i = 0; i < 100; i++) {
+		clist_stat_add(&A, (int) i);
+	}
+
+	clist_stat_move(&B, &A);
+
+	clist_stat_stats(&B, &st);
+	assert(st.adds == 100);
+
+	clist_stat_stats(&A, &st);
+	assert(st.adds == 0 && st.expansions == 0);
+
+	clist_stat_free(&A);
+	clist_stat_free(&B);
+}
+
+static int find_type(void *ctx, const clist_stats_type *type, const clist_stats *stats) {
+	(void) stats;
+	return strcmp(type->name, (const char *) ctx) == 0;
+}
+
+void TEST_stats_type(void) {
+	clist_stat A;
+	clist_stat B;
+	clist_stats before;
+	clist_stats st;
+	char line[512];
+	FILE *f;
+	size_t i;
+
+	clist_stat_stats_type(&before);
+
+	clist_stat_init(&A);
+	clist_stat_init(&B);
+	for (i = 0; i < 50; i++) {
+		clist_stat_add(&A, (int) i);
+	}
+	for (i = 0; i < 3; i++) {
+		clist_stat_add(&B, (int) i);
+	}
+
+	/* nothing reaches the type until a list is freed or flushed */
+	clist_stat_stats_type(&st);
+	assert(st.adds == before.adds);
+
+	clist_stat_stats_flush(&A);
+	clist_stat_stats(&A, &st);
+	assert(st.adds == 0);
+	assert(st.peak_capacity == A.capacity);
+
+	clist_stat_stats_type(&st);
+	assert(st.adds == before.adds + 50);
+	assert(st.lists == before.lists);
+
+	clist_stat_add(&A, 50);
+	clist_stat_free(&A);
+	clist_stat_free(&B);
+
+	clist_stat_stats_type(&st);
+	assert(st.adds == before.adds + 54);
+	assert(st.lists == before.lists + 2);
+	assert(st.count == before.count + 51 + 3);
+	assert(st.capacity >= before.capacity + 51 + 4);
+	assert(st.peak_capacity >= 51);
+
+	/* the type is registered under its name */
+	assert(clist_stats_each(&find_type, (void *) "clist_stat") == 1);
+	assert(clist_stats_each(&find_type, (void *) "clist_nonexistent") == 0);
+
+	f = tmpfile();
+	assert(f != NULL);
+	assert(clist_stats_dump(f) == 0);
+	rewind(f);
+
+	st.adds = 0;
+	while (fgets(line, sizeof(line), f) != NULL) {
+		if (strncmp(line, "clist_stat elem_size=", 21) == 0) {
+			assert(strstr(line, " lists=") != NULL);
+			st.adds = 1;
+		}
+	}
+	assert(st.adds == 1);
+
+	fclose(f);
+}
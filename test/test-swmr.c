@@ -0,0 +1,177 @@
+#define _POSIX_C_SOURCE 200112L /* posix_memalign(3) */
+
+#ifdef NDEBUG
+	/* TODO better assert instead of std assert */
+#	undef NDEBUG
+#	define _CLIST_NDEBUG
+#endif
+
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stddef.h>
+
+#define CLIST_SWMR
+#define CLIST_NAME swmr
+#define CLIST_TYPE size_t
+#define CLIST_BLOCK_SIZE 16
+#define CLIST_BLOCK_GROWTH_RATE 2
+#include "clist_type.h"
+
+#define CLIST_SWMR
+#define CLIST_ALIGNMENT 256
+#define CLIST_NAME swmr_wide
+#define CLIST_TYPE double
+#define CLIST_BLOCK_SIZE 8
+#define CLIST_BLOCK_GROWTH_RATE 2
+#include "clist_type.h"
+
+#ifdef _CLIST_NDEBUG
+#	define NDEBUG 1
+#	undef _CLIST_NDEBUG
+#endif
+
+#define N_READERS 3
+#define N_WRITES 200000
+
+void TEST_swmr_single(void) {
+	clist_epoch E;
+	clist_swmr_swmr L;
+	clist_epoch_reader *r;
+	size_t *first;
+	size_t i;
+
+	clist_epoch_init(&E);
+	clist_swmr_swmr_init(&L, &E);
+	assert(clist_swmr_swmr_count(&L) == 0);
+
+	r = clist_epoch_register(&E);
+	assert(r != NULL);
+
+	clist_swmr_swmr_add(&L, 0);
+
+	/* a reader holding on to the first block */
+	clist_epoch_enter(r);
+	first = clist_swmr_swmr_get(&L, 0);
+
+	for (i = 1; i < 1000; i++) {
+		assert(clist_swmr_swmr_add(&L, i) == i);
+	}
+
+	/* every block since then is retired but can't be freed yet */
+	assert(L.retired != NULL);
+	clist_swmr_swmr_reclaim(&L);
+	assert(L.retired != NULL);
+	assert(*first == 0);
+
+	clist_epoch_leave(r);
+
+	clist_swmr_swmr_reclaim(&L);
+	assert(L.retired == NULL);
+
+	for (i = 0; i < 1000; i++) {
+		assert(*clist_swmr_swmr_get(&L, i) == i);
+	}
+
+	clist_epoch_unregister(r);
+	clist_swmr_swmr_free(&L);
+}
+
+void TEST_swmr_register(void) {
+	clist_epoch E;
+	clist_epoch_reader *readers[CLIST_EPOCH_MAX_READERS];
+	size_t i;
+
+	clist_epoch_init(&E);
+
+	for (i = 0; i < CLIST_EPOCH_MAX_READERS; i++) {
+		readers[i] = clist_epoch_register(&E);
+		assert(readers[i] != NULL);
+	}
+
+	assert(clist_epoch_register(&E) == NULL);
+
+	/* slots are handed out again once given back */
+	clist_epoch_unregister(readers[5]);
+	assert(clist_epoch_register(&E) == readers[5]);
+}
+
+static void *read_along(void *arg) {
+	clist_swmr_swmr *L = (clist_swmr_swmr *) arg;
+	clist_epoch_reader *r = clist_epoch_register(L->epoch);
+	size_t count = 0;
+
+	assert(r != NULL);
+
+	while (count < N_WRITES) {
+		size_t i;
+
+		clist_epoch_enter(r);
+
+		count = clist_swmr_swmr_count(L);
+
+		/* everything up to the count is there, wherever it lives now */
+		if (count > 0) {
+			assert(*clist_swmr_swmr_get(L, count - 1) == count - 1);
+			for (i = count > 64 ? count - 64 : 0; i < count; i++) {
+				assert(*clist_swmr_swmr_get(L, i) == i);
+			}
+		}
+
+		clist_epoch_leave(r);
+		sched_yield();
+	}
+
+	clist_epoch_unregister(r);
+	return NULL;
+}
+
+void TEST_swmr_threads(void) {
+	clist_epoch E;
+	clist_swmr_swmr L;
+	pthread_t readers[N_READERS];
+	size_t i;
+
+	clist_epoch_init(&E);
+	clist_swmr_swmr_init(&L, &E);
+
+	for (i = 0; i < N_READERS; i++) {
+		assert(pthread_create(&readers[i], NULL, &read_along, &L) == 0);
+	}
+
+	for (i = 0; i < N_WRITES; i++) {
+		assert(clist_swmr_swmr_add(&L, i) == i);
+		if (i % 1024 == 0) {
+			sched_yield();
+		}
+	}
+
+	for (i = 0; i < N_READERS; i++) {
+		assert(pthread_join(readers[i], NULL) == 0);
+	}
+
+	/* all the readers are gone */
+	clist_swmr_swmr_reclaim(&L);
+	assert(L.retired == NULL);
+
+	clist_swmr_swmr_free(&L);
+}
+
+void TEST_swmr_aligned(void) {
+	clist_epoch E;
+	clist_swmr_wide_swmr L;
+	size_t i;
+
+	clist_epoch_init(&E);
+	clist_swmr_wide_swmr_init(&L, &E);
+
+	/* past the header, the elements keep CLIST_ALIGNMENT */
+	for (i = 0; i < 5000; i++) {
+		assert(clist_swmr_wide_swmr_add(&L, (double) i) == i);
+		assert((size_t) clist_swmr_wide_swmr_get(&L, 0) % 256 == 0);
+	}
+
+	assert(*clist_swmr_wide_swmr_get(&L, 4999) == 4999.0);
+
+	clist_swmr_wide_swmr_free(&L);
+}